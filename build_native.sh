@@ -18,9 +18,9 @@ REQUIRED_PACKAGES=(
     "libgtk-3-dev"
     "libx11-dev"
     "libxtst-dev"
+    "libxfixes-dev"
     "libdbus-1-dev"
     "libglib2.0-dev"
-    "xclip"
     "xdotool"
 )
 
@@ -1,5 +1,9 @@
+import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 
 // Native library loading
@@ -48,6 +52,21 @@ final class MenuItem extends Struct {
   external int enabled;
 }
 
+final class ProcessingSegment extends Struct {
+  @Int32()
+  external int id;
+  external Pointer<Utf8> text;
+  external Pointer<Utf8> operation;
+}
+
+final class ProcessingSegmentResult extends Struct {
+  @Int32()
+  external int id;
+  @Int32()
+  external int status;
+  external Pointer<Utf8> result;
+}
+
 // Status codes
 class StatusCode {
   static const int success = 0;
@@ -56,14 +75,32 @@ class StatusCode {
   static const int errorNoDisplay = -3;
   static const int errorDbus = -4;
   static const int errorGtk = -5;
+  static const int cancelled = -6;
+  static const int timeout = -7;
+  static const int rejected = -8;
 }
 
-// Callback types
-typedef SelectionCallbackNative = Void Function(Pointer<SelectionData>);
-typedef MenuActionCallbackNative = Void Function(Pointer<Utf8>, Pointer<SelectionData>);
+// Processing priority classes, most urgent first
+class ProcessingPriority {
+  static const int interactive = 0;
+  static const int speculative = 1;
+  static const int background = 2;
+}
 
-typedef SelectionCallbackDart = void Function(Pointer<SelectionData>);
-typedef MenuActionCallbackDart = void Function(Pointer<Utf8>, Pointer<SelectionData>);
+// Hotkey actions
+class HotkeyAction {
+  static const int showMenu = 0;
+  static const int menuItem = 1;
+}
+
+// Native event kinds posted to the event port (see dart_port_bridge.h)
+class NativeEvent {
+  static const int selection = 1;
+  static const int menuAction = 2;
+  static const int processingDone = 3;
+  static const int processingProgress = 4;
+  static const int chunkProgress = 5;
+}
 
 // Native function signatures
 typedef InitSystemHooksNative = Int32 Function();
@@ -84,11 +121,71 @@ typedef FreeSelectionDataDart = void Function(Pointer<SelectionData>);
 typedef ReplaceSelectionNative = Int32 Function(Pointer<Utf8>);
 typedef ReplaceSelectionDart = int Function(Pointer<Utf8>);
 
-typedef SetSelectionCallbackNative = Int32 Function(Pointer<NativeFunction<SelectionCallbackNative>>);
-typedef SetSelectionCallbackDart = int Function(Pointer<NativeFunction<SelectionCallbackNative>>);
+typedef SendProcessingRequestAsyncNative = Int32 Function(
+    Pointer<Utf8>, Pointer<Utf8>, Int32, Pointer<Void>, Pointer<Void>);
+typedef SendProcessingRequestAsyncDart = int Function(
+    Pointer<Utf8>, Pointer<Utf8>, int, Pointer<Void>, Pointer<Void>);
+
+typedef SendProcessingRequestStreamingNative = Int32 Function(
+    Pointer<Utf8>, Pointer<Utf8>, Int32, Pointer<Void>, Pointer<Void>, Pointer<Void>);
+typedef SendProcessingRequestStreamingDart = int Function(
+    Pointer<Utf8>, Pointer<Utf8>, int, Pointer<Void>, Pointer<Void>, Pointer<Void>);
+
+typedef CancelProcessingRequestNative = Int32 Function(Int32);
+typedef CancelProcessingRequestDart = int Function(int);
+
+typedef CancelProcessingClassNative = Int32 Function(Int32);
+typedef CancelProcessingClassDart = int Function(int);
+
+typedef TakeProcessingResultNative = Int32 Function(Int32, Pointer<Int32>, Pointer<Pointer<Utf8>>);
+typedef TakeProcessingResultDart = int Function(int, Pointer<Int32>, Pointer<Pointer<Utf8>>);
+
+typedef SendProcessingBatchNative = Int32 Function(
+    Pointer<ProcessingSegment>, Int32, Pointer<Pointer<ProcessingSegmentResult>>);
+typedef SendProcessingBatchDart = int Function(
+    Pointer<ProcessingSegment>, int, Pointer<Pointer<ProcessingSegmentResult>>);
+
+typedef FreeProcessingResultsNative = Void Function(Pointer<ProcessingSegmentResult>, Int32);
+typedef FreeProcessingResultsDart = void Function(Pointer<ProcessingSegmentResult>, int);
+
+typedef InitDartApiDLNative = Int32 Function(Pointer<Void>);
+typedef InitDartApiDLDart = int Function(Pointer<Void>);
+
+typedef SetDartEventPortNative = Int32 Function(Int64);
+typedef SetDartEventPortDart = int Function(int);
+
+typedef RegisterHotkeyNative = Int32 Function(Pointer<Utf8>, Int32, Pointer<Utf8>);
+typedef RegisterHotkeyDart = int Function(Pointer<Utf8>, int, Pointer<Utf8>);
+
+typedef UnregisterHotkeyNative = Int32 Function(Int32);
+typedef UnregisterHotkeyDart = int Function(int);
+
+typedef SetSpeculativeProcessingNative = Int32 Function(Int32);
+typedef SetSpeculativeProcessingDart = int Function(int);
+
+typedef SetSegmentedProcessingNative = Int32 Function(Int32);
+typedef SetSegmentedProcessingDart = int Function(int);
+
+typedef SetTranslationMemoryNative = Int32 Function(Double, Double);
+typedef SetTranslationMemoryDart = int Function(double, double);
+
+typedef SetChunkedProcessingNative = Int32 Function(Int32, Int32);
+typedef SetChunkedProcessingDart = int Function(int, int);
+
+typedef SetBackendConcurrencyNative = Int32 Function(Int32, Int32);
+typedef SetBackendConcurrencyDart = int Function(int, int);
+
+typedef SetOperationRateLimitNative = Int32 Function(Pointer<Utf8>, Double, Int32);
+typedef SetOperationRateLimitDart = int Function(Pointer<Utf8>, double, int);
+
+typedef SetResultCacheBudgetNative = Int32 Function(Long);
+typedef SetResultCacheBudgetDart = int Function(int);
 
-typedef SetMenuActionCallbackNative = Int32 Function(Pointer<NativeFunction<MenuActionCallbackNative>>);
-typedef SetMenuActionCallbackDart = int Function(Pointer<NativeFunction<MenuActionCallbackNative>>);
+typedef SetProcessingModelConfigNative = Int32 Function(Pointer<Utf8>);
+typedef SetProcessingModelConfigDart = int Function(Pointer<Utf8>);
+
+typedef ClearResultCacheNative = Int32 Function();
+typedef ClearResultCacheDart = int Function();
 
 typedef IsSystemCompatibleNative = Int32 Function();
 typedef IsSystemCompatibleDart = int Function();
@@ -96,6 +193,9 @@ typedef IsSystemCompatibleDart = int Function();
 typedef GetDesktopEnvironmentNative = Pointer<Utf8> Function();
 typedef GetDesktopEnvironmentDart = Pointer<Utf8> Function();
 
+typedef GetActionChannelPathNative = Pointer<Utf8> Function();
+typedef GetActionChannelPathDart = Pointer<Utf8> Function();
+
 typedef GetLastErrorNative = Pointer<Utf8> Function();
 typedef GetLastErrorDart = Pointer<Utf8> Function();
 
@@ -127,12 +227,84 @@ final ReplaceSelectionDart _replaceSelection = _nativeLib
     .lookup<NativeFunction<ReplaceSelectionNative>>('replace_selection')
     .asFunction();
 
-final SetSelectionCallbackDart _setSelectionCallback = _nativeLib
-    .lookup<NativeFunction<SetSelectionCallbackNative>>('set_selection_callback')
+final SendProcessingRequestAsyncDart _sendProcessingRequestAsync = _nativeLib
+    .lookup<NativeFunction<SendProcessingRequestAsyncNative>>('send_processing_request_async')
+    .asFunction();
+
+final SendProcessingRequestStreamingDart _sendProcessingRequestStreaming = _nativeLib
+    .lookup<NativeFunction<SendProcessingRequestStreamingNative>>('send_processing_request_streaming')
+    .asFunction();
+
+final CancelProcessingRequestDart _cancelProcessingRequest = _nativeLib
+    .lookup<NativeFunction<CancelProcessingRequestNative>>('cancel_processing_request')
+    .asFunction();
+
+final CancelProcessingClassDart _cancelProcessingClass = _nativeLib
+    .lookup<NativeFunction<CancelProcessingClassNative>>('cancel_processing_class')
+    .asFunction();
+
+final TakeProcessingResultDart _takeProcessingResult = _nativeLib
+    .lookup<NativeFunction<TakeProcessingResultNative>>('take_processing_result')
+    .asFunction();
+
+final SendProcessingBatchDart _sendProcessingBatch = _nativeLib
+    .lookup<NativeFunction<SendProcessingBatchNative>>('send_processing_batch')
+    .asFunction();
+
+final FreeProcessingResultsDart _freeProcessingResults = _nativeLib
+    .lookup<NativeFunction<FreeProcessingResultsNative>>('free_processing_results')
+    .asFunction();
+
+final InitDartApiDLDart _initDartApiDL = _nativeLib
+    .lookup<NativeFunction<InitDartApiDLNative>>('init_dart_api_dl')
+    .asFunction();
+
+final SetDartEventPortDart _setDartEventPort = _nativeLib
+    .lookup<NativeFunction<SetDartEventPortNative>>('set_dart_event_port')
+    .asFunction();
+
+final RegisterHotkeyDart _registerHotkey = _nativeLib
+    .lookup<NativeFunction<RegisterHotkeyNative>>('register_hotkey')
+    .asFunction();
+
+final UnregisterHotkeyDart _unregisterHotkey = _nativeLib
+    .lookup<NativeFunction<UnregisterHotkeyNative>>('unregister_hotkey')
+    .asFunction();
+
+final SetSpeculativeProcessingDart _setSpeculativeProcessing = _nativeLib
+    .lookup<NativeFunction<SetSpeculativeProcessingNative>>('set_speculative_processing')
+    .asFunction();
+
+final SetSegmentedProcessingDart _setSegmentedProcessing = _nativeLib
+    .lookup<NativeFunction<SetSegmentedProcessingNative>>('set_segmented_processing')
+    .asFunction();
+
+final SetTranslationMemoryDart _setTranslationMemory = _nativeLib
+    .lookup<NativeFunction<SetTranslationMemoryNative>>('set_translation_memory')
+    .asFunction();
+
+final SetChunkedProcessingDart _setChunkedProcessing = _nativeLib
+    .lookup<NativeFunction<SetChunkedProcessingNative>>('set_chunked_processing')
     .asFunction();
 
-final SetMenuActionCallbackDart _setMenuActionCallback = _nativeLib
-    .lookup<NativeFunction<SetMenuActionCallbackNative>>('set_menu_action_callback')
+final SetBackendConcurrencyDart _setBackendConcurrency = _nativeLib
+    .lookup<NativeFunction<SetBackendConcurrencyNative>>('set_backend_concurrency')
+    .asFunction();
+
+final SetOperationRateLimitDart _setOperationRateLimit = _nativeLib
+    .lookup<NativeFunction<SetOperationRateLimitNative>>('set_operation_rate_limit')
+    .asFunction();
+
+final SetResultCacheBudgetDart _setResultCacheBudget = _nativeLib
+    .lookup<NativeFunction<SetResultCacheBudgetNative>>('set_result_cache_budget')
+    .asFunction();
+
+final SetProcessingModelConfigDart _setProcessingModelConfig = _nativeLib
+    .lookup<NativeFunction<SetProcessingModelConfigNative>>('set_processing_model_config')
+    .asFunction();
+
+final ClearResultCacheDart _clearResultCache = _nativeLib
+    .lookup<NativeFunction<ClearResultCacheNative>>('clear_result_cache')
     .asFunction();
 
 final IsSystemCompatibleDart _isSystemCompatible = _nativeLib
@@ -143,6 +315,10 @@ final GetDesktopEnvironmentDart _getDesktopEnvironment = _nativeLib
     .lookup<NativeFunction<GetDesktopEnvironmentNative>>('get_desktop_environment')
     .asFunction();
 
+final GetActionChannelPathDart _getActionChannelPath = _nativeLib
+    .lookup<NativeFunction<GetActionChannelPathNative>>('get_action_channel_path')
+    .asFunction();
+
 final GetLastErrorDart _getLastError = _nativeLib
     .lookup<NativeFunction<GetLastErrorNative>>('get_last_error')
     .asFunction();
@@ -209,6 +385,206 @@ class MenuItemInfo {
   }
 }
 
+// Failed or cancelled asynchronous processing request
+class ProcessingException implements Exception {
+  final int status;
+
+  const ProcessingException(this.status);
+
+  bool get cancelled => status == StatusCode.cancelled;
+  bool get timedOut => status == StatusCode.timeout;
+  bool get rejected => status == StatusCode.rejected;
+
+  @override
+  String toString() => 'ProcessingException(status: $status)';
+}
+
+// Handle for a request started with SystemIntegration.startProcessing
+class ProcessingRequest {
+  final int id;
+  final Future<String> result;
+
+  const ProcessingRequest(this.id, this.result);
+}
+
+// One piece of a batched request
+class TextSegment {
+  final String text;
+  final String operation;
+
+  const TextSegment(this.text, this.operation);
+}
+
+// Outcome for one TextSegment
+class SegmentResult {
+  final int status;
+  final String? text;
+
+  const SegmentResult(this.status, this.text);
+
+  bool get succeeded => status == StatusCode.success;
+}
+
+// Runs on a helper isolate: send_processing_batch blocks for the round trip
+List<SegmentResult> _runProcessingBatch(List<TextSegment> segments) {
+  final segmentsPtr = calloc<ProcessingSegment>(segments.length);
+  final resultsPtr = calloc<Pointer<ProcessingSegmentResult>>();
+
+  try {
+    for (int i = 0; i < segments.length; i++) {
+      final nativeSegment = (segmentsPtr + i).ref;
+      nativeSegment.id = i;
+      nativeSegment.text = segments[i].text.toNativeUtf8();
+      nativeSegment.operation = segments[i].operation.toNativeUtf8();
+    }
+
+    final status = _sendProcessingBatch(segmentsPtr, segments.length, resultsPtr);
+    if (status != StatusCode.success) {
+      throw ProcessingException(status);
+    }
+
+    final results = resultsPtr.value;
+    if (results == nullptr) return const [];
+    try {
+      return [
+        for (int i = 0; i < segments.length; i++)
+          SegmentResult(
+            (results + i).ref.status,
+            (results + i).ref.result == nullptr ? null : (results + i).ref.result.toDartString(),
+          ),
+      ];
+    } finally {
+      _freeProcessingResults(results, segments.length);
+    }
+  } finally {
+    for (int i = 0; i < segments.length; i++) {
+      final nativeSegment = (segmentsPtr + i).ref;
+      calloc.free(nativeSegment.text);
+      calloc.free(nativeSegment.operation);
+    }
+    calloc.free(segmentsPtr);
+    calloc.free(resultsPtr);
+  }
+}
+
+// Menu action received over the native action channel
+class ChannelAction {
+  final int sequence;
+  final String menuId;
+  final String text;
+  final int x;
+  final int y;
+
+  const ChannelAction({
+    required this.sequence,
+    required this.menuId,
+    required this.text,
+    required this.x,
+    required this.y,
+  });
+}
+
+// Reads the framed menu actions the native side streams over its Unix
+// socket. Frame layout (little-endian) is documented in action_channel.h.
+class ActionChannelReader {
+  static const int frameMenuAction = 1;
+
+  final String path;
+  final _controller = StreamController<ChannelAction>();
+  Socket? _socket;
+  Uint8List _pending = Uint8List(0);
+  int _lastSequence = 0;
+
+  // Frames missing from the sequence (the native side dropped them)
+  int droppedFrames = 0;
+
+  ActionChannelReader(this.path);
+
+  Stream<ChannelAction> get actions => _controller.stream;
+
+  Future<void> connect() async {
+    final address = InternetAddress(path, type: InternetAddressType.unix);
+    final socket = await Socket.connect(address, 0);
+    _socket = socket;
+    socket.listen(
+      _onData,
+      onDone: close,
+      onError: (_) => close(),
+      cancelOnError: true,
+    );
+  }
+
+  void _onData(Uint8List data) {
+    if (_pending.isEmpty) {
+      _pending = data;
+    } else {
+      final joined = Uint8List(_pending.length + data.length);
+      joined.setRange(0, _pending.length, _pending);
+      joined.setRange(_pending.length, joined.length, data);
+      _pending = joined;
+    }
+
+    // Consume every complete frame; keep a partial one for the next read
+    int offset = 0;
+    final view = ByteData.sublistView(_pending);
+    while (_pending.length - offset >= 4) {
+      final length = view.getUint32(offset, Endian.little);
+      if (_pending.length - offset - 4 < length) break;
+      _parseFrame(ByteData.sublistView(_pending, offset + 4, offset + 4 + length));
+      offset += 4 + length;
+    }
+    if (offset > 0) {
+      _pending = Uint8List.fromList(_pending.sublist(offset));
+    }
+  }
+
+  void _parseFrame(ByteData frame) {
+    final type = frame.getUint16(0, Endian.little);
+    final sequence = frame.getUint32(4, Endian.little);
+    if (_lastSequence != 0 && sequence != _lastSequence + 1) {
+      droppedFrames += sequence - _lastSequence - 1;
+    }
+    _lastSequence = sequence;
+
+    // Newer frame types are skipped by older readers
+    if (type != frameMenuAction) return;
+
+    int offset = 8;
+    String readString() {
+      final length = frame.getUint32(offset, Endian.little);
+      offset += 4;
+      final value = utf8.decode(
+        Uint8List.sublistView(frame, offset, offset + length),
+        allowMalformed: true,
+      );
+      offset += length;
+      return value;
+    }
+
+    final menuId = readString();
+    final text = readString();
+    final x = frame.getInt32(offset, Endian.little);
+    final y = frame.getInt32(offset + 4, Endian.little);
+
+    if (!_controller.isClosed) {
+      _controller.add(ChannelAction(
+        sequence: sequence,
+        menuId: menuId,
+        text: text,
+        x: x,
+        y: y,
+      ));
+    }
+  }
+
+  Future<void> close() async {
+    final socket = _socket;
+    _socket = null;
+    socket?.destroy();
+    if (!_controller.isClosed) await _controller.close();
+  }
+}
+
 // Main system integration class
 class SystemIntegration {
   static final SystemIntegration _instance = SystemIntegration._internal();
@@ -218,10 +594,16 @@ class SystemIntegration {
   // Callbacks
   void Function(SelectionInfo)? _onSelectionChanged;
   void Function(String menuId, SelectionInfo selection)? _onMenuAction;
+  void Function(String operation, int completed, int total)? _onChunkProgress;
+
+  // Native events arrive here from any native thread
+  ReceivePort? _eventPort;
+
+  // Asynchronous requests waiting for NativeEvent.processingDone
+  final Map<int, Completer<String>> _pendingRequests = {};
 
-  // Native callback wrappers
-  late final Pointer<NativeFunction<SelectionCallbackNative>> _selectionCallbackPtr;
-  late final Pointer<NativeFunction<MenuActionCallbackNative>> _menuActionCallbackPtr;
+  // Partial results of streaming requests, fed by NativeEvent.processingProgress
+  final Map<int, (StringBuffer, void Function(String partial))> _progressListeners = {};
 
   bool _initialized = false;
 
@@ -240,23 +622,24 @@ class SystemIntegration {
       return false;
     }
 
-    // Only set up callbacks if explicitly requested and safe
+    // Native threads post events to a port; calling Dart functions from
+    // them directly is not allowed
     if (enableCallbacks) {
-      try {
-        // Set up native callbacks
-        _selectionCallbackPtr = Pointer.fromFunction<SelectionCallbackNative>(_onSelectionChangedNative);
-        _menuActionCallbackPtr = Pointer.fromFunction<MenuActionCallbackNative>(_onMenuActionNative);
-
-        // Set callbacks
-        _setSelectionCallback(_selectionCallbackPtr);
-        _setMenuActionCallback(_menuActionCallbackPtr);
-        print('✅ Callbacks enabled');
-      } catch (e) {
-        print('⚠️  Callback setup failed: $e');
-        print('   Continuing without callbacks');
+      if (_initDartApiDL(NativeApi.initializeApiDLData) == StatusCode.success) {
+        final port = ReceivePort('native-events');
+        port.listen(_onNativeEvent);
+        if (_setDartEventPort(port.sendPort.nativePort) == StatusCode.success) {
+          _eventPort = port;
+          print('✅ Callbacks enabled (native event port)');
+        } else {
+          port.close();
+          print('⚠️  Event port setup failed, continuing without callbacks');
+        }
+      } else {
+        print('⚠️  Native library built without Dart API DL, continuing without callbacks');
       }
     } else {
-      print('📋 Running without callbacks to avoid isolate issues');
+      print('📋 Running without callbacks');
     }
 
     _initialized = true;
@@ -267,6 +650,18 @@ class SystemIntegration {
   void cleanup() {
     if (!_initialized) return;
 
+    for (final completer in _pendingRequests.values) {
+      completer.completeError(const ProcessingException(StatusCode.cancelled));
+    }
+    _pendingRequests.clear();
+    _progressListeners.clear();
+
+    if (_eventPort != null) {
+      _setDartEventPort(0);
+      _eventPort!.close();
+      _eventPort = null;
+    }
+
     _cleanupSystemHooks();
     _initialized = false;
   }
@@ -286,6 +681,18 @@ class SystemIntegration {
     return result;
   }
 
+  // Unix socket path that streams menu actions (see ActionChannelReader)
+  String? getActionChannelPath() {
+    if (!_initialized) return null;
+
+    final ptr = _getActionChannelPath();
+    if (ptr == nullptr) return null;
+
+    final result = ptr.toDartString();
+    _freeString(ptr);
+    return result;
+  }
+
   // Get last error
   String? getLastError() {
     final ptr = _getLastError();
@@ -331,6 +738,99 @@ class SystemIntegration {
     }
   }
 
+  // Bind a global hotkey such as "Ctrl+Shift+T". With [menuItemId] the
+  // item runs directly, otherwise the hotkey opens the menu.
+  // Returns the hotkey id, or null on failure.
+  int? registerHotkey(String accelerator, {String? menuItemId}) {
+    if (!_initialized) return null;
+
+    final acceleratorPtr = accelerator.toNativeUtf8();
+    final Pointer<Utf8> menuItemIdPtr = menuItemId != null ? menuItemId.toNativeUtf8() : nullptr;
+    try {
+      final action = menuItemId != null ? HotkeyAction.menuItem : HotkeyAction.showMenu;
+      int result = _registerHotkey(acceleratorPtr, action, menuItemIdPtr);
+      return result > 0 ? result : null;
+    } finally {
+      calloc.free(acceleratorPtr);
+      if (menuItemIdPtr != nullptr) calloc.free(menuItemIdPtr);
+    }
+  }
+
+  // Remove a hotkey returned by registerHotkey
+  bool unregisterHotkey(int hotkeyId) {
+    if (!_initialized) return false;
+    return _unregisterHotkey(hotkeyId) == StatusCode.success;
+  }
+
+  // Start the likely action as soon as the menu opens
+  bool setSpeculativeProcessing(bool enabled) {
+    if (!_initialized) return false;
+    return _setSpeculativeProcessing(enabled ? 1 : 0) == StatusCode.success;
+  }
+
+  // Send only the sentences of a selection that aren't cached yet
+  bool setSegmentedProcessing(bool enabled) {
+    if (!_initialized) return false;
+    return _setSegmentedProcessing(enabled ? 1 : 0) == StatusCode.success;
+  }
+
+  // Split selections longer than chunkBytes into chunks processed
+  // maxParallel at a time (chunkBytes 0 sends them whole)
+  bool setChunkedProcessing({int chunkBytes = 4096, int maxParallel = 4}) {
+    if (!_initialized) return false;
+    return _setChunkedProcessing(chunkBytes, maxParallel) == StatusCode.success;
+  }
+
+  // Cap concurrent backend calls and the queue behind them; callers that
+  // find it full or wait too long fail with StatusCode.rejected
+  bool setBackendConcurrency({int maxConcurrency = 32, int maxQueue = 64}) {
+    if (!_initialized) return false;
+    return _setBackendConcurrency(maxConcurrency, maxQueue) == StatusCode.success;
+  }
+
+  // Token bucket for one operation's backend calls (all others when null)
+  bool setOperationRateLimit(String? operation, double perSecond, int burst) {
+    if (!_initialized) return false;
+    final Pointer<Utf8> operationPtr = operation == null ? nullptr : operation.toNativeUtf8();
+    try {
+      return _setOperationRateLimit(operationPtr, perSecond, burst) == StatusCode.success;
+    } finally {
+      if (operationPtr != nullptr) calloc.free(operationPtr);
+    }
+  }
+
+  // Reuse earlier results for near-duplicate text: as a hint to the
+  // backend from hintSimilarity, as the answer from serveSimilarity (0 = off)
+  bool setTranslationMemory({double hintSimilarity = 0.5, double serveSimilarity = 0.0}) {
+    if (!_initialized) return false;
+    return _setTranslationMemory(hintSimilarity, serveSimilarity) == StatusCode.success;
+  }
+
+  // Byte budget of the native result cache (0 turns it off)
+  bool setResultCacheBudget(int bytes) {
+    if (!_initialized) return false;
+    return _setResultCacheBudget(bytes) == StatusCode.success;
+  }
+
+  // Describe the backend's model and settings; cached results are only
+  // reused under the same config
+  bool setProcessingModelConfig(String config) {
+    if (!_initialized) return false;
+
+    final configPtr = config.toNativeUtf8();
+    try {
+      return _setProcessingModelConfig(configPtr) == StatusCode.success;
+    } finally {
+      calloc.free(configPtr);
+    }
+  }
+
+  // Forget every cached result
+  bool clearResultCache() {
+    if (!_initialized) return false;
+    return _clearResultCache() == StatusCode.success;
+  }
+
   // Get current selection
   SelectionInfo? getCurrentSelection() {
     if (!_initialized) return null;
@@ -365,55 +865,168 @@ class SystemIntegration {
     }
   }
 
+  // Start processing without blocking; needs callbacks (the event port).
+  // The result future fails with ProcessingException on error, timeout or
+  // cancellation. With [onProgress] the result is streamed, and the
+  // callback sees the growing partial text before the future completes.
+  ProcessingRequest? startProcessing(
+    String text,
+    String operation, {
+    Duration? timeout,
+    void Function(String partial)? onProgress,
+  }) {
+    if (!_initialized || _eventPort == null) return null;
+
+    final textPtr = text.toNativeUtf8();
+    final operationPtr = operation.toNativeUtf8();
+    try {
+      final timeoutMs = timeout?.inMilliseconds ?? 0;
+      final id = onProgress != null
+          ? _sendProcessingRequestStreaming(textPtr, operationPtr, timeoutMs, nullptr, nullptr, nullptr)
+          : _sendProcessingRequestAsync(textPtr, operationPtr, timeoutMs, nullptr, nullptr);
+      if (id <= 0) return null;
+
+      final completer = Completer<String>();
+      _pendingRequests[id] = completer;
+      if (onProgress != null) {
+        _progressListeners[id] = (StringBuffer(), onProgress);
+      }
+      return ProcessingRequest(id, completer.future);
+    } finally {
+      calloc.free(textPtr);
+      calloc.free(operationPtr);
+    }
+  }
+
+  // Process many segments in one D-Bus round trip. Results line up with
+  // [segments]; the future fails with ProcessingException if the batch as a
+  // whole could not be sent or answered.
+  Future<List<SegmentResult>> processTextBatch(List<TextSegment> segments) {
+    if (!_initialized) {
+      return Future.error(const ProcessingException(StatusCode.errorInit));
+    }
+    if (segments.isEmpty) return Future.value(const []);
+    return Isolate.run(() => _runProcessingBatch(segments));
+  }
+
+  // Cancel a request from startProcessing
+  bool cancelProcessing(int requestId) {
+    if (!_initialized) return false;
+    return _cancelProcessingRequest(requestId) == StatusCode.success;
+  }
+
+  // Cancel all queued and preemptible work of a ProcessingPriority class
+  bool cancelProcessingClass(int priority) {
+    if (!_initialized) return false;
+    return _cancelProcessingClass(priority) == StatusCode.success;
+  }
+
+  // Claim a finished request and complete its future
+  void _completeProcessing(int requestId) {
+    _progressListeners.remove(requestId);
+    final completer = _pendingRequests.remove(requestId);
+    if (completer == null) return;
+
+    final statusPtr = calloc<Int32>();
+    final resultPtr = calloc<Pointer<Utf8>>();
+    try {
+      if (_takeProcessingResult(requestId, statusPtr, resultPtr) != 1) {
+        completer.completeError(const ProcessingException(StatusCode.errorDbus));
+        return;
+      }
+
+      final status = statusPtr.value;
+      final result = resultPtr.value;
+      if (status == StatusCode.success && result != nullptr) {
+        completer.complete(result.toDartString());
+      } else {
+        completer.completeError(ProcessingException(status));
+      }
+      if (result != nullptr) _freeString(result);
+    } finally {
+      calloc.free(statusPtr);
+      calloc.free(resultPtr);
+    }
+  }
+
   // Set selection change callback
   void setOnSelectionChanged(void Function(SelectionInfo)? callback) {
     _onSelectionChanged = callback;
   }
 
-  // Set menu action callback
+  // Set menu action callback (needs initialize(enableCallbacks: true)).
+  // Actions also go to the action channel, so a listener should use only
+  // one of the two routes.
   void setOnMenuAction(void Function(String menuId, SelectionInfo selection)? callback) {
     _onMenuAction = callback;
   }
 
-  // Native callback implementations
-  static void _onSelectionChangedNative(Pointer<SelectionData> selectionPtr) {
-    final instance = SystemIntegration._instance;
-    if (instance._onSelectionChanged == null || selectionPtr == nullptr) return;
-
-    try {
-      final selection = selectionPtr.ref;
-      final selectionInfo = SelectionInfo(
-        text: selection.text.toDartString(),
-        x: selection.x,
-        y: selection.y,
-        appName: selection.appName.toDartString(),
-        length: selection.length,
-      );
-
-      instance._onSelectionChanged!(selectionInfo);
-    } catch (e) {
-      print('Error in selection callback: $e');
-    }
+  // Set progress callback for long selections processed in chunks
+  void setOnChunkProgress(void Function(String operation, int completed, int total)? callback) {
+    _onChunkProgress = callback;
   }
 
-  static void _onMenuActionNative(Pointer<Utf8> menuIdPtr, Pointer<SelectionData> selectionPtr) {
-    final instance = SystemIntegration._instance;
-    if (instance._onMenuAction == null || menuIdPtr == nullptr || selectionPtr == nullptr) return;
+  // Decode one [kind, payload] event posted by the native side
+  void _onNativeEvent(dynamic message) {
+    if (message is! List || message.length != 2) return;
+    final kind = message[0] as int;
+    final payload = message[1] as Uint8List;
 
     try {
-      final menuId = menuIdPtr.toDartString();
-      final selection = selectionPtr.ref;
-      final selectionInfo = SelectionInfo(
-        text: selection.text.toDartString(),
-        x: selection.x,
-        y: selection.y,
-        appName: selection.appName.toDartString(),
-        length: selection.length,
-      );
+      final data = ByteData.sublistView(payload);
+      int offset = 0;
+      String readString() {
+        final length = data.getUint32(offset, Endian.little);
+        offset += 4;
+        final value = utf8.decode(
+          Uint8List.sublistView(payload, offset, offset + length),
+          allowMalformed: true,
+        );
+        offset += length;
+        return value;
+      }
 
-      instance._onMenuAction!(menuId, selectionInfo);
+      SelectionInfo readSelection() {
+        final textLength = data.getUint32(offset, Endian.little);
+        final text = readString();
+        final appName = readString();
+        final x = data.getInt32(offset, Endian.little);
+        final y = data.getInt32(offset + 4, Endian.little);
+        offset += 8;
+        return SelectionInfo(
+          text: text,
+          x: x,
+          y: y,
+          appName: appName,
+          length: textLength,
+        );
+      }
+
+      if (kind == NativeEvent.processingDone) {
+        _completeProcessing(data.getInt32(0, Endian.little));
+      } else if (kind == NativeEvent.processingProgress) {
+        final requestId = data.getInt32(0, Endian.little);
+        offset = 4;
+        final chunk = readString();
+        final listener = _progressListeners[requestId];
+        if (listener != null) {
+          final (partial, onProgress) = listener;
+          partial.write(chunk);
+          onProgress(partial.toString());
+        }
+      } else if (kind == NativeEvent.chunkProgress) {
+        final operation = readString();
+        final completed = data.getInt32(offset, Endian.little);
+        final total = data.getInt32(offset + 4, Endian.little);
+        _onChunkProgress?.call(operation, completed, total);
+      } else if (kind == NativeEvent.selection) {
+        _onSelectionChanged?.call(readSelection());
+      } else if (kind == NativeEvent.menuAction) {
+        final menuId = readString();
+        _onMenuAction?.call(menuId, readSelection());
+      }
     } catch (e) {
-      print('Error in menu action callback: $e');
+      print('Error in native event handler: $e');
     }
   }
 }
@@ -1,5 +1,4 @@
 import 'dart:async';
-import 'dart:io';
 import '../native/system_integration_safe.dart';
 import 'context_menu_config_service.dart';
 
@@ -65,13 +64,11 @@ class ProductionContextMenuService {
   List<String> get logs => List.unmodifiable(_logs);
   List<ContextMenuAction> get actions => List.unmodifiable(_actions);
 
-  bool _processing = false;
-  String?
-  _lastProcessedAction; // Track last processed action to prevent duplicates
   bool _initialized = false;
   bool _monitoring = false;
   List<ContextMenuConfig> _activeConfigs = [];
-  Timer? _monitoringTimer;
+  ActionChannelReader? _actionChannel;
+  StreamSubscription<void>? _actionSubscription;
 
   // Initialize the service
   Future<bool> initialize() async {
@@ -109,8 +106,8 @@ class ProductionContextMenuService {
       _updateStatus('Ready');
       _addLog('✅ Production context menu service initialized successfully');
 
-      // Start monitoring for menu actions (polling approach)
-      _startMonitoring();
+      // Start receiving menu actions from the native action channel
+      await _startMonitoring();
 
       return true;
     } catch (e) {
@@ -150,63 +147,42 @@ class ProductionContextMenuService {
     }
   }
 
-  // Start monitoring for actions (file-based communication)
-  void _startMonitoring() {
+  // Start receiving menu actions over the native action channel
+  Future<void> _startMonitoring() async {
     if (_monitoring) return;
-    _monitoring = true;
 
-    _addLog('📡 Starting action monitoring (file-based)...');
-
-    // Monitor for menu actions via file system
-    _monitoringTimer = Timer.periodic(Duration(milliseconds: 500), (timer) {
-      _checkForMenuActions();
-    });
-  }
+    final path = _systemIntegration.getActionChannelPath();
+    if (path == null) {
+      _addLog('❌ Native action channel is not available');
+      return;
+    }
 
-  // Check for menu actions written to file by native code
-  Future<void> _checkForMenuActions() async {
-    if (_processing) return; // Prevent multiple concurrent processing
+    _addLog('📡 Connecting to action channel at $path...');
 
     try {
-      final actionFile = File('/tmp/instant_translator_action.txt');
-      if (await actionFile.exists()) {
-        final content = await actionFile.readAsString();
-        final parts = content.trim().split('\t\n');
-
-        if (parts.length == 2) {
-          final menuId = parts[0];
-          final selectedText = parts[1];
-          final actionKey = '$menuId:$selectedText';
-
-          // Check if this is a duplicate action
-          if (_lastProcessedAction == actionKey) {
-            await actionFile.delete(); // Clean up duplicate
-            return;
-          }
-
-          _processing = true; // Mark as processing
-          _lastProcessedAction = actionKey; // Remember this action
-
-          _addLog('📨 Received menu action from native: $menuId');
-
-          // Clean up the action file FIRST to prevent reprocessing
-          await actionFile.delete();
-
-          // Process the action
-          await handleMenuAction(menuId, selectedText);
-        } else {
-          // Invalid format, clean up file
-          await actionFile.delete();
-        }
-      }
+      final channel = ActionChannelReader(path);
+      await channel.connect();
+      _actionChannel = channel;
+      _monitoring = true;
+
+      // One action at a time, in the order they were clicked
+      _actionSubscription = channel.actions
+          .asyncMap((action) async {
+            _addLog('📨 Received menu action from native: ${action.menuId}');
+            if (channel.droppedFrames > 0) {
+              _addLog('⚠️  ${channel.droppedFrames} menu actions were dropped');
+            }
+            await handleMenuAction(action.menuId, action.text);
+          })
+          .listen(
+            (_) {},
+            onDone: () {
+              _monitoring = false;
+              _addLog('📭 Action channel closed');
+            },
+          );
     } catch (e) {
-      // Silently handle errors to avoid spam
-    } finally {
-      _processing = false; // Always reset processing flag
-      // Clear last action after a delay to allow new actions
-      Future.delayed(Duration(seconds: 2), () {
-        _lastProcessedAction = null;
-      });
+      _addLog('❌ Failed to connect to action channel: $e');
     }
   }
 
@@ -501,7 +477,8 @@ class ProductionContextMenuService {
     if (!_initialized) return; // Already disposed
 
     _monitoring = false;
-    _monitoringTimer?.cancel();
+    _actionSubscription?.cancel();
+    _actionChannel?.close();
     _systemIntegration.cleanup();
 
     // Close streams safely
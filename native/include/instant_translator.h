@@ -1,6 +1,8 @@
 #ifndef INSTANT_TRANSLATOR_H
 #define INSTANT_TRANSLATOR_H
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -21,13 +23,86 @@ typedef struct {
     int enabled;        // Whether menu item is enabled
 } MenuItem;
 
+// What a registered hotkey does
+typedef enum {
+    HOTKEY_ACTION_SHOW_MENU = 0,    // Open the context menu for the selection
+    HOTKEY_ACTION_MENU_ITEM = 1     // Run one MenuItem directly, no popup
+} HotkeyAction;
+
+// Hotkey dispatch latency: KeyPress dequeued -> menu queued on GTK
+typedef struct {
+    int count;          // Hotkey presses measured
+    long last_us;       // Latest dispatch time (microseconds)
+    long max_us;        // Slowest dispatch time
+    long mean_us;       // Average dispatch time
+    int over_budget;    // Dispatches slower than HOTKEY_LATENCY_BUDGET_US
+} HotkeyLatencyStats;
+
+#define HOTKEY_LATENCY_BUDGET_US 1000
+
+// Menu frame latency (same struct): hotkey -> first painted popup frame,
+// over_budget counting frames later than one 60Hz refresh
+#define MENU_FRAME_BUDGET_US 16667
+
+// Result cache in front of send_processing_request
+typedef struct {
+    long hits;
+    long misses;
+    long evictions;     // Entries pushed out by the byte budget
+    long entries;
+    long bytes;         // Held, bookkeeping included
+    long budget_bytes;  // 0 while caching is off
+    long disk_hits;     // Hits served from the on-disk store (counted in hits)
+    long disk_entries;
+    long disk_bytes;    // Log size, garbage included
+} ResultCacheStats;
+
+// Admission control in front of the processing backend
+typedef struct {
+    int limit;              // Current concurrency limit (adapts to latency and errors)
+    int in_flight;
+    int queued;
+    long admitted;
+    long rejected;          // Queue full or waited too long
+    long limit_decreases;
+    long mean_wait_us;      // Queue wait of admitted calls
+    long latency_baseline_us;   // Best recent latency per KiB of text
+} AdmissionStats;
+
+// Processing priority classes, most urgent first. Backend slots go to the
+// highest class waiting; a waiting class may cut lower-class calls short.
+typedef enum {
+    PRIORITY_INTERACTIVE = 0,       // Menu clicks and hotkey actions: the user is waiting
+    PRIORITY_SPECULATIVE = 1,       // Prefetch of the action the user is likely to pick
+    PRIORITY_BACKGROUND = 2         // Cache warming and other work nobody waits on
+} ProcessingPriority;
+
+#define PROCESSING_PRIORITY_COUNT 3
+
+// Per-class scheduler counters
+typedef struct {
+    int queued;             // Jobs waiting for a worker
+    int running;
+    long completed;
+    long cancelled;         // Jobs cancelled before they could finish
+    long mean_queue_us;     // Job submission -> a worker picks it up
+    long max_queue_us;
+    long admitted;          // Backend calls of this class (jobs or not)
+    long mean_admission_wait_us;    // Waiting for a backend slot
+    long max_admission_wait_us;
+    long preempted;         // Backend calls cut short for a higher class
+} SchedulerClassStats;
+
 typedef enum {
     STATUS_SUCCESS = 0,
     STATUS_ERROR_INIT = -1,
     STATUS_ERROR_NO_SELECTION = -2,
     STATUS_ERROR_NO_DISPLAY = -3,
     STATUS_ERROR_DBUS = -4,
-    STATUS_ERROR_GTK = -5
+    STATUS_ERROR_GTK = -5,
+    STATUS_CANCELLED = -6,          // Request cancelled before it completed
+    STATUS_TIMEOUT = -7,            // Request passed its deadline
+    STATUS_ERROR_REJECTED = -8      // Backend busy: its queue was full or the wait too long
 } StatusCode;
 
 // Core system hooks functions
@@ -38,6 +113,13 @@ void cleanup_system_hooks();
 int register_context_menu(MenuItem* menu_items, int count);
 int unregister_context_menu();
 
+// Global hotkeys. Accelerators look like "Ctrl+Shift+M" or "Super+T";
+// Ctrl, Shift, Alt and Super are matched, lock keys are ignored.
+// register_hotkey returns a hotkey id > 0 or a negative StatusCode.
+int register_hotkey(const char* accelerator, int action, const char* menu_item_id);
+int unregister_hotkey(int hotkey_id);
+int clear_hotkeys();
+
 // Text selection operations
 SelectionData* get_current_selection();
 void free_selection_data(SelectionData* data);
@@ -51,6 +133,128 @@ int init_dbus_service();
 void cleanup_dbus_service();
 int send_processing_request(const char* text, const char* operation, char** result);
 
+// Asynchronous processing. Returns a request id > 0 (or a negative
+// StatusCode) immediately; any number of requests may be in flight.
+// `timeout_ms` <= 0 uses the 30s default. With a callback, it runs once on
+// the D-Bus dispatcher thread with a borrowed result. Without one, the
+// outcome is kept for take_processing_result and, if a Dart event port is
+// attached, announced there. Cancelled requests complete with
+// STATUS_CANCELLED, expired ones with STATUS_TIMEOUT, and ones the busy
+// backend had no room for with STATUS_ERROR_REJECTED (returned right away
+// when its queue is full).
+// A request for the same (text, operation) as one still in flight shares
+// that one's backend call. It still gets its own id, outcome, deadline and
+// cancellation; the call is only dropped when every request sharing it has
+// been cancelled or expired. Streaming requests only share streaming calls,
+// so each one gets its chunks; plain requests share either kind.
+typedef void (*ProcessingCallback)(int request_id, int status, const char* result, void* user_data);
+
+int send_processing_request_async(const char* text, const char* operation, int timeout_ms,
+                                  ProcessingCallback callback, void* user_data);
+
+// Streaming variant: `progress` runs on the dispatcher thread with the
+// whole partial result (borrowed) each time a chunk arrives, before the
+// completion. Without either callback, chunks are posted to the Dart event
+// port. Backends that can't stream just complete it like a plain request.
+typedef void (*ProcessingProgressCallback)(int request_id, const char* partial, void* user_data);
+
+int send_processing_request_streaming(const char* text, const char* operation, int timeout_ms,
+                                      ProcessingProgressCallback progress,
+                                      ProcessingCallback callback, void* user_data);
+int cancel_processing_request(int request_id);
+// Requests above run at the priority of the scheduled job that sends them,
+// PRIORITY_INTERACTIVE outside any job.
+// 1 with status/result filled (free result with free_string), 0 while still
+// pending, or a negative StatusCode for unknown ids
+int take_processing_result(int request_id, int* status, char** result);
+
+// Batched processing: one ProcessTextBatch round trip for many segments
+typedef struct {
+    int id;             // Caller-chosen, unique within the batch
+    char* text;
+    char* operation;
+} ProcessingSegment;
+
+typedef struct {
+    int id;             // Matches the segment's id
+    int status;         // StatusCode for this segment
+    char* result;       // NULL unless status is STATUS_SUCCESS
+} ProcessingSegmentResult;
+
+// Blocking. On STATUS_SUCCESS `*results` holds `count` entries where
+// results[i] answers segments[i], whatever order the backend replied in;
+// free them with free_processing_results. A failed round trip returns its
+// status and no results. Backends without ProcessTextBatch are served one
+// ProcessText per segment.
+int send_processing_batch(const ProcessingSegment* segments, int count, ProcessingSegmentResult** results);
+void free_processing_results(ProcessingSegmentResult* results, int count);
+
+// Run send_processing_request as a job of the given ProcessingPriority on a
+// worker of that class, so the caller (a GTK or X11 callback, say) never
+// blocks. Returns a job id > 0 or a negative StatusCode. `callback` runs once
+// on the worker with a borrowed result, STATUS_CANCELLED if the job was
+// cancelled first or its backend call was preempted (resubmit it to try
+// again). Interactive jobs never wait for lower-class workers, and their
+// backend calls preempt lower-class streaming ones. The asynchronous,
+// streaming and batch calls above don't use these workers; they are
+// admitted at the priority of the job that makes them, PRIORITY_INTERACTIVE
+// outside any job.
+int schedule_processing(const char* text, const char* operation, int priority,
+                        ProcessingCallback callback, void* user_data);
+// A job already sending finishes its call but still reports STATUS_CANCELLED
+int cancel_scheduled_processing(int job_id);
+// Cancel every queued job and backend call of one class, and cut short its
+// running streaming calls (speculation, say, once the user has decided)
+int cancel_processing_class(int priority);
+
+// Start the most likely action as soon as the menu opens (on by default).
+// A matching send_processing_request reuses that result.
+int set_speculative_processing(int enabled);
+
+// Process multi-sentence selections sentence by sentence (on by default),
+// so after an edit only the changed sentences reach the backend. Turn off
+// for actions that need the whole text as context.
+int set_segmented_processing(int enabled);
+
+// Selections longer than `chunk_bytes` are cut at paragraph or sentence
+// boundaries into chunks of at most that size, processed up to
+// `max_parallel` at a time (each retried on its own if it fails) and joined
+// back in order. Defaults 4096 and 4; 0 `chunk_bytes` sends them whole.
+int set_chunked_processing(int chunk_bytes, int max_parallel);
+
+// `completed` of `total` chunks of a long selection are done; called once
+// with 0 before the first. Runs on a worker thread. Without a callback,
+// progress is posted to the Dart event port.
+typedef void (*ChunkProgressCallback)(const char* operation, int completed, int total);
+
+int set_chunk_progress_callback(ChunkProgressCallback callback);
+
+// Backend calls run at most `max_concurrency` at a time (the limit in use
+// adapts below that to latency and errors, default ceiling 32). Callers
+// beyond it wait in a queue of `max_queue` (default 64) for up to 5s, then
+// fail with STATUS_ERROR_REJECTED, as do callers finding the queue full.
+int set_backend_concurrency(int max_concurrency, int max_queue);
+
+// Token bucket for an operation's backend calls: `per_second` sustained,
+// `burst` at once. A NULL operation sets the default for all others
+// (10/s, burst 20). 0 `per_second` means unlimited.
+int set_operation_rate_limit(const char* operation, double per_second, int burst);
+
+// Earlier results are indexed by similarity (Jaccard over character
+// shingles, 0..1). A text at least `hint_similarity` close to an earlier
+// one is sent with that pair as a hint (default 0.5). One at least
+// `serve_similarity` close gets the earlier result with no backend call
+// (default 0, off). 0 disables either.
+int set_translation_memory(double hint_similarity, double serve_similarity);
+
+// Repeated (text, action) pairs are answered from an in-memory cache.
+// Entries of a menu item are dropped when register_context_menu changes its
+// ai_instruction. The model config (any string describing the backend's
+// model and settings) is part of every key; changing it empties the cache.
+int set_result_cache_budget(long bytes);    // 0 turns caching off
+int set_processing_model_config(const char* config);
+int clear_result_cache();
+
 // Event system
 typedef void (*SelectionCallback)(SelectionData* selection);
 typedef void (*MenuActionCallback)(const char* menu_id, SelectionData* selection);
@@ -58,6 +262,26 @@ typedef void (*MenuActionCallback)(const char* menu_id, SelectionData* selection
 int set_selection_callback(SelectionCallback callback);
 int set_menu_action_callback(MenuActionCallback callback);
 
+// Thread-safe event delivery to a Dart isolate. Pass
+// NativeApi.initializeApiDLData to init_dart_api_dl, then a SendPort's
+// nativePort to set_dart_event_port; selection and menu-action events are
+// posted there instead of calling the function pointers above (see
+// dart_port_bridge.h for the message layout). Port 0 detaches.
+int init_dart_api_dl(void* api_dl_data);
+int set_dart_event_port(int64_t port);
+
+// Without a callback, menu actions are streamed as framed messages over a
+// Unix socket at this path (see action_channel.h). Free with free_string().
+char* get_action_channel_path();
+
+// Diagnostics
+int get_hotkey_latency_stats(HotkeyLatencyStats* stats);
+int get_menu_frame_latency_stats(HotkeyLatencyStats* rebuilt, HotkeyLatencyStats* reused);
+int get_result_cache_stats(ResultCacheStats* stats);
+int get_admission_stats(AdmissionStats* stats);
+int get_scheduler_stats(int priority, SchedulerClassStats* stats);
+void reset_hotkey_latency_stats();
+
 // Utility functions
 int is_system_compatible();
 char* get_desktop_environment();
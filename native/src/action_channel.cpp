@@ -0,0 +1,335 @@
+#include "action_channel.h"
+#include <glib.h>
+#include <glib-unix.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Drop a client whose unsent backlog grows past this (it stopped reading)
+#define ACTION_CHANNEL_MAX_PENDING_BYTES (4 * 1024 * 1024)
+
+// One connected reader
+typedef struct {
+    int fd;
+    guint in_source;        // HUP/ERR watch (and discards anything it sends)
+    guint out_source;       // Writable watch while `pending` is non-empty
+    GByteArray* pending;    // Bytes not yet accepted by the socket
+} ActionClient;
+
+// Channel state; the watches run on the GTK main loop, init/cleanup on the caller
+static GMutex channel_lock;
+static int listen_fd = -1;
+static guint listen_source = 0;
+static char* socket_dir = NULL;
+static char* socket_path = NULL;
+static GList* clients = NULL;
+static GQueue* backlog = NULL;   // Frames published while nobody was connected
+static guint32 next_sequence = 1;
+
+static gboolean on_client_writable(gint fd, GIOCondition condition, gpointer data);
+
+// Little-endian field writers
+static void put_u16(GByteArray* frame, guint16 value) {
+    guint16 le = GUINT16_TO_LE(value);
+    g_byte_array_append(frame, (const guint8*)&le, sizeof(le));
+}
+
+static void put_u32(GByteArray* frame, guint32 value) {
+    guint32 le = GUINT32_TO_LE(value);
+    g_byte_array_append(frame, (const guint8*)&le, sizeof(le));
+}
+
+static void put_bytes(GByteArray* frame, const char* data) {
+    guint32 length = data ? strlen(data) : 0;
+    put_u32(frame, length);
+    if (length > 0) {
+        g_byte_array_append(frame, (const guint8*)data, length);
+    }
+}
+
+// Caller holds channel_lock
+static void close_client_locked(ActionClient* client) {
+    clients = g_list_remove(clients, client);
+    if (client->in_source) g_source_remove(client->in_source);
+    if (client->out_source) g_source_remove(client->out_source);
+    close(client->fd);
+    g_byte_array_free(client->pending, TRUE);
+    free(client);
+}
+
+// Write as much of the backlog as the socket takes. Returns FALSE if the
+// client was closed. Caller holds channel_lock.
+static gboolean flush_client_locked(ActionClient* client) {
+    while (client->pending->len > 0) {
+        ssize_t sent = send(client->fd, client->pending->data, client->pending->len, MSG_NOSIGNAL);
+        if (sent > 0) {
+            g_byte_array_remove_range(client->pending, 0, sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (client->pending->len > ACTION_CHANNEL_MAX_PENDING_BYTES) {
+                printf("⚠️  Action channel client stopped reading, disconnecting\n");
+                close_client_locked(client);
+                return FALSE;
+            }
+            if (!client->out_source) {
+                client->out_source = g_unix_fd_add(client->fd, G_IO_OUT, on_client_writable, client);
+            }
+            return TRUE;
+        }
+        close_client_locked(client);
+        return FALSE;
+    }
+
+    if (client->out_source) {
+        g_source_remove(client->out_source);
+        client->out_source = 0;
+    }
+    return TRUE;
+}
+
+static gboolean on_client_writable(gint fd, GIOCondition condition, gpointer data) {
+    ActionClient* client = (ActionClient*)data;
+
+    g_mutex_lock(&channel_lock);
+    // The source is ours again to manage; flush re-adds it if still blocked
+    client->out_source = 0;
+    flush_client_locked(client);
+    g_mutex_unlock(&channel_lock);
+    return FALSE;
+}
+
+static gboolean on_client_event(gint fd, GIOCondition condition, gpointer data) {
+    ActionClient* client = (ActionClient*)data;
+    char scratch[256];
+
+    g_mutex_lock(&channel_lock);
+    ssize_t got = (condition & G_IO_IN) ? recv(fd, scratch, sizeof(scratch), 0) : 0;
+    if (got > 0 || (got < 0 && (errno == EAGAIN || errno == EINTR))) {
+        // Clients have nothing to say yet; ignore it
+        g_mutex_unlock(&channel_lock);
+        return TRUE;
+    }
+
+    printf("📭 Action channel client disconnected\n");
+    client->in_source = 0;
+    close_client_locked(client);
+    g_mutex_unlock(&channel_lock);
+    return FALSE;
+}
+
+static gboolean on_listen_ready(gint fd, GIOCondition condition, gpointer data) {
+    int client_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client_fd < 0) {
+        return TRUE;
+    }
+
+    ActionClient* client = (ActionClient*)calloc(1, sizeof(ActionClient));
+    client->fd = client_fd;
+    client->pending = g_byte_array_new();
+
+    g_mutex_lock(&channel_lock);
+    clients = g_list_append(clients, client);
+    client->in_source = g_unix_fd_add(client_fd, (GIOCondition)(G_IO_IN | G_IO_HUP | G_IO_ERR),
+                                      on_client_event, client);
+
+    // Hand over everything published while nobody was listening
+    int delivered = 0;
+    while (!g_queue_is_empty(backlog)) {
+        GByteArray* frame = (GByteArray*)g_queue_pop_head(backlog);
+        g_byte_array_append(client->pending, frame->data, frame->len);
+        g_byte_array_free(frame, TRUE);
+        delivered++;
+    }
+    flush_client_locked(client);
+    g_mutex_unlock(&channel_lock);
+
+    printf("📬 Action channel client connected (%d queued actions)\n", delivered);
+    return TRUE;
+}
+
+// Create, or accept an existing, directory only we can enter. The socket
+// is only reachable through it, so it is private from the moment of bind.
+static gboolean make_private_dir(const char* path) {
+    if (mkdir(path, S_IRWXU) < 0 && errno != EEXIST) {
+        return FALSE;
+    }
+
+    struct stat info;
+    if (lstat(path, &info) < 0 || !S_ISDIR(info.st_mode) ||
+        info.st_uid != getuid() || (info.st_mode & (S_IRWXG | S_IRWXO))) {
+        printf("❌ %s is not a private directory of this user\n", path);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Whether a server still accepts connections on `address`
+static gboolean socket_is_live(const struct sockaddr_un* address) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return FALSE;
+    }
+    gboolean live = connect(fd, (const struct sockaddr*)address, sizeof(*address)) == 0;
+    close(fd);
+    return live;
+}
+
+// Create the listening socket
+int init_action_channel() {
+    g_mutex_init(&channel_lock);
+    backlog = g_queue_new();
+    next_sequence = 1;
+
+    // Private per-user location; the session runtime dir when there is one
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && strlen(runtime_dir) > 0) {
+        socket_dir = g_strdup_printf("%s/instant_translator", runtime_dir);
+    } else {
+        socket_dir = g_strdup_printf("%s/instant_translator-%d", g_get_tmp_dir(), (int)getuid());
+    }
+    socket_path = g_build_filename(socket_dir, "actions.sock", NULL);
+
+    if (!make_private_dir(socket_dir)) {
+        cleanup_action_channel();
+        return STATUS_ERROR_INIT;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("❌ Action channel path too long: %s\n", socket_path);
+        cleanup_action_channel();
+        return STATUS_ERROR_INIT;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        cleanup_action_channel();
+        return STATUS_ERROR_INIT;
+    }
+
+    // A socket left by a previous run would make bind fail. One that still
+    // accepts connections belongs to a running instance and stays.
+    struct stat existing;
+    if (lstat(socket_path, &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode) || socket_is_live(&address)) {
+            printf("❌ %s is in use by another instance\n", socket_path);
+            close(listen_fd);
+            listen_fd = -1;  // Keeps cleanup from removing their socket
+            cleanup_action_channel();
+            return STATUS_ERROR_INIT;
+        }
+        unlink(socket_path);
+    }
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(listen_fd, 4) < 0) {
+        printf("❌ Failed to listen on %s: %s\n", socket_path, strerror(errno));
+        close(listen_fd);
+        listen_fd = -1;  // The path may not be ours
+        cleanup_action_channel();
+        return STATUS_ERROR_INIT;
+    }
+
+    listen_source = g_unix_fd_add(listen_fd, G_IO_IN, on_listen_ready, NULL);
+
+    printf("✅ Action channel listening on %s\n", socket_path);
+    return STATUS_SUCCESS;
+}
+
+// Close every connection and remove the socket file
+void cleanup_action_channel() {
+    g_mutex_lock(&channel_lock);
+    while (clients) {
+        close_client_locked((ActionClient*)clients->data);
+    }
+
+    if (listen_source) {
+        g_source_remove(listen_source);
+        listen_source = 0;
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(socket_path);
+    }
+    if (socket_path) {
+        g_free(socket_path);
+        socket_path = NULL;
+    }
+    if (socket_dir) {
+        rmdir(socket_dir);  // Only succeeds once it is empty
+        g_free(socket_dir);
+        socket_dir = NULL;
+    }
+
+    if (backlog) {
+        while (!g_queue_is_empty(backlog)) {
+            g_byte_array_free((GByteArray*)g_queue_pop_head(backlog), TRUE);
+        }
+        g_queue_free(backlog);
+        backlog = NULL;
+    }
+    g_mutex_unlock(&channel_lock);
+}
+
+const char* action_channel_path() {
+    return socket_path;
+}
+
+// Send one menu action to every connected client
+int action_channel_publish(const char* menu_id, SelectionData* selection) {
+    if (!menu_id || !selection) {
+        return STATUS_ERROR_INIT;
+    }
+
+    g_mutex_lock(&channel_lock);
+    if (listen_fd < 0) {
+        g_mutex_unlock(&channel_lock);
+        return STATUS_ERROR_INIT;
+    }
+
+    GByteArray* frame = g_byte_array_new();
+    put_u32(frame, 0);  // Length, patched below
+    put_u16(frame, ACTION_FRAME_MENU_ACTION);
+    put_u16(frame, 0);
+    put_u32(frame, next_sequence++);
+    put_bytes(frame, menu_id);
+    put_bytes(frame, selection->text);
+    put_u32(frame, (guint32)selection->x);
+    put_u32(frame, (guint32)selection->y);
+
+    guint32 length = GUINT32_TO_LE(frame->len - sizeof(guint32));
+    memcpy(frame->data, &length, sizeof(length));
+
+    if (!clients) {
+        // Keep it for the first reader; drop the oldest if nobody ever comes
+        if (g_queue_get_length(backlog) >= ACTION_CHANNEL_MAX_QUEUED) {
+            g_byte_array_free((GByteArray*)g_queue_pop_head(backlog), TRUE);
+        }
+        g_queue_push_tail(backlog, frame);
+        g_mutex_unlock(&channel_lock);
+        return STATUS_SUCCESS;
+    }
+
+    GList* node = clients;
+    while (node) {
+        ActionClient* client = (ActionClient*)node->data;
+        node = node->next;  // flush may close and unlink the client
+        g_byte_array_append(client->pending, frame->data, frame->len);
+        flush_client_locked(client);
+    }
+    g_byte_array_free(frame, TRUE);
+    g_mutex_unlock(&channel_lock);
+    return STATUS_SUCCESS;
+}
@@ -0,0 +1,42 @@
+#ifndef ACTION_CHANNEL_H
+#define ACTION_CHANNEL_H
+
+#include "../include/instant_translator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Menu actions are streamed to the Flutter side over a Unix stream socket
+// (see get_action_channel_path). Every frame is little-endian:
+//
+//   u32 length       bytes after this field
+//   u16 type         ACTION_FRAME_MENU_ACTION
+//   u16 reserved     0
+//   u32 sequence     starts at 1, +1 per frame; a gap means frames were dropped
+//   u32 id_length    followed by the menu item id (UTF-8, no terminator)
+//   u32 text_length  followed by the selected text (UTF-8, no terminator)
+//   i32 x, i32 y     selection coordinates
+//
+// Frames published while no client is connected are queued (up to
+// ACTION_CHANNEL_MAX_QUEUED) and delivered to the first client.
+#define ACTION_FRAME_MENU_ACTION 1
+#define ACTION_CHANNEL_MAX_QUEUED 256
+
+// Create the listening socket and serve it from the GTK main loop
+int init_action_channel();
+
+// Close every connection and remove the socket file
+void cleanup_action_channel();
+
+// Socket path clients connect to (owned by the channel)
+const char* action_channel_path();
+
+// Send one menu action to every connected client (GTK main thread)
+int action_channel_publish(const char* menu_id, SelectionData* selection);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACTION_CHANNEL_H
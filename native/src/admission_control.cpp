@@ -0,0 +1,591 @@
+#include "admission_control.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef enum {
+    TICKET_QUEUED,
+    TICKET_GRANTED,
+    TICKET_REFUSED
+} TicketState;
+
+struct AdmissionTicket {
+    char* operation;
+    size_t bytes;
+    int priority;
+    AdmissionCallback callback;
+    AdmissionCallback preempt;  // NULL unless the call can be cut short
+    void* user_data;
+    TicketState state;
+    GQueue* queue;          // Queue holding it while TICKET_QUEUED
+    int refusal;            // Status handed to the callback when refused
+    gboolean preempted;
+    gint64 queued_at;
+    gint64 deadline;        // Refused if still queued by then
+    gint64 granted_at;
+};
+
+// A callback to run once admission_lock is released. The ticket itself
+// may be gone by then: its owner can end it as soon as it leaves the queue.
+typedef struct {
+    AdmissionCallback callback;
+    void* user_data;
+    int status;
+} Decision;
+
+typedef struct {
+    long admitted;
+    gint64 total_wait_us;
+    gint64 max_wait_us;
+    long preempted;
+} ClassCounters;
+
+typedef struct {
+    double rate;            // Tokens per second, 0 for unlimited
+    double burst;
+    double tokens;
+    gint64 refilled_at;
+    gboolean custom;        // Set by admission_set_rate, not the default
+} TokenBucket;
+
+// State guarded by admission_lock
+static GMutex admission_lock;
+static GCond admission_cond;
+static GThread* admission_thread = NULL;
+static gboolean admission_running = FALSE;
+static GQueue waiting[PROCESSING_PRIORITY_COUNT];  // Per class, oldest first (zeroed = empty)
+static GQueue evicted = G_QUEUE_INIT;  // Out of `waiting`, refusal pending
+static GQueue granted = G_QUEUE_INIT;  // Holding a slot
+static int preempting = 0;              // Preempted tickets not yet released
+static GHashTable* buckets = NULL;      // operation -> TokenBucket*
+static double default_rate = ADMISSION_DEFAULT_RATE;
+static double default_burst = ADMISSION_DEFAULT_BURST;
+static double limit = ADMISSION_INITIAL_LIMIT;
+static int max_limit = ADMISSION_MAX_LIMIT;
+static int max_queue = ADMISSION_DEFAULT_QUEUE;
+static int in_flight = 0;
+static gint64 baseline_us = 0;          // Per KiB, 0 until the first sample
+static gint64 last_decrease_at = 0;
+static long admitted_count = 0;
+static long rejected_count = 0;
+static long decrease_count = 0;
+static gint64 total_wait_us = 0;
+static ClassCounters class_counters[PROCESSING_PRIORITY_COUNT];
+
+static TokenBucket* get_bucket_locked(const char* operation) {
+    TokenBucket* bucket = (TokenBucket*)g_hash_table_lookup(buckets, operation);
+    if (!bucket) {
+        bucket = (TokenBucket*)calloc(1, sizeof(TokenBucket));
+        bucket->rate = default_rate;
+        bucket->burst = default_burst;
+        bucket->tokens = default_burst;
+        bucket->refilled_at = g_get_monotonic_time();
+        g_hash_table_insert(buckets, g_strdup(operation), bucket);
+    }
+    return bucket;
+}
+
+// Whether the bucket has a token now; if not, `*wait_us` until it will
+static gboolean bucket_ready(TokenBucket* bucket, gint64 now, gint64* wait_us) {
+    if (bucket->rate <= 0) {
+        return TRUE;
+    }
+    bucket->tokens = MIN(bucket->burst, bucket->tokens + (now - bucket->refilled_at) * bucket->rate / G_USEC_PER_SEC);
+    bucket->refilled_at = now;
+    if (bucket->tokens >= 1) {
+        return TRUE;
+    }
+    *wait_us = (gint64)((1 - bucket->tokens) * G_USEC_PER_SEC / bucket->rate) + 1;
+    return FALSE;
+}
+
+static gboolean slot_free_locked() {
+    return in_flight < (int)limit;
+}
+
+static int queued_count_locked() {
+    int count = 0;
+    for (int i = 0; i < PROCESSING_PRIORITY_COUNT; i++) {
+        count += (int)waiting[i].length;
+    }
+    return count;
+}
+
+static void grant_locked(AdmissionTicket* ticket, TokenBucket* bucket, gint64 now) {
+    gint64 waited = now - ticket->queued_at;
+    ticket->state = TICKET_GRANTED;
+    ticket->granted_at = now;
+    if (bucket->rate > 0) {
+        bucket->tokens -= 1;
+    }
+    g_queue_push_tail(&granted, ticket);
+    in_flight++;
+    admitted_count++;
+    total_wait_us += waited;
+
+    ClassCounters* counters = &class_counters[ticket->priority];
+    counters->admitted++;
+    counters->total_wait_us += waited;
+    counters->max_wait_us = MAX(counters->max_wait_us, waited);
+}
+
+// Move a queued ticket to `evicted`, to be refused with `refusal`
+static void evict_locked(AdmissionTicket* ticket, int refusal) {
+    g_queue_remove(ticket->queue, ticket);
+    ticket->refusal = refusal;
+    ticket->queue = &evicted;
+    g_queue_push_tail(&evicted, ticket);
+    g_cond_signal(&admission_cond);
+}
+
+// Fold one finished call into the limit
+static void record_sample_locked(AdmissionTicket* ticket, int status, gint64 now) {
+    gboolean failed = status == STATUS_TIMEOUT || status == STATUS_ERROR_DBUS;
+    gint64 kib = MAX(1, (gint64)((ticket->bytes + 1023) / 1024));
+    gint64 latency_us = (now - ticket->granted_at) / kib;
+
+    if (status == STATUS_SUCCESS) {
+        if (baseline_us == 0 || latency_us < baseline_us) {
+            baseline_us = latency_us;
+        } else {
+            baseline_us += (latency_us - baseline_us) / 64;
+        }
+    }
+
+    gboolean slow = baseline_us > 0 && latency_us > baseline_us * ADMISSION_LATENCY_TOLERANCE;
+    if (failed || (status == STATUS_SUCCESS && slow)) {
+        // Calls started before the last cut saw the old limit; one cut per round trip
+        if (ticket->granted_at >= last_decrease_at) {
+            limit = MAX(ADMISSION_MIN_LIMIT, limit / 2);
+            last_decrease_at = now;
+            decrease_count++;
+            printf("🚦 Backend %s, concurrency limit cut to %d\n", failed ? "failing" : "slowing down", (int)limit);
+        }
+    } else if (status == STATUS_SUCCESS && (in_flight + 1 >= (int)limit || queued_count_locked() > 0)) {
+        // Only grow a limit that is actually being used
+        limit = MIN(max_limit, limit + 1 / limit);
+    }
+}
+
+static GList* add_decision(GList* decided, AdmissionCallback callback, void* user_data, int status) {
+    Decision* decision = (Decision*)malloc(sizeof(Decision));
+    decision->callback = callback;
+    decision->user_data = user_data;
+    decision->status = status;
+    return g_list_prepend(decided, decision);
+}
+
+// Take a ticket out of its queue with its outcome decided. Caller holds
+// admission_lock.
+static GList* decide_locked(GList* decided, AdmissionTicket* ticket) {
+    g_queue_remove(ticket->queue, ticket);
+    ticket->queue = NULL;
+    return add_decision(decided, ticket->callback, ticket->user_data,
+                        ticket->state == TICKET_GRANTED ? STATUS_SUCCESS : ticket->refusal);
+}
+
+// Ask a granted ticket to give its slot up. Caller holds admission_lock.
+static GList* preempt_locked(GList* decided, AdmissionTicket* ticket) {
+    ticket->preempted = TRUE;
+    preempting++;
+    class_counters[ticket->priority].preempted++;
+    printf("🚦 Preempting a %s call of priority %d\n", ticket->operation, ticket->priority);
+    return add_decision(decided, ticket->preempt, ticket->user_data, STATUS_CANCELLED);
+}
+
+// The granted ticket of a class below `priority` that is cheapest to cut
+// short: lowest class, then most recently granted
+static AdmissionTicket* find_victim_locked(int priority) {
+    AdmissionTicket* victim = NULL;
+    for (GList* link = granted.head; link; link = link->next) {
+        AdmissionTicket* ticket = (AdmissionTicket*)link->data;
+        if (ticket->priority > priority && ticket->preempt && !ticket->preempted &&
+            (!victim || ticket->priority >= victim->priority)) {
+            victim = ticket;
+        }
+    }
+    return victim;
+}
+
+static void run_decisions(GList* decided) {
+    decided = g_list_reverse(decided);
+    for (GList* l = decided; l; l = l->next) {
+        Decision* decision = (Decision*)l->data;
+        decision->callback(decision->status, decision->user_data);
+    }
+    g_list_free_full(decided, free);
+}
+
+// Grant queued tickets in order and refuse expired ones (admission thread)
+static gpointer admission_thread_func(gpointer data) {
+    g_mutex_lock(&admission_lock);
+    while (admission_running) {
+        gint64 now = g_get_monotonic_time();
+        gint64 wake_at = G_MAXINT64;
+        GList* decided = NULL;
+
+        while (!g_queue_is_empty(&evicted)) {
+            AdmissionTicket* ticket = (AdmissionTicket*)g_queue_peek_head(&evicted);
+            ticket->state = TICKET_REFUSED;
+            if (ticket->refusal == STATUS_ERROR_REJECTED) {
+                rejected_count++;
+            }
+            decided = decide_locked(decided, ticket);
+        }
+
+        // Most urgent class first
+        int starved = PROCESSING_PRIORITY_COUNT;  // Best class left waiting for a slot
+        for (int priority = 0; priority < PROCESSING_PRIORITY_COUNT; priority++) {
+            GList* link = waiting[priority].head;
+            while (link) {
+                GList* next = link->next;
+                AdmissionTicket* ticket = (AdmissionTicket*)link->data;
+                gint64 wait_us = 0;
+
+                if (ticket->deadline <= now) {
+                    ticket->state = TICKET_REFUSED;
+                    ticket->refusal = STATUS_ERROR_REJECTED;
+                    rejected_count++;
+                    printf("🚦 %s waited %ldms for the backend, rejected\n", ticket->operation,
+                           (long)((now - ticket->queued_at) / 1000));
+                } else if (slot_free_locked() &&
+                           bucket_ready(get_bucket_locked(ticket->operation), now, &wait_us)) {
+                    grant_locked(ticket, get_bucket_locked(ticket->operation), now);
+                } else {
+                    if (!slot_free_locked()) {
+                        starved = MIN(starved, priority);
+                    }
+                    wake_at = MIN(wake_at, ticket->deadline);
+                    if (wait_us > 0) {
+                        wake_at = MIN(wake_at, now + wait_us);
+                    }
+                    link = next;
+                    continue;
+                }
+
+                decided = decide_locked(decided, ticket);
+                link = next;
+            }
+        }
+
+        // One preemption at a time: its release lets the next waiter in
+        if (starved < PROCESSING_PRIORITY_COUNT && preempting == 0) {
+            AdmissionTicket* victim = find_victim_locked(starved);
+            if (victim) {
+                decided = preempt_locked(decided, victim);
+            }
+        }
+
+        if (decided) {
+            g_mutex_unlock(&admission_lock);
+            run_decisions(decided);
+            g_mutex_lock(&admission_lock);
+            continue;
+        }
+
+        if (wake_at == G_MAXINT64) {
+            g_cond_wait(&admission_cond, &admission_lock);
+        } else {
+            g_cond_wait_until(&admission_cond, &admission_lock, wake_at);
+        }
+    }
+    g_mutex_unlock(&admission_lock);
+    return NULL;
+}
+
+static void free_ticket(AdmissionTicket* ticket) {
+    free(ticket->operation);
+    free(ticket);
+}
+
+int init_admission_control() {
+    g_mutex_lock(&admission_lock);
+    if (!buckets) {
+        buckets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free);
+    }
+    admission_running = TRUE;
+    admission_thread = g_thread_new("admission", admission_thread_func, NULL);
+    g_mutex_unlock(&admission_lock);
+
+    printf("✅ Admission control ready (limit %d, queue %d)\n", (int)limit, max_queue);
+    return STATUS_SUCCESS;
+}
+
+void cleanup_admission_control() {
+    g_mutex_lock(&admission_lock);
+    GThread* thread = admission_thread;
+    admission_thread = NULL;
+    admission_running = FALSE;
+    g_cond_broadcast(&admission_cond);
+    g_mutex_unlock(&admission_lock);
+    if (thread) {
+        g_thread_join(thread);
+    }
+
+    // Nobody grants them any more
+    g_mutex_lock(&admission_lock);
+    GList* refused = NULL;
+    for (int i = 0; i < PROCESSING_PRIORITY_COUNT; i++) {
+        while (!g_queue_is_empty(&waiting[i])) {
+            evict_locked((AdmissionTicket*)g_queue_peek_head(&waiting[i]), STATUS_CANCELLED);
+        }
+    }
+    while (!g_queue_is_empty(&evicted)) {
+        AdmissionTicket* ticket = (AdmissionTicket*)g_queue_peek_head(&evicted);
+        ticket->state = TICKET_REFUSED;
+        refused = decide_locked(refused, ticket);
+    }
+    g_mutex_unlock(&admission_lock);
+    run_decisions(refused);
+}
+
+int admission_request(const char* operation, size_t bytes, int priority, int max_wait_ms,
+                      AdmissionCallback callback, AdmissionCallback preempt, void* user_data,
+                      AdmissionTicket** ticket) {
+    g_mutex_lock(&admission_lock);
+    if (!admission_running) {
+        // Not gating (yet or any more)
+        g_mutex_unlock(&admission_lock);
+        *ticket = NULL;
+        return STATUS_SUCCESS;
+    }
+
+    AdmissionTicket* entry = (AdmissionTicket*)calloc(1, sizeof(AdmissionTicket));
+    entry->operation = strdup(operation ? operation : "");
+    entry->bytes = bytes;
+    entry->priority = CLAMP(priority, 0, PROCESSING_PRIORITY_COUNT - 1);
+    entry->callback = callback;
+    entry->preempt = preempt;
+    entry->user_data = user_data;
+    entry->state = TICKET_QUEUED;
+    entry->queued_at = g_get_monotonic_time();
+
+    // Straight through when nobody is waiting ahead and there is room
+    gint64 wait_us = 0;
+    TokenBucket* bucket = get_bucket_locked(entry->operation);
+    gboolean ahead = FALSE;
+    for (int i = 0; i <= entry->priority; i++) {
+        ahead = ahead || !g_queue_is_empty(&waiting[i]);
+    }
+    if (!ahead && slot_free_locked() && bucket_ready(bucket, entry->queued_at, &wait_us)) {
+        grant_locked(entry, bucket, entry->queued_at);
+        *ticket = entry;
+        g_mutex_unlock(&admission_lock);
+        return STATUS_SUCCESS;
+    }
+
+    if (queued_count_locked() >= max_queue) {
+        // Full: push out the newest ticket of the lowest class below this one
+        int victim_class = PROCESSING_PRIORITY_COUNT - 1;
+        while (victim_class > entry->priority && g_queue_is_empty(&waiting[victim_class])) {
+            victim_class--;
+        }
+        if (victim_class == entry->priority) {
+            rejected_count++;
+            g_mutex_unlock(&admission_lock);
+            printf("🚦 Backend queue full, %s rejected\n", entry->operation);
+            free_ticket(entry);
+            *ticket = NULL;
+            return STATUS_ERROR_REJECTED;
+        }
+        evict_locked((AdmissionTicket*)g_queue_peek_tail(&waiting[victim_class]), STATUS_ERROR_REJECTED);
+    }
+
+    int wait_ms = max_wait_ms > 0 ? MIN(max_wait_ms, ADMISSION_MAX_WAIT_MS) : ADMISSION_MAX_WAIT_MS;
+    entry->deadline = entry->queued_at + (gint64)wait_ms * 1000;
+    entry->queue = &waiting[entry->priority];
+    *ticket = entry;
+    g_queue_push_tail(entry->queue, entry);
+    g_cond_signal(&admission_cond);
+    g_mutex_unlock(&admission_lock);
+    return ADMISSION_QUEUED;
+}
+
+// Outcome of a ticket awaited by a blocking caller
+typedef struct {
+    GMutex lock;
+    GCond cond;
+    gboolean done;
+    int status;
+} AdmissionWaiter;
+
+static void on_waiter_decided(int status, void* data) {
+    AdmissionWaiter* waiter = (AdmissionWaiter*)data;
+    g_mutex_lock(&waiter->lock);
+    waiter->status = status;
+    waiter->done = TRUE;
+    g_cond_signal(&waiter->cond);
+    g_mutex_unlock(&waiter->lock);
+}
+
+int admission_acquire(const char* operation, size_t bytes, int priority, int max_wait_ms,
+                      AdmissionTicket** ticket) {
+    AdmissionWaiter waiter;
+    g_mutex_init(&waiter.lock);
+    g_cond_init(&waiter.cond);
+    waiter.done = FALSE;
+    waiter.status = STATUS_ERROR_REJECTED;
+
+    int status = admission_request(operation, bytes, priority, max_wait_ms, on_waiter_decided, NULL,
+                                   &waiter, ticket);
+    if (status == ADMISSION_QUEUED) {
+        g_mutex_lock(&waiter.lock);
+        while (!waiter.done) {
+            g_cond_wait(&waiter.cond, &waiter.lock);
+        }
+        status = waiter.status;
+        g_mutex_unlock(&waiter.lock);
+
+        if (status != STATUS_SUCCESS) {
+            admission_release(*ticket, status);
+            *ticket = NULL;
+        }
+    }
+
+    g_cond_clear(&waiter.cond);
+    g_mutex_clear(&waiter.lock);
+    return status;
+}
+
+int admission_withdraw(AdmissionTicket* ticket) {
+    if (!ticket) {
+        return 0;
+    }
+
+    g_mutex_lock(&admission_lock);
+    gboolean queued = ticket->state == TICKET_QUEUED;
+    if (queued) {
+        g_queue_remove(ticket->queue, ticket);
+    }
+    g_mutex_unlock(&admission_lock);
+
+    if (queued) {
+        free_ticket(ticket);
+    }
+    return queued ? 1 : 0;
+}
+
+void admission_release(AdmissionTicket* ticket, int status) {
+    if (!ticket) {
+        return;
+    }
+
+    g_mutex_lock(&admission_lock);
+    if (ticket->state == TICKET_GRANTED) {
+        g_queue_remove(&granted, ticket);
+        in_flight--;
+        if (ticket->preempted) {
+            preempting--;
+        }
+        if (status != STATUS_CANCELLED && !ticket->preempted) {
+            record_sample_locked(ticket, status, g_get_monotonic_time());
+        }
+        g_cond_signal(&admission_cond);  // A slot opened up
+    }
+    g_mutex_unlock(&admission_lock);
+    free_ticket(ticket);
+}
+
+void admission_promote(AdmissionTicket* ticket, int priority) {
+    if (!ticket) {
+        return;
+    }
+
+    g_mutex_lock(&admission_lock);
+    if (priority >= 0 && priority < ticket->priority) {
+        ticket->priority = priority;
+        if (ticket->state == TICKET_QUEUED && ticket->queue != &evicted) {
+            g_queue_remove(ticket->queue, ticket);
+            ticket->queue = &waiting[priority];
+            g_queue_push_tail(ticket->queue, ticket);
+            g_cond_signal(&admission_cond);
+        }
+    }
+    g_mutex_unlock(&admission_lock);
+}
+
+void admission_cancel_class(int priority) {
+    if (priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return;
+    }
+
+    g_mutex_lock(&admission_lock);
+    while (!g_queue_is_empty(&waiting[priority])) {
+        evict_locked((AdmissionTicket*)g_queue_peek_head(&waiting[priority]), STATUS_CANCELLED);
+    }
+    GList* preempted = NULL;
+    for (GList* link = granted.head; link; link = link->next) {
+        AdmissionTicket* ticket = (AdmissionTicket*)link->data;
+        if (ticket->priority == priority && ticket->preempt && !ticket->preempted) {
+            preempted = preempt_locked(preempted, ticket);
+        }
+    }
+    g_mutex_unlock(&admission_lock);
+    run_decisions(preempted);
+}
+
+void admission_set_limits(int max_concurrency, int queue_length) {
+    g_mutex_lock(&admission_lock);
+    max_limit = MAX(ADMISSION_MIN_LIMIT, max_concurrency);
+    limit = MIN(limit, max_limit);
+    max_queue = MAX(0, queue_length);
+    g_cond_signal(&admission_cond);
+    g_mutex_unlock(&admission_lock);
+}
+
+void admission_set_rate(const char* operation, double per_second, int burst) {
+    double rate = MAX(0, per_second);
+    double depth = MAX(1, burst);
+
+    g_mutex_lock(&admission_lock);
+    if (!buckets) {
+        buckets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free);
+    }
+    if (operation) {
+        TokenBucket* bucket = get_bucket_locked(operation);
+        bucket->rate = rate;
+        bucket->burst = depth;
+        bucket->tokens = MIN(bucket->tokens, depth);
+        bucket->custom = TRUE;
+    } else {
+        default_rate = rate;
+        default_burst = depth;
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, buckets);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            TokenBucket* bucket = (TokenBucket*)value;
+            if (!bucket->custom) {
+                bucket->rate = rate;
+                bucket->burst = depth;
+                bucket->tokens = MIN(bucket->tokens, depth);
+            }
+        }
+    }
+    g_cond_signal(&admission_cond);
+    g_mutex_unlock(&admission_lock);
+}
+
+void admission_get_stats(AdmissionStats* stats) {
+    g_mutex_lock(&admission_lock);
+    stats->limit = (int)limit;
+    stats->in_flight = in_flight;
+    stats->queued = queued_count_locked();
+    stats->admitted = admitted_count;
+    stats->rejected = rejected_count;
+    stats->limit_decreases = decrease_count;
+    stats->mean_wait_us = admitted_count > 0 ? (long)(total_wait_us / admitted_count) : 0;
+    stats->latency_baseline_us = (long)baseline_us;
+    g_mutex_unlock(&admission_lock);
+}
+
+void admission_get_class_stats(int priority, SchedulerClassStats* stats) {
+    g_mutex_lock(&admission_lock);
+    ClassCounters* counters = &class_counters[CLAMP(priority, 0, PROCESSING_PRIORITY_COUNT - 1)];
+    stats->admitted = counters->admitted;
+    stats->mean_admission_wait_us = counters->admitted > 0 ? (long)(counters->total_wait_us / counters->admitted) : 0;
+    stats->max_admission_wait_us = (long)counters->max_wait_us;
+    stats->preempted = counters->preempted;
+    g_mutex_unlock(&admission_lock);
+}
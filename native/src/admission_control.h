@@ -0,0 +1,101 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include "../include/instant_translator.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gate in front of the processing backend. Every backend call holds a
+// ticket while it runs. A ticket is granted while fewer calls than the
+// concurrency limit are in flight and the operation's token bucket has a
+// token; otherwise the caller waits in a bounded queue, served by
+// ProcessingPriority class and FIFO within a class. A full queue makes room
+// for a ticket by rejecting the newest one of a lower class.
+//
+// While a ticket waits for a slot, one lower-class call granted with a
+// preempt callback is told to give its slot up (streaming speculation, say).
+//
+// The limit is AIMD: it grows by 1/limit per successful call while the
+// limit is in use, and halves (at most once per round trip) on a timeout,
+// a D-Bus error, or latency over ADMISSION_LATENCY_TOLERANCE times the
+// baseline. Latency is measured per KiB of text, so long texts don't read
+// as congestion. The baseline is the best recent value, drifting up slowly.
+#define ADMISSION_INITIAL_LIMIT 4
+#define ADMISSION_MIN_LIMIT 1
+#define ADMISSION_MAX_LIMIT 32
+#define ADMISSION_LATENCY_TOLERANCE 2.0
+#define ADMISSION_DEFAULT_QUEUE 64
+#define ADMISSION_MAX_WAIT_MS 5000          // Longer waits are rejected
+#define ADMISSION_DEFAULT_RATE 10.0         // Calls per second per operation
+#define ADMISSION_DEFAULT_BURST 20
+
+// admission_request: the ticket is queued and its callback will tell
+#define ADMISSION_QUEUED 1
+
+typedef struct AdmissionTicket AdmissionTicket;
+
+// Runs once for a queued ticket, on the admission thread: STATUS_SUCCESS
+// when granted, STATUS_ERROR_REJECTED when it waited too long or was pushed
+// out of the queue, or STATUS_CANCELLED when its class was cancelled or at
+// cleanup. As a preempt callback it runs at most once, with
+// STATUS_CANCELLED, and the call should then end soon.
+typedef void (*AdmissionCallback)(int status, void* user_data);
+
+// Start the thread that grants queued tickets
+int init_admission_control();
+
+// Refuse every queued ticket and stop granting; later callers pass freely
+void cleanup_admission_control();
+
+// Ask for a backend slot for `bytes` of text under `operation` at
+// `priority`, waiting at most `max_wait_ms` (capped at
+// ADMISSION_MAX_WAIT_MS). Returns STATUS_SUCCESS when granted right away,
+// ADMISSION_QUEUED when `callback` will tell, or STATUS_ERROR_REJECTED when
+// the queue is full. Unless rejected, `*ticket` is set before any callback
+// can run. A NULL `preempt` means the call can't be cut short.
+int admission_request(const char* operation, size_t bytes, int priority, int max_wait_ms,
+                      AdmissionCallback callback, AdmissionCallback preempt, void* user_data,
+                      AdmissionTicket** ticket);
+
+// Blocking admission_request: STATUS_SUCCESS with a ticket, or the refusal
+// status without one
+int admission_acquire(const char* operation, size_t bytes, int priority, int max_wait_ms,
+                      AdmissionTicket** ticket);
+
+// Raise a ticket to a more urgent class (a user now waits on a
+// speculation, say); lower or equal priorities are ignored
+void admission_promote(AdmissionTicket* ticket, int priority);
+
+// Refuse every queued ticket of `priority` with STATUS_CANCELLED and preempt
+// its granted ones
+void admission_cancel_class(int priority);
+
+// Take back a ticket that is still queued: 1 if it was (its callback won't
+// run and the ticket is gone), 0 if its callback ran or is running, in
+// which case it must still be ended with admission_release
+int admission_withdraw(AdmissionTicket* ticket);
+
+// End a granted or refused ticket. `status` is the outcome of the call,
+// which feeds the limit unless it is STATUS_CANCELLED. NULL is ignored.
+void admission_release(AdmissionTicket* ticket, int status);
+
+// Concurrency ceiling (the AIMD limit stays below it) and queue length
+void admission_set_limits(int max_concurrency, int queue_length);
+
+// Token bucket for one operation, or the default for operations without
+// their own when `operation` is NULL; 0 `per_second` means unlimited
+void admission_set_rate(const char* operation, double per_second, int burst);
+
+void admission_get_stats(AdmissionStats* stats);
+
+// Fill the admission fields of one class's SchedulerClassStats
+void admission_get_class_stats(int priority, SchedulerClassStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADMISSION_CONTROL_H
@@ -0,0 +1,250 @@
+#include "chunked_processing.h"
+#include "dart_port_bridge.h"
+#include "processing_scheduler.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+static gint chunk_budget = CHUNK_DEFAULT_BYTES;   // 0 while chunking is off
+static gint chunk_parallel = CHUNK_DEFAULT_PARALLEL;
+static GMutex callback_lock;
+static ChunkProgressCallback progress_callback = NULL;  // Guarded by callback_lock
+
+// One chunked request, shared by the pool's workers
+typedef struct {
+    const char* text;
+    const char* operation;
+    ChunkProcessor processor;
+    const TextSpan* chunks;
+    char** results;         // results[i] answers chunks[i]
+    int total;
+    int priority;           // The caller's, passed on to the workers
+    gint completed;
+    gint status;            // First failure, STATUS_SUCCESS until then
+} ChunkJob;
+
+void chunked_processing_configure(int chunk_bytes, int max_parallel) {
+    g_atomic_int_set(&chunk_budget, chunk_bytes > 0 ? chunk_bytes : 0);
+    g_atomic_int_set(&chunk_parallel, CLAMP(max_parallel, 1, CHUNK_MAX_PARALLEL));
+}
+
+void chunked_processing_set_progress_callback(ChunkProgressCallback callback) {
+    g_mutex_lock(&callback_lock);
+    progress_callback = callback;
+    g_mutex_unlock(&callback_lock);
+}
+
+int chunked_processing_wanted(const char* text) {
+    int budget = g_atomic_int_get(&chunk_budget);
+    return budget > 0 && text && strlen(text) > (size_t)budget;
+}
+
+// Whitespace between sentences that ends a paragraph
+static gboolean is_paragraph_break(const char* gap, size_t length) {
+    int newlines = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (gap[i] == '\n' && ++newlines == 2) {
+            return TRUE;
+        }
+        if (i + 3 <= length && memcmp(gap + i, "\xE2\x80\xA9", 3) == 0) {
+            return TRUE;  // U+2029
+        }
+    }
+    return FALSE;
+}
+
+// Append `span`, cut into pieces of at most `budget` bytes if it is longer
+static void push_pieces(GArray* pieces, const char* text, TextSpan span, size_t budget) {
+    size_t start = span.start;
+    size_t end = span.start + span.length;
+
+    while (end - start > budget) {
+        size_t cut = start + budget;
+        size_t piece_end;
+        size_t resume;
+
+        // At the last whitespace that fits, else mid-word on a character start
+        size_t space = cut;
+        while (space > start && !g_ascii_isspace(text[space])) space--;
+        if (space > start) {
+            piece_end = space;
+            while (g_ascii_isspace(text[piece_end - 1])) piece_end--;
+            resume = space;
+            while (resume < end && g_ascii_isspace(text[resume])) resume++;
+        } else {
+            piece_end = cut;
+            while (piece_end > start && (text[piece_end] & 0xC0) == 0x80) piece_end--;
+            if (piece_end == start) piece_end = cut;
+            resume = piece_end;
+        }
+
+        TextSpan piece = {start, piece_end - start, resume - piece_end};
+        g_array_append_val(pieces, piece);
+        start = resume;
+    }
+
+    TextSpan last = {start, end - start, span.gap};
+    g_array_append_val(pieces, last);
+}
+
+int plan_chunks(const char* text, size_t budget, TextSpan** chunks, int* count) {
+    TextSpan* spans;
+    int span_count;
+    if (budget == 0 || !chunks || !count || segment_text(text, &spans, &span_count) != STATUS_SUCCESS) {
+        return STATUS_ERROR_INIT;
+    }
+
+    GArray* pieces = g_array_new(FALSE, FALSE, sizeof(TextSpan));
+    for (int i = 0; i < span_count; i++) {
+        push_pieces(pieces, text, spans[i], budget);
+    }
+    free(spans);
+
+    // Greedily pack pieces, backing off to the last paragraph break
+    const TextSpan* piece = (const TextSpan*)pieces->data;
+    int n = (int)pieces->len;
+    GArray* packed = g_array_new(FALSE, FALSE, sizeof(TextSpan));
+    int first = 0;
+    while (first < n) {
+        size_t base = piece[first].start;
+        int last = first;
+        int paragraph_end = -1;
+        while (last + 1 < n && piece[last + 1].start + piece[last + 1].length - base <= budget) {
+            if (is_paragraph_break(text + piece[last].start + piece[last].length, piece[last].gap)) {
+                paragraph_end = last;
+            }
+            last++;
+        }
+        if (last + 1 < n && paragraph_end >= 0 &&
+            piece[paragraph_end].start + piece[paragraph_end].length - base >= budget / 2) {
+            last = paragraph_end;
+        }
+
+        TextSpan chunk = {base, piece[last].start + piece[last].length - base, piece[last].gap};
+        g_array_append_val(packed, chunk);
+        first = last + 1;
+    }
+    g_array_free(pieces, TRUE);
+
+    *count = (int)packed->len;
+    *chunks = (TextSpan*)malloc(sizeof(TextSpan) * (packed->len + 1));
+    if (packed->len > 0) {
+        memcpy(*chunks, packed->data, sizeof(TextSpan) * packed->len);
+    }
+    g_array_free(packed, TRUE);
+    return STATUS_SUCCESS;
+}
+
+static void report_progress(const char* operation, int completed, int total) {
+    g_mutex_lock(&callback_lock);
+    ChunkProgressCallback callback = progress_callback;
+    g_mutex_unlock(&callback_lock);
+    if (callback) {
+        callback(operation, completed, total);
+    } else {
+        dart_port_bridge_post_chunk_progress(operation, completed, total);
+    }
+}
+
+// Failures worth another try, a busy backend included; cancellation and
+// setup errors are final
+static gboolean is_retryable(int status) {
+    return status == STATUS_TIMEOUT || status == STATUS_ERROR_DBUS || status == STATUS_ERROR_REJECTED;
+}
+
+// Process one chunk, retrying it on its own (thread pool worker)
+static void run_chunk(gpointer data, gpointer user_data) {
+    ChunkJob* job = (ChunkJob*)user_data;
+    int index = GPOINTER_TO_INT(data) - 1;
+    const TextSpan* span = &job->chunks[index];
+
+    // Not worth starting once another chunk has failed for good
+    if (g_atomic_int_get(&job->status) != STATUS_SUCCESS) {
+        return;
+    }
+
+    scheduler_set_thread_priority(job->priority);
+    char* chunk = strndup(job->text + span->start, span->length);
+    int status;
+    for (int attempt = 1; ; attempt++) {
+        char* result = NULL;
+        status = job->processor(chunk, job->operation, &result);
+        if (status == STATUS_SUCCESS) {
+            job->results[index] = result ? result : strdup("");
+            break;
+        }
+        if (!is_retryable(status) || attempt >= CHUNK_MAX_ATTEMPTS ||
+            g_atomic_int_get(&job->status) != STATUS_SUCCESS) {
+            break;
+        }
+        printf("🔁 Chunk %d/%d failed (%d), retrying\n", index + 1, job->total, status);
+        g_usleep((gulong)CHUNK_RETRY_DELAY_MS * 1000 * attempt);
+    }
+    free(chunk);
+    scheduler_set_thread_priority(PRIORITY_INTERACTIVE);  // Pool threads are shared
+
+    if (status != STATUS_SUCCESS) {
+        printf("❌ Chunk %d/%d failed (%d)\n", index + 1, job->total, status);
+        g_atomic_int_compare_and_exchange(&job->status, STATUS_SUCCESS, status);
+        return;
+    }
+    report_progress(job->operation, g_atomic_int_add(&job->completed, 1) + 1, job->total);
+}
+
+int process_in_chunks(const char* text, const char* operation, ChunkProcessor processor, char** result) {
+    if (!text || !operation || !processor || !result) {
+        return STATUS_ERROR_INIT;
+    }
+
+    TextSpan* chunks;
+    int count;
+    int budget = g_atomic_int_get(&chunk_budget);
+    if (plan_chunks(text, budget > 0 ? budget : CHUNK_DEFAULT_BYTES, &chunks, &count) != STATUS_SUCCESS) {
+        return STATUS_ERROR_INIT;
+    }
+
+    int parallel = MIN(g_atomic_int_get(&chunk_parallel), MAX(count, 1));
+    printf("✂️  %s: %d chunks of up to %d bytes, %d at a time\n", operation, count, budget, parallel);
+    gint64 started_at = g_get_monotonic_time();
+
+    ChunkJob job;
+    job.text = text;
+    job.operation = operation;
+    job.processor = processor;
+    job.chunks = chunks;
+    job.results = (char**)calloc(count + 1, sizeof(char*));
+    job.total = count;
+    job.priority = scheduler_thread_priority();
+    job.completed = 0;
+    job.status = STATUS_SUCCESS;
+    report_progress(operation, 0, count);
+
+    // Queued in order, so earlier chunks start first; freeing the pool
+    // waits for every queued chunk
+    GThreadPool* pool = g_thread_pool_new(run_chunk, &job, parallel, FALSE, NULL);
+    for (int i = 0; i < count; i++) {
+        if (pool) {
+            g_thread_pool_push(pool, GINT_TO_POINTER(i + 1), NULL);
+        } else {
+            run_chunk(GINT_TO_POINTER(i + 1), &job);
+        }
+    }
+    if (pool) {
+        g_thread_pool_free(pool, FALSE, TRUE);
+    }
+
+    int status = job.status;
+    if (status == STATUS_SUCCESS) {
+        *result = join_segments(text, chunks, count, job.results);
+        printf("✂️  %s: %d chunks done in %ldms\n", operation, count,
+               (long)((g_get_monotonic_time() - started_at) / 1000));
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (job.results[i]) free(job.results[i]);
+    }
+    free(job.results);
+    free(chunks);
+    return status;
+}
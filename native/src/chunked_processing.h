@@ -0,0 +1,47 @@
+#ifndef CHUNKED_PROCESSING_H
+#define CHUNKED_PROCESSING_H
+
+#include "../include/instant_translator.h"
+#include "text_segmenter.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default chunk size (bytes), chunks in flight at once and tries per chunk
+#define CHUNK_DEFAULT_BYTES 4096
+#define CHUNK_DEFAULT_PARALLEL 4
+#define CHUNK_MAX_PARALLEL 16
+#define CHUNK_MAX_ATTEMPTS 3
+#define CHUNK_RETRY_DELAY_MS 250       // Times the attempt number
+
+// Processes one chunk; `*result` is only set on STATUS_SUCCESS
+typedef int (*ChunkProcessor)(const char* chunk, const char* operation, char** result);
+
+// Chunk size and parallelism; 0 `chunk_bytes` turns chunking off
+void chunked_processing_configure(int chunk_bytes, int max_parallel);
+
+void chunked_processing_set_progress_callback(ChunkProgressCallback callback);
+
+// 1 when `text` is long enough to be processed in chunks
+int chunked_processing_wanted(const char* text);
+
+// Cut `text` into spans of at most `budget` bytes, like segment_text but
+// packing whole sentences together. Paragraph breaks are preferred as cut
+// points when that leaves the chunk at least half full. A sentence longer
+// than `budget` is cut at its last whitespace that fits, or mid-word
+// (never inside a UTF-8 sequence). Free `*chunks` with free().
+int plan_chunks(const char* text, size_t budget, TextSpan** chunks, int* count);
+
+// Blocking. Process `text` chunk by chunk, up to the configured number at
+// once on a thread pool. A failed chunk is retried on its own; when it
+// still fails, chunks not yet started are skipped and its status returned.
+// Progress is reported after each chunk.
+int process_in_chunks(const char* text, const char* operation, ChunkProcessor processor, char** result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHUNKED_PROCESSING_H
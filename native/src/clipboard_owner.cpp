@@ -0,0 +1,542 @@
+#include "clipboard_owner.h"
+#include "clipboard_snapshot.h"
+#include "x11_reactor.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Reference-counted clipboard contents; INCR transfers keep their own ref.
+// Either plain text served under every text target, or a snapshot of
+// another owner's targets served back byte for byte.
+typedef struct {
+    gint refcount;
+    char* data;
+    size_t length;
+    ClipboardSnapshot* snapshot;
+} ClipboardContent;
+
+// In-progress INCR transfer to one requestor
+typedef struct {
+    Window requestor;
+    Atom property;
+    Atom type;
+    int format;
+    int entry;              // Snapshot entry, -1 for text
+    size_t length;
+    ClipboardContent* content;
+    size_t offset;
+    long saved_mask;        // Our previous event mask on the requestor window
+} IncrTransfer;
+
+// Owner window on the reactor connection (reactor thread only)
+static Display* display = NULL;
+static Window owner_window = None;
+static Atom clipboard_atom;
+static Atom targets_atom;
+static Atom timestamp_atom;
+static Atom utf8_string_atom;
+static Atom text_atom;
+static Atom text_plain_utf8_atom;
+static Atom text_plain_atom;
+static Atom incr_atom;
+static Atom stamp_atom;
+static Atom clipboard_manager_atom;
+static Time owner_time = CurrentTime;
+static size_t max_chunk_size = 0;
+static GList* incr_transfers = NULL;
+static Time stamp_time = CurrentTime;
+static gboolean owns_clipboard = FALSE;
+static gboolean restore_armed = FALSE;     // The paste keystroke has been sent
+static unsigned int restore_timer = 0;
+
+// State shared with callers, guarded by state_lock
+static GMutex state_lock;
+static ClipboardContent* current_content = NULL;
+static ClipboardContent* restore_content = NULL;
+
+static ClipboardContent* content_new_text(const char* text) {
+    ClipboardContent* content = (ClipboardContent*)calloc(1, sizeof(ClipboardContent));
+    content->refcount = 1;
+    content->length = strlen(text);
+    content->data = (char*)malloc(content->length + 1);
+    memcpy(content->data, text, content->length + 1);
+    return content;
+}
+
+static ClipboardContent* content_new_snapshot(ClipboardSnapshot* snapshot) {
+    ClipboardContent* content = (ClipboardContent*)calloc(1, sizeof(ClipboardContent));
+    content->refcount = 1;
+    content->snapshot = clipboard_snapshot_ref(snapshot);
+    return content;
+}
+
+static ClipboardContent* content_ref(ClipboardContent* content) {
+    if (content) g_atomic_int_inc(&content->refcount);
+    return content;
+}
+
+static void content_unref(ClipboardContent* content) {
+    if (content && g_atomic_int_dec_and_test(&content->refcount)) {
+        if (content->data) free(content->data);
+        clipboard_snapshot_unref(content->snapshot);
+        free(content);
+    }
+}
+
+static int stamp_arrived(void* user_data) {
+    return stamp_time != CurrentTime;
+}
+
+// Fetch a server timestamp by appending to a property on our window
+static Time get_server_time() {
+    unsigned char zero = 0;
+    stamp_time = CurrentTime;
+    XChangeProperty(display, owner_window, stamp_atom, XA_STRING, 8, PropModeAppend, &zero, 0);
+
+    x11_reactor_pump_until(stamp_arrived, NULL, SELECTION_OWNER_TIMEOUT_MS);
+    return stamp_time;
+}
+
+static gboolean is_text_target(Atom target) {
+    return target == utf8_string_atom || target == XA_STRING || target == text_atom ||
+           target == text_plain_utf8_atom || target == text_plain_atom;
+}
+
+// Bytes per stored item for a property format (32-bit items are longs)
+static size_t item_size(int format) {
+    switch (format) {
+        case 32: return sizeof(long);
+        case 16: return sizeof(short);
+        default: return 1;
+    }
+}
+
+// Resolve how `content` answers `target`; returns FALSE if it cannot
+static gboolean content_lookup(ClipboardContent* content, Atom target, int* entry,
+                               Atom* type, int* format, size_t* length) {
+    if (content->snapshot) {
+        *entry = clipboard_snapshot_find(content->snapshot, target);
+        if (*entry < 0) {
+            return FALSE;
+        }
+        clipboard_snapshot_describe(content->snapshot, *entry, type, format, length);
+        return TRUE;
+    }
+
+    if (!is_text_target(target)) {
+        return FALSE;
+    }
+    *entry = -1;
+    *type = target == text_atom ? utf8_string_atom : target;
+    *format = 8;
+    *length = content->length;
+    return TRUE;
+}
+
+// Copy payload bytes; snapshot payloads are only loaded here
+static size_t content_read(ClipboardContent* content, int entry, size_t offset,
+                           char* out, size_t length) {
+    if (content->snapshot) {
+        return clipboard_snapshot_read(content->snapshot, entry, offset, out, length);
+    }
+    if (offset >= content->length) {
+        return 0;
+    }
+    if (length > content->length - offset) {
+        length = content->length - offset;
+    }
+    memcpy(out, content->data + offset, length);
+    return length;
+}
+
+// Write one slice of payload into the requestor's property
+static size_t write_chunk(Window requestor, Atom property, Atom type, int format,
+                          ClipboardContent* content, int entry, size_t offset, size_t length) {
+    char* chunk = length > 0 ? (char*)malloc(length) : NULL;
+    size_t got = length > 0 ? content_read(content, entry, offset, chunk, length) : 0;
+    XChangeProperty(display, requestor, property, type, format, PropModeReplace,
+                    (unsigned char*)chunk, (int)(got / item_size(format)));
+    if (chunk) free(chunk);
+    return got;
+}
+
+static void disarm_restore() {
+    restore_armed = FALSE;
+    if (restore_timer) {
+        x11_reactor_remove_timeout(restore_timer);
+        restore_timer = 0;
+    }
+}
+
+// Serve the previous clipboard contents again in place of the replacement
+static void restore_previous(const char* reason) {
+    disarm_restore();
+
+    g_mutex_lock(&state_lock);
+    if (restore_content) {
+        content_unref(current_content);
+        current_content = restore_content;
+        restore_content = NULL;
+        printf("📋 %s, previous clipboard contents restored\n", reason);
+    }
+    g_mutex_unlock(&state_lock);
+}
+
+static void restore_timer_task(Display* task_display, void* user_data) {
+    restore_timer = 0;
+    restore_previous("Paste not fetched in time");
+}
+
+// Record that `requestor` received the whole of `content`. Clipboard
+// managers fetch as soon as we take ownership, so only a fetch after the
+// paste keystroke, by anyone but the CLIPBOARD_MANAGER owner, counts as
+// the paste.
+static void transfer_completed(ClipboardContent* content, Window requestor) {
+    if (!restore_armed) {
+        return;
+    }
+
+    g_mutex_lock(&state_lock);
+    gboolean is_replacement = content == current_content && restore_content;
+    g_mutex_unlock(&state_lock);
+
+    if (is_replacement && XGetSelectionOwner(display, clipboard_manager_atom) != requestor) {
+        restore_previous("Paste fetched");
+    }
+}
+
+// Answer a conversion request from another client
+static void handle_selection_request(XSelectionRequestEvent* request) {
+    XSelectionEvent reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.type = SelectionNotify;
+    reply.display = request->display;
+    reply.requestor = request->requestor;
+    reply.selection = request->selection;
+    reply.target = request->target;
+    reply.time = request->time;
+    reply.property = None;
+
+    // Obsolete clients pass None and expect the target name to be used
+    Atom property = request->property != None ? request->property : request->target;
+
+    g_mutex_lock(&state_lock);
+    ClipboardContent* content = content_ref(current_content);
+    g_mutex_unlock(&state_lock);
+
+    Atom type;
+    int format, entry;
+    size_t length;
+
+    if (content && request->selection == clipboard_atom) {
+        if (request->target == targets_atom) {
+            Atom text_targets[] = {
+                targets_atom, timestamp_atom, utf8_string_atom, text_plain_utf8_atom,
+                XA_STRING, text_atom, text_plain_atom
+            };
+            Atom* targets = text_targets;
+            int target_count = G_N_ELEMENTS(text_targets);
+
+            // A snapshot advertises exactly what the original owner offered
+            if (content->snapshot) {
+                target_count = 2 + clipboard_snapshot_count(content->snapshot);
+                targets = (Atom*)malloc(sizeof(Atom) * target_count);
+                targets[0] = targets_atom;
+                targets[1] = timestamp_atom;
+                for (int i = 2; i < target_count; i++) {
+                    targets[i] = clipboard_snapshot_target(content->snapshot, i - 2);
+                }
+            }
+
+            XChangeProperty(display, request->requestor, property, XA_ATOM, 32,
+                            PropModeReplace, (unsigned char*)targets, target_count);
+            reply.property = property;
+            if (targets != text_targets) free(targets);
+        } else if (request->target == timestamp_atom) {
+            long time_value = (long)owner_time;
+            XChangeProperty(display, request->requestor, property, XA_INTEGER, 32,
+                            PropModeReplace, (unsigned char*)&time_value, 1);
+            reply.property = property;
+        } else if (content_lookup(content, request->target, &entry, &type, &format, &length)) {
+            if (length <= max_chunk_size) {
+                write_chunk(request->requestor, property, type, format, content, entry, 0, length);
+                reply.property = property;
+                transfer_completed(content, request->requestor);
+            } else {
+                // Too large for one request: announce INCR and stream on deletes
+                IncrTransfer* transfer = (IncrTransfer*)malloc(sizeof(IncrTransfer));
+                transfer->requestor = request->requestor;
+                transfer->property = property;
+                transfer->type = type;
+                transfer->format = format;
+                transfer->entry = entry;
+                transfer->length = length;
+                transfer->content = content_ref(content);
+                transfer->offset = 0;
+                transfer->saved_mask = NoEventMask;
+                incr_transfers = g_list_append(incr_transfers, transfer);
+
+                // The requestor may be one of our own windows on this
+                // connection, so extend rather than replace our mask
+                XWindowAttributes attrs;
+                if (XGetWindowAttributes(display, request->requestor, &attrs)) {
+                    transfer->saved_mask = attrs.your_event_mask;
+                }
+
+                long size = (long)length;
+                XSelectInput(display, request->requestor, transfer->saved_mask | PropertyChangeMask);
+                XChangeProperty(display, request->requestor, property, incr_atom, 32,
+                                PropModeReplace, (unsigned char*)&size, 1);
+                reply.property = property;
+            }
+        }
+    }
+
+    content_unref(content);
+    XSendEvent(display, request->requestor, False, NoEventMask, (XEvent*)&reply);
+    XFlush(display);
+}
+
+// Send the next INCR chunk after the requestor deleted the previous one
+static gboolean handle_property_delete(XPropertyEvent* event) {
+    for (GList* node = incr_transfers; node; node = node->next) {
+        IncrTransfer* transfer = (IncrTransfer*)node->data;
+        if (transfer->requestor != event->window || transfer->property != event->atom) {
+            continue;
+        }
+
+        size_t remaining = transfer->length - transfer->offset;
+        size_t chunk = remaining < max_chunk_size ? remaining : max_chunk_size;
+        chunk = write_chunk(transfer->requestor, transfer->property, transfer->type,
+                            transfer->format, transfer->content, transfer->entry,
+                            transfer->offset, chunk);
+        transfer->offset += chunk;
+
+        // The zero-length chunk written above ends the transfer
+        if (chunk == 0) {
+            XSelectInput(display, transfer->requestor, transfer->saved_mask);
+            transfer_completed(transfer->content, transfer->requestor);
+            content_unref(transfer->content);
+            incr_transfers = g_list_delete_link(incr_transfers, node);
+            free(transfer);
+        }
+        XFlush(display);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// Another client took the clipboard: drop everything we were serving
+static void handle_selection_clear() {
+    owns_clipboard = FALSE;
+    disarm_restore();
+
+    g_mutex_lock(&state_lock);
+    content_unref(current_content);
+    content_unref(restore_content);
+    current_content = NULL;
+    restore_content = NULL;
+    g_mutex_unlock(&state_lock);
+}
+
+// Reactor handler: serve requests for our window
+static int owner_event_handler(XEvent* event, void* user_data) {
+    switch (event->type) {
+        case SelectionRequest:
+            if (event->xselectionrequest.owner != owner_window) {
+                return 0;
+            }
+            handle_selection_request(&event->xselectionrequest);
+            return 1;
+        case SelectionClear:
+            if (event->xselectionclear.window != owner_window) {
+                return 0;
+            }
+            if (event->xselectionclear.selection == clipboard_atom) {
+                handle_selection_clear();
+            }
+            return 1;
+        case PropertyNotify:
+            if (event->xproperty.window == owner_window) {
+                if (event->xproperty.atom == stamp_atom) {
+                    stamp_time = event->xproperty.time;
+                }
+                return 1;
+            }
+            if (event->xproperty.state == PropertyDelete) {
+                return handle_property_delete(&event->xproperty);
+            }
+            return 0;
+    }
+    return 0;
+}
+
+static void setup_owner_task(Display* task_display, void* user_data) {
+    display = task_display;
+
+    XSetWindowAttributes attrs;
+    attrs.event_mask = PropertyChangeMask;
+    owner_window = XCreateWindow(display, DefaultRootWindow(display), -10, -10, 1, 1, 0,
+                                 CopyFromParent, InputOnly, CopyFromParent,
+                                 CWEventMask, &attrs);
+
+    clipboard_atom = XInternAtom(display, "CLIPBOARD", False);
+    targets_atom = XInternAtom(display, "TARGETS", False);
+    timestamp_atom = XInternAtom(display, "TIMESTAMP", False);
+    utf8_string_atom = XInternAtom(display, "UTF8_STRING", False);
+    text_atom = XInternAtom(display, "TEXT", False);
+    text_plain_utf8_atom = XInternAtom(display, "text/plain;charset=utf-8", False);
+    text_plain_atom = XInternAtom(display, "text/plain", False);
+    incr_atom = XInternAtom(display, "INCR", False);
+    stamp_atom = XInternAtom(display, "INSTANT_TRANSLATOR_TIMESTAMP", False);
+    clipboard_manager_atom = XInternAtom(display, "CLIPBOARD_MANAGER", False);
+
+    // Leave headroom for the ChangeProperty request header
+    long max_request = XExtendedMaxRequestSize(display);
+    if (max_request == 0) {
+        max_request = XMaxRequestSize(display);
+    }
+    max_chunk_size = (size_t)max_request * 4 - 100;
+    if (max_chunk_size > 262144) {
+        max_chunk_size = 262144;
+    }
+    // Keep chunks whole for 32-bit formats
+    max_chunk_size -= max_chunk_size % sizeof(long);
+
+    x11_reactor_add_handler(owner_event_handler, NULL);
+}
+
+static void teardown_owner_task(Display* task_display, void* user_data) {
+    x11_reactor_remove_handler(owner_event_handler, NULL);
+    disarm_restore();
+
+    while (incr_transfers) {
+        IncrTransfer* transfer = (IncrTransfer*)incr_transfers->data;
+        content_unref(transfer->content);
+        free(transfer);
+        incr_transfers = g_list_delete_link(incr_transfers, incr_transfers);
+    }
+
+    XDestroyWindow(task_display, owner_window);
+    owner_window = None;
+    owns_clipboard = FALSE;
+}
+
+// Initialize the in-process CLIPBOARD owner
+int init_clipboard_owner() {
+    g_mutex_init(&state_lock);
+
+    int status = x11_reactor_call(setup_owner_task, NULL);
+    if (status != STATUS_SUCCESS) {
+        g_mutex_clear(&state_lock);
+    }
+    return status;
+}
+
+// Cleanup the clipboard owner
+void cleanup_clipboard_owner() {
+    if (!display) {
+        return;
+    }
+
+    x11_reactor_call(teardown_owner_task, NULL);
+    display = NULL;
+
+    content_unref(current_content);
+    content_unref(restore_content);
+    current_content = restore_content = NULL;
+
+    g_mutex_clear(&state_lock);
+}
+
+// Contents handed to the reactor by clipboard_owner_set_text()
+typedef struct {
+    ClipboardContent* content;
+    ClipboardContent* restore;
+    gboolean confirmed;
+} SetContentRequest;
+
+static void set_content_task(Display* task_display, void* user_data) {
+    SetContentRequest* request = (SetContentRequest*)user_data;
+    disarm_restore();
+
+    g_mutex_lock(&state_lock);
+    content_unref(current_content);
+    content_unref(restore_content);
+    current_content = request->content;
+    restore_content = request->restore;
+    g_mutex_unlock(&state_lock);
+
+    if (!owns_clipboard) {
+        owner_time = get_server_time();
+        XSetSelectionOwner(display, clipboard_atom, owner_window, owner_time);
+        owns_clipboard = XGetSelectionOwner(display, clipboard_atom) == owner_window;
+    }
+
+    request->confirmed = owns_clipboard;
+    if (!owns_clipboard) {
+        printf("❌ Failed to take CLIPBOARD ownership\n");
+    }
+}
+
+// Take CLIPBOARD ownership and serve `text`
+int clipboard_owner_set_text(const char* text, ClipboardSnapshot* restore) {
+    if (!text) {
+        return STATUS_ERROR_INIT;
+    }
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    SetContentRequest request;
+    request.content = content_new_text(text);
+    request.restore = restore ? content_new_snapshot(restore) : NULL;
+    request.confirmed = FALSE;
+
+    int status = x11_reactor_call(set_content_task, &request);
+    if (status != STATUS_SUCCESS) {
+        content_unref(request.content);
+        content_unref(request.restore);
+        return status;
+    }
+
+    return request.confirmed ? STATUS_SUCCESS : STATUS_ERROR_INIT;
+}
+
+static void arm_restore_task(Display* task_display, void* user_data) {
+    g_mutex_lock(&state_lock);
+    gboolean pending = restore_content != NULL;
+    g_mutex_unlock(&state_lock);
+
+    disarm_restore();
+    if (pending) {
+        restore_armed = TRUE;
+        restore_timer = x11_reactor_add_timeout(CLIPBOARD_RESTORE_TIMEOUT_MS, restore_timer_task, NULL);
+    }
+}
+
+// Start waiting for the paste that was just requested
+void clipboard_owner_arm_restore() {
+    if (display) {
+        x11_reactor_call(arm_restore_task, NULL);
+    }
+}
+
+// What the clipboard held before our replacement, if we own it
+ClipboardSnapshot* clipboard_owner_ref_original(int* serving) {
+    *serving = FALSE;
+    if (!display) {
+        return NULL;
+    }
+
+    // A replacement still waiting for its paste has the original queued up
+    g_mutex_lock(&state_lock);
+    ClipboardContent* original = restore_content ? restore_content : current_content;
+    ClipboardSnapshot* snapshot = original ? clipboard_snapshot_ref(original->snapshot) : NULL;
+    *serving = current_content != NULL;
+    g_mutex_unlock(&state_lock);
+    return snapshot;
+}
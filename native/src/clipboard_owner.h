@@ -0,0 +1,47 @@
+#ifndef CLIPBOARD_OWNER_H
+#define CLIPBOARD_OWNER_H
+
+#include "../include/instant_translator.h"
+#include "clipboard_snapshot.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for the server timestamp used to claim ownership
+#define SELECTION_OWNER_TIMEOUT_MS 1000
+
+// Restore the previous contents this long after the paste keystroke even
+// if the target application never fetched the replacement
+#define CLIPBOARD_RESTORE_TIMEOUT_MS 2000
+
+// Initialize the in-process CLIPBOARD owner (on the X11 reactor)
+int init_clipboard_owner();
+
+// Cleanup the clipboard owner, giving up ownership
+void cleanup_clipboard_owner();
+
+// Take CLIPBOARD ownership and serve `text`. When `restore` is not NULL
+// its targets replace `text` once the paste has fetched it, see
+// clipboard_owner_arm_restore(); the owner keeps its own reference.
+// Returns STATUS_SUCCESS once ownership is confirmed.
+int clipboard_owner_set_text(const char* text, ClipboardSnapshot* restore);
+
+// Call right after sending the paste keystroke: the next complete fetch of
+// the text (clipboard managers excepted), or CLIPBOARD_RESTORE_TIMEOUT_MS,
+// brings back the contents passed as `restore`. Fetches before this call
+// never restore.
+void clipboard_owner_arm_restore();
+
+// While we own the clipboard, sets *serving and returns a reference to
+// the contents from before our replacement: the pending restore, or the
+// snapshot already restored. NULL there means the clipboard was empty.
+// Our own replacement text is never returned.
+ClipboardSnapshot* clipboard_owner_ref_original(int* serving);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLIPBOARD_OWNER_H
@@ -0,0 +1,398 @@
+#include "clipboard_snapshot.h"
+#include "selection_reader.h"
+#include "x11_reactor.h"
+#include <X11/Xlib.h>
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+// One captured target; payload lives in memory or in the spill file
+typedef struct {
+    Atom target;
+    Atom type;
+    int format;
+    char* memory;           // Payload while it fits in the memory budget
+    size_t capacity;
+    off_t file_offset;      // Payload offset in the spill file otherwise
+    gboolean spilled;
+    size_t length;
+} SnapshotEntry;
+
+struct ClipboardSnapshot {
+    gint refcount;
+    SnapshotEntry* entries;
+    int count;
+    int spill_fd;           // Unlinked temp file, opened on first spill
+    size_t memory_used;
+    size_t file_used;
+
+    // Background capture; the fields above belong to it until it is done
+    GMutex lock;
+    GCond done_cond;
+    gboolean capturing;
+    Atom selection;
+    Atom* pending;          // Targets still to fetch, in TARGETS order
+    int pending_count;
+    gint64 deadline;        // Monotonic time the whole capture must end by
+};
+
+// Sink state while one target streams in
+typedef struct {
+    ClipboardSnapshot* snapshot;
+    SnapshotEntry* entry;
+} EntrySink;
+
+// Meta targets that describe the selection rather than carry data
+static const char* skipped_target_names[] = {
+    "TARGETS", "MULTIPLE", "TIMESTAMP", "SAVE_TARGETS", "DELETE",
+    "INSERT_SELECTION", "INSERT_PROPERTY",
+};
+
+// Open an anonymous temp file for spilled payloads
+static int open_spill_file() {
+    const char* dir = g_get_tmp_dir();
+
+#ifdef O_TMPFILE
+    int fd = open(dir, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        return fd;
+    }
+#endif
+
+    char* path = g_build_filename(dir, "instant_translator_clipboard_XXXXXX", NULL);
+    int fd_fallback = mkostemp(path, O_CLOEXEC);
+    if (fd_fallback >= 0) {
+        unlink(path);
+    }
+    g_free(path);
+    return fd_fallback;
+}
+
+static gboolean write_all(int fd, const char* data, size_t length, off_t offset) {
+    while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return FALSE;
+        }
+        data += written;
+        offset += written;
+        length -= (size_t)written;
+    }
+    return TRUE;
+}
+
+// Move an in-memory entry to the end of the spill file
+static gboolean spill_entry(ClipboardSnapshot* snapshot, SnapshotEntry* entry) {
+    if (snapshot->spill_fd < 0) {
+        snapshot->spill_fd = open_spill_file();
+        if (snapshot->spill_fd < 0) {
+            printf("❌ Could not create clipboard spill file: %s\n", strerror(errno));
+            return FALSE;
+        }
+    }
+
+    entry->file_offset = (off_t)snapshot->file_used;
+    if (entry->length > 0 &&
+        !write_all(snapshot->spill_fd, entry->memory, entry->length, entry->file_offset)) {
+        return FALSE;
+    }
+
+    snapshot->memory_used -= entry->length;
+    snapshot->file_used += entry->length;
+    free(entry->memory);
+    entry->memory = NULL;
+    entry->capacity = 0;
+    entry->spilled = TRUE;
+    return TRUE;
+}
+
+// Sink callback: keep data in memory until the budget runs out, then spill
+static int entry_sink_write(void* ctx, const char* data, size_t length) {
+    EntrySink* sink = (EntrySink*)ctx;
+    ClipboardSnapshot* snapshot = sink->snapshot;
+    SnapshotEntry* entry = sink->entry;
+
+    if (snapshot->memory_used + snapshot->file_used + length > SNAPSHOT_TOTAL_LIMIT) {
+        return FALSE;
+    }
+
+    if (!entry->spilled && snapshot->memory_used + length > SNAPSHOT_MEMORY_LIMIT) {
+        if (!spill_entry(snapshot, entry)) {
+            return FALSE;
+        }
+    }
+
+    if (entry->spilled) {
+        if (!write_all(snapshot->spill_fd, data, length, entry->file_offset + (off_t)entry->length)) {
+            return FALSE;
+        }
+        entry->length += length;
+        snapshot->file_used += length;
+        return TRUE;
+    }
+
+    if (entry->length + length > entry->capacity) {
+        size_t capacity = entry->capacity ? entry->capacity : 256;
+        while (capacity < entry->length + length) {
+            capacity *= 2;
+        }
+        char* memory = (char*)realloc(entry->memory, capacity);
+        if (!memory) {
+            return FALSE;
+        }
+        entry->memory = memory;
+        entry->capacity = capacity;
+    }
+
+    memcpy(entry->memory + entry->length, data, length);
+    entry->length += length;
+    snapshot->memory_used += length;
+    return TRUE;
+}
+
+// Forget a partially captured entry and give back its budget
+static void discard_entry(ClipboardSnapshot* snapshot, SnapshotEntry* entry) {
+    if (entry->spilled) {
+        // Spilled entries are always the last thing in the file
+        snapshot->file_used = (size_t)entry->file_offset;
+        if (ftruncate(snapshot->spill_fd, entry->file_offset) != 0) {
+            printf("⚠️  Could not truncate clipboard spill file\n");
+        }
+    } else {
+        snapshot->memory_used -= entry->length;
+        free(entry->memory);
+    }
+    memset(entry, 0, sizeof(*entry));
+}
+
+static gboolean is_skipped_target(Atom target, Atom* skipped, size_t skipped_count) {
+    for (size_t i = 0; i < skipped_count; i++) {
+        if (skipped[i] == target) return TRUE;
+    }
+    return FALSE;
+}
+
+// Milliseconds left before `deadline`, capped at one read's timeout
+static int remaining_ms(gint64 deadline) {
+    gint64 remaining = (deadline - g_get_monotonic_time()) / 1000;
+    return (int)CLAMP(remaining, 0, SELECTION_READ_TIMEOUT_MS);
+}
+
+// Fetch the payloads one target per reactor call, so other reactor work
+// runs between them, until they are all in or the deadline passes
+static gpointer capture_thread_func(gpointer data) {
+    ClipboardSnapshot* snapshot = (ClipboardSnapshot*)data;
+    int dropped = 0;
+
+    for (int i = 0; i < snapshot->pending_count; i++) {
+        int timeout_ms = remaining_ms(snapshot->deadline);
+        if (timeout_ms == 0) {
+            dropped = snapshot->pending_count - i;
+            break;
+        }
+
+        SnapshotEntry* entry = &snapshot->entries[snapshot->count];
+        entry->target = snapshot->pending[i];
+
+        EntrySink entry_sink = { snapshot, entry };
+        SelectionSink sink;
+        sink.reserve = NULL;
+        sink.write = entry_sink_write;
+        sink.ctx = &entry_sink;
+
+        if (read_selection_to_sink(snapshot->selection, entry->target, &sink, timeout_ms) == STATUS_SUCCESS) {
+            entry->type = sink.type;
+            entry->format = sink.format;
+            snapshot->count++;
+        } else {
+            printf("⚠️  Clipboard target %lu not captured\n", (unsigned long)entry->target);
+            discard_entry(snapshot, entry);
+        }
+    }
+
+    if (dropped > 0) {
+        printf("⚠️  Clipboard snapshot deadline reached, %d targets dropped\n", dropped);
+    }
+    printf("📋 Clipboard snapshot: %d targets, %zu bytes in memory, %zu bytes spilled\n",
+           snapshot->count, snapshot->memory_used, snapshot->file_used);
+
+    g_mutex_lock(&snapshot->lock);
+    free(snapshot->pending);
+    snapshot->pending = NULL;
+    snapshot->pending_count = 0;
+    snapshot->capturing = FALSE;
+    g_cond_broadcast(&snapshot->done_cond);
+    g_mutex_unlock(&snapshot->lock);
+
+    clipboard_snapshot_unref(snapshot);
+    return NULL;
+}
+
+// Read TARGETS now and fetch the payloads in the background
+ClipboardSnapshot* clipboard_snapshot_capture_async(Atom selection, Atom targets_atom) {
+    gint64 deadline = g_get_monotonic_time() + (gint64)SNAPSHOT_CAPTURE_DEADLINE_MS * 1000;
+
+    SelectionBuffer targets;
+    if (read_selection(selection, targets_atom, &targets, remaining_ms(deadline)) != STATUS_SUCCESS) {
+        return NULL;
+    }
+    if (targets.format != 32 || targets.length == 0) {
+        selection_buffer_free(&targets);
+        return NULL;
+    }
+
+    Atom skipped[G_N_ELEMENTS(skipped_target_names)];
+    for (size_t i = 0; i < G_N_ELEMENTS(skipped_target_names); i++) {
+        skipped[i] = x11_reactor_intern(skipped_target_names[i]);
+    }
+
+    Atom* offered = (Atom*)targets.data;
+    int offered_count = (int)(targets.length / sizeof(long));
+    Atom* pending = (Atom*)malloc(sizeof(Atom) * offered_count);
+    int pending_count = 0;
+
+    for (int i = 0; i < offered_count; i++) {
+        Atom target = offered[i];
+        if (target == None || is_skipped_target(target, skipped, G_N_ELEMENTS(skipped)) ||
+            is_skipped_target(target, pending, pending_count)) {
+            continue;
+        }
+        pending[pending_count++] = target;
+    }
+    selection_buffer_free(&targets);
+
+    if (pending_count == 0) {
+        free(pending);
+        return NULL;
+    }
+
+    ClipboardSnapshot* snapshot = (ClipboardSnapshot*)calloc(1, sizeof(ClipboardSnapshot));
+    snapshot->refcount = 1;
+    snapshot->spill_fd = -1;
+    snapshot->entries = (SnapshotEntry*)calloc(pending_count, sizeof(SnapshotEntry));
+    g_mutex_init(&snapshot->lock);
+    g_cond_init(&snapshot->done_cond);
+    snapshot->capturing = TRUE;
+    snapshot->selection = selection;
+    snapshot->pending = pending;
+    snapshot->pending_count = pending_count;
+    snapshot->deadline = deadline;
+
+    GThread* thread = g_thread_new("clipboard-snapshot", capture_thread_func,
+                                   clipboard_snapshot_ref(snapshot));
+    g_thread_unref(thread);
+    return snapshot;
+}
+
+// Wait for the background capture; bounded by its deadline
+int clipboard_snapshot_wait(ClipboardSnapshot* snapshot) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    g_mutex_lock(&snapshot->lock);
+    while (snapshot->capturing) {
+        g_cond_wait(&snapshot->done_cond, &snapshot->lock);
+    }
+    g_mutex_unlock(&snapshot->lock);
+    return snapshot->count;
+}
+
+// Capture every target of `selection`
+ClipboardSnapshot* clipboard_snapshot_capture(Atom selection, Atom targets_atom) {
+    ClipboardSnapshot* snapshot = clipboard_snapshot_capture_async(selection, targets_atom);
+    if (snapshot && clipboard_snapshot_wait(snapshot) == 0) {
+        clipboard_snapshot_unref(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+ClipboardSnapshot* clipboard_snapshot_ref(ClipboardSnapshot* snapshot) {
+    if (snapshot) g_atomic_int_inc(&snapshot->refcount);
+    return snapshot;
+}
+
+void clipboard_snapshot_unref(ClipboardSnapshot* snapshot) {
+    if (!snapshot || !g_atomic_int_dec_and_test(&snapshot->refcount)) {
+        return;
+    }
+
+    for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->entries[i].memory) {
+            free(snapshot->entries[i].memory);
+        }
+    }
+    free(snapshot->entries);
+    if (snapshot->spill_fd >= 0) {
+        close(snapshot->spill_fd);
+    }
+    g_cond_clear(&snapshot->done_cond);
+    g_mutex_clear(&snapshot->lock);
+    free(snapshot);
+}
+
+int clipboard_snapshot_count(ClipboardSnapshot* snapshot) {
+    return snapshot ? snapshot->count : 0;
+}
+
+Atom clipboard_snapshot_target(ClipboardSnapshot* snapshot, int index) {
+    if (!snapshot || index < 0 || index >= snapshot->count) {
+        return None;
+    }
+    return snapshot->entries[index].target;
+}
+
+int clipboard_snapshot_find(ClipboardSnapshot* snapshot, Atom target) {
+    if (!snapshot) return -1;
+
+    for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->entries[i].target == target) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void clipboard_snapshot_describe(ClipboardSnapshot* snapshot, int index,
+                                 Atom* type, int* format, size_t* length) {
+    SnapshotEntry* entry = &snapshot->entries[index];
+    if (type) *type = entry->type;
+    if (format) *format = entry->format;
+    if (length) *length = entry->length;
+}
+
+size_t clipboard_snapshot_read(ClipboardSnapshot* snapshot, int index,
+                               size_t offset, char* out, size_t length) {
+    if (!snapshot || index < 0 || index >= snapshot->count) {
+        return 0;
+    }
+
+    SnapshotEntry* entry = &snapshot->entries[index];
+    if (offset >= entry->length) {
+        return 0;
+    }
+    if (length > entry->length - offset) {
+        length = entry->length - offset;
+    }
+
+    if (!entry->spilled) {
+        memcpy(out, entry->memory + offset, length);
+        return length;
+    }
+
+    size_t copied = 0;
+    while (copied < length) {
+        ssize_t got = pread(snapshot->spill_fd, out + copied, length - copied,
+                            entry->file_offset + (off_t)(offset + copied));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        copied += (size_t)got;
+    }
+    return copied;
+}
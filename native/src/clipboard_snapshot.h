@@ -0,0 +1,64 @@
+#ifndef CLIPBOARD_SNAPSHOT_H
+#define CLIPBOARD_SNAPSHOT_H
+
+#include "../include/instant_translator.h"
+#include <X11/Xlib.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Payload bytes kept in memory per snapshot before spilling to a temp file
+#define SNAPSHOT_MEMORY_LIMIT (1024 * 1024)
+
+// Hard cap on everything a snapshot stores; larger targets are dropped
+#define SNAPSHOT_TOTAL_LIMIT (64 * 1024 * 1024)
+
+// The whole capture, TARGETS included, ends this long after it starts;
+// targets not fetched by then are left out
+#define SNAPSHOT_CAPTURE_DEADLINE_MS 1500
+
+// Every target a selection owner offered, captured before we take it over
+typedef struct ClipboardSnapshot ClipboardSnapshot;
+
+// Read TARGETS now and fetch each payload on a background thread. The
+// owner stops answering once we take the selection over, so start this
+// early and clipboard_snapshot_wait() before taking it. Returns NULL if
+// the selection has no owner or offers nothing.
+ClipboardSnapshot* clipboard_snapshot_capture_async(Atom selection, Atom targets_atom);
+
+// Wait for an async capture to finish; returns the captured target count.
+// The accessors below are only valid after this.
+int clipboard_snapshot_wait(ClipboardSnapshot* snapshot);
+
+// Capture every target of `selection` and wait for it. Returns NULL if
+// nothing could be captured.
+ClipboardSnapshot* clipboard_snapshot_capture(Atom selection, Atom targets_atom);
+
+ClipboardSnapshot* clipboard_snapshot_ref(ClipboardSnapshot* snapshot);
+void clipboard_snapshot_unref(ClipboardSnapshot* snapshot);
+
+// Number of captured targets
+int clipboard_snapshot_count(ClipboardSnapshot* snapshot);
+
+// Target atom of entry `index`, or None if out of range
+Atom clipboard_snapshot_target(ClipboardSnapshot* snapshot, int index);
+
+// Look up the entry for `target`; returns -1 if it was not captured
+int clipboard_snapshot_find(ClipboardSnapshot* snapshot, Atom target);
+
+// Type, format and payload length of entry `index`
+void clipboard_snapshot_describe(ClipboardSnapshot* snapshot, int index,
+                                 Atom* type, int* format, size_t* length);
+
+// Copy up to `length` payload bytes of entry `index` starting at `offset`.
+// Spilled payloads are read from disk only here. Returns bytes copied.
+size_t clipboard_snapshot_read(ClipboardSnapshot* snapshot, int index,
+                               size_t offset, char* out, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLIPBOARD_SNAPSHOT_H
@@ -1,26 +1,114 @@
 #include "context_menu_injector.h"
 #include "text_selection_monitor.h"
 #include "text_replacement.h"
+#include "speculative_processing.h"
+#include "action_channel.h"
+#include "dart_port_bridge.h"
+#include "result_cache.h"
 #include <gtk/gtk.h>
 #include <gdk/gdk.h>
-#include <X11/Xlib.h>
-#include <X11/keysym.h>
-#include <X11/extensions/XTest.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+// Immutable, reference-counted copy of the registered items. A new one is
+// published on every registration; readers take a reference and keep
+// using their copy however long they need it.
+typedef struct {
+    gint refcount;
+    MenuItem* items;
+    int count;
+} MenuSnapshot;
+
 // Menu state
-static MenuItem* registered_menu_items = NULL;
-static int menu_item_count = 0;
+static MenuSnapshot* published_menu = NULL;   // Only via g_atomic_pointer_*
+static gint snapshot_readers = 0;             // Readers between load and ref
 static MenuActionCallback menu_action_callback = NULL;
 static GtkWidget* popup_menu = NULL;
 static SelectionData* current_selection = NULL;
 
-// Global hotkey monitoring
-static Display* x_display = NULL;
-static gboolean hotkey_monitoring = FALSE;
-static GThread* hotkey_thread = NULL;
+// Pre-realized popup, rebuilt when a new snapshot is published
+static GtkWidget* menu_window = NULL;
+static MenuSnapshot* menu_window_snapshot = NULL;  // Items the window was built from
+static GtkWidget* menu_title_label = NULL;
+static GtkWidget* menu_preview_label = NULL;       // Streamed speculative result
+static gboolean menu_window_open = FALSE;
+static guint menu_timeout_id = 0;
+static gboolean menu_window_reuse = TRUE;
+static gboolean menu_rebuild_pending = FALSE;     // Items changed while open
+
+// Pending first-frame measurement (GTK main thread)
+static gulong frame_handler_id = 0;
+static gint64 frame_requested_at = 0;
+static gboolean frame_rebuilt = FALSE;
+
+// Last item the user picked, preferred for speculative processing
+static char* last_used_menu_id = NULL;
+
+// Newest speculative preview, handed from the D-Bus dispatcher thread to
+// the GTK main thread; only the latest is shown
+static GMutex preview_lock;
+static char* preview_text = NULL;
+static char* preview_operation = NULL;
+static char* preview_partial = NULL;
+static gboolean preview_queued = FALSE;
+
+// Hotkey dispatch latency, written by the reactor thread
+static GMutex latency_lock;
+static HotkeyLatencyStats latency_stats;
+static gint64 latency_total_us = 0;
+
+// Request -> first painted frame, split by rebuilt and reused window
+static HotkeyLatencyStats frame_stats_rebuilt;
+static HotkeyLatencyStats frame_stats_reused;
+static gint64 frame_total_rebuilt_us = 0;
+static gint64 frame_total_reused_us = 0;
+
+static void menu_items_changed();
+static gboolean prebuild_menu_in_main_thread(gpointer data);
+
+static void menu_snapshot_unref(MenuSnapshot* snapshot) {
+    if (!snapshot || !g_atomic_int_dec_and_test(&snapshot->refcount)) {
+        return;
+    }
+    
+    for (int i = 0; i < snapshot->count; i++) {
+        if (snapshot->items[i].id) free(snapshot->items[i].id);
+        if (snapshot->items[i].label) free(snapshot->items[i].label);
+        if (snapshot->items[i].operation) free(snapshot->items[i].operation);
+        if (snapshot->items[i].ai_instruction) free(snapshot->items[i].ai_instruction);
+    }
+    free(snapshot->items);
+    free(snapshot);
+}
+
+// Take a reference to the current snapshot (NULL when nothing is
+// registered). Never blocks; release with menu_snapshot_unref().
+static MenuSnapshot* menu_snapshot_acquire() {
+    // A publisher will not free what it replaced while we are in here
+    g_atomic_int_inc(&snapshot_readers);
+    MenuSnapshot* snapshot = (MenuSnapshot*)g_atomic_pointer_get(&published_menu);
+    if (snapshot) {
+        g_atomic_int_inc(&snapshot->refcount);
+    }
+    g_atomic_int_add(&snapshot_readers, -1);
+    return snapshot;
+}
+
+// Swap in a new snapshot (or NULL) and drop the published reference to
+// the old one. Holders of the old snapshot keep it alive.
+static void publish_menu_snapshot(MenuSnapshot* snapshot) {
+    MenuSnapshot* old = (MenuSnapshot*)g_atomic_pointer_exchange(&published_menu, snapshot);
+    
+    // Wait out readers that may have loaded `old` but not yet referenced it;
+    // that window is a few instructions long
+    while (g_atomic_int_get(&snapshot_readers) > 0) {
+        g_thread_yield();
+    }
+    menu_snapshot_unref(old);
+    
+    menu_items_changed();
+}
 
 // Menu item callback data
 typedef struct {
@@ -64,7 +152,10 @@ static GtkWidget* create_menu_item(MenuItem* item, SelectionData* selection) {
 static GtkWidget* create_context_menu(SelectionData* selection) {
     GtkWidget* menu = gtk_menu_new();
     
-    if (!registered_menu_items || menu_item_count == 0) {
+    MenuSnapshot* snapshot = menu_snapshot_acquire();
+    if (!snapshot || snapshot->count == 0) {
+        menu_snapshot_unref(snapshot);
+        
         // Add default "No actions available" item
         GtkWidget* item = gtk_menu_item_new_with_label("No AI actions available");
         gtk_widget_set_sensitive(item, FALSE);
@@ -95,79 +186,301 @@ static GtkWidget* create_context_menu(SelectionData* selection) {
     }
     
     // Add registered menu items
-    for (int i = 0; i < menu_item_count; i++) {
-        GtkWidget* item = create_menu_item(&registered_menu_items[i], selection);
+    for (int i = 0; i < snapshot->count; i++) {
+        GtkWidget* item = create_menu_item(&snapshot->items[i], selection);
         gtk_menu_shell_append(GTK_MENU_SHELL(menu), item);
         gtk_widget_show(item);
     }
     
+    menu_snapshot_unref(snapshot);
     return menu;
 }
 
+// Run a menu action for a selection (GTK main thread)
+static void dispatch_menu_action(const char* menu_id, SelectionData* selection) {
+    printf("Processing selection: %s\n", selection->text);
+    
+    // Remember the choice for the next speculation
+    if (!last_used_menu_id || strcmp(last_used_menu_id, menu_id) != 0) {
+        if (last_used_menu_id) free(last_used_menu_id);
+        last_used_menu_id = strdup(menu_id);
+    }
+    
+    // Drop a speculation for any other item or text
+    speculation_cancel_unless(selection->text, menu_id);
+    
+    // An attached Dart port hears about it whichever route handles it
+    dart_port_bridge_post_menu_action(menu_id, selection);
+    
+    // Call the callback if registered
+    if (menu_action_callback) {
+        printf("Calling menu action callback for: %s\n", menu_id);
+        menu_action_callback(menu_id, selection);
+    } else {
+        // Fallback: stream the action to Flutter over the action channel
+        printf("No callback registered, delegating to Flutter via action channel\n");
+        
+        if (action_channel_publish(menu_id, selection) != STATUS_SUCCESS) {
+            printf("⚠️  Action channel unavailable, action dropped: %s\n", menu_id);
+        }
+        
+        // Don't do native replacement - let Flutter handle everything
+    }
+}
+
+// Hide the popup and forget its pending timeout (GTK main thread)
+static void hide_menu_window() {
+    menu_window_open = FALSE;
+    if (menu_rebuild_pending) {
+        menu_rebuild_pending = FALSE;
+        g_idle_add(prebuild_menu_in_main_thread, NULL);
+    }
+    if (menu_timeout_id > 0) {
+        g_source_remove(menu_timeout_id);
+        menu_timeout_id = 0;
+    }
+    if (menu_window) {
+        gtk_widget_hide(menu_window);
+    }
+    if (menu_preview_label) {
+        gtk_widget_hide(menu_preview_label);
+    }
+}
+
 // Callback for menu button clicks
 static void on_menu_button_clicked(GtkWidget* button, gpointer data) {
-    const char* menu_id = (const char*)g_object_get_data(G_OBJECT(button), "menu_id");
-    GtkWidget* window = (GtkWidget*)g_object_get_data(G_OBJECT(button), "window");
-    guint timeout_id = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(window), "timeout_id"));
+    // The window's own snapshot stays valid for as long as the button exists
+    int index = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(button), "menu_index"));
+    const char* menu_id = menu_window_snapshot->items[index].id;
     
     printf("Menu item clicked: %s\n", menu_id);
     
-    // Remove timeout before destroying window
-    if (timeout_id > 0) {
-        g_source_remove(timeout_id);
-    }
-    
     if (current_selection) {
-        printf("Processing selection: %s\n", current_selection->text);
-        
-        // Call the callback if registered
-        if (menu_action_callback) {
-            printf("Calling menu action callback for: %s\n", menu_id);
-            menu_action_callback(menu_id, current_selection);
-        } else {
-            // Fallback: write action to file for Flutter processing (no native replacement)
-            printf("No callback registered, delegating to Flutter via file\n");
-            
-            // Write action to file for Flutter to pick up and process
-            FILE* action_file = fopen("/tmp/instant_translator_action.txt", "w");
-            if (action_file) {
-                fprintf(action_file, "%s\t\n%s\n", menu_id, current_selection->text);
-                fclose(action_file);
-                printf("Action written to file for Flutter pickup\n");
-            }
-            
-            // Don't do native replacement - let Flutter handle everything
-        }
+        dispatch_menu_action(menu_id, current_selection);
     }
     
-    gtk_widget_destroy(window);
+    // Hiding first makes the resulting focus-out a no-op, so the
+    // speculation now belongs to the dispatched action
+    hide_menu_window();
 }
 
 // Callback for window timeout
 static gboolean on_window_timeout(gpointer data) {
-    GtkWidget* window = (GtkWidget*)data;
-    if (GTK_IS_WIDGET(window)) {
-        g_object_set_data(G_OBJECT(window), "timeout_id", GUINT_TO_POINTER(0));
-        gtk_widget_destroy(window);
-    }
+    menu_timeout_id = 0;
+    speculation_cancel();
+    hide_menu_window();
     return FALSE;
 }
 
 // Callback for focus out event
 static gboolean on_window_focus_out(GtkWidget* window, GdkEvent* event, gpointer data) {
-    guint timeout_id = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(window), "timeout_id"));
-    if (timeout_id > 0) {
-        g_source_remove(timeout_id);
+    if (!menu_window_open) {
+        return FALSE;
     }
-    gtk_widget_destroy(window);
+    speculation_cancel();
+    hide_menu_window();
     return FALSE;
 }
 
+// Fold one hotkey -> first frame sample into the path's stats
+static void record_frame_latency(gboolean rebuilt, gint64 elapsed_us) {
+    HotkeyLatencyStats* stats = rebuilt ? &frame_stats_rebuilt : &frame_stats_reused;
+    gint64* total_us = rebuilt ? &frame_total_rebuilt_us : &frame_total_reused_us;
+    
+    g_mutex_lock(&latency_lock);
+    stats->count++;
+    stats->last_us = elapsed_us;
+    if (elapsed_us > stats->max_us) {
+        stats->max_us = elapsed_us;
+    }
+    if (elapsed_us > MENU_FRAME_BUDGET_US) {
+        stats->over_budget++;
+    }
+    *total_us += elapsed_us;
+    stats->mean_us = *total_us / stats->count;
+    g_mutex_unlock(&latency_lock);
+}
+
+// First frame of the popup has been painted
+static void on_menu_after_paint(GdkFrameClock* clock, gpointer data) {
+    g_signal_handler_disconnect(clock, frame_handler_id);
+    frame_handler_id = 0;
+    
+    gint64 elapsed_us = g_get_monotonic_time() - frame_requested_at;
+    record_frame_latency(frame_rebuilt, elapsed_us);
+    printf("🖼️  Menu first frame %ldus after request (%s window)\n", (long)elapsed_us,
+           frame_rebuilt ? "rebuilt" : "reused");
+}
+
+// Build the popup for the current item set and realize it off-screen
+// (GTK main thread)
+static void build_menu_window() {
+    menu_rebuild_pending = FALSE;
+    if (menu_window) {
+        hide_menu_window();
+        // A first-frame handler still waiting on the old window's clock
+        if (frame_handler_id > 0) {
+            GdkFrameClock* clock = gtk_widget_get_frame_clock(menu_window);
+            if (clock) {
+                g_signal_handler_disconnect(clock, frame_handler_id);
+            }
+            frame_handler_id = 0;
+        }
+        gtk_widget_destroy(menu_window);
+        menu_window = NULL;
+        menu_title_label = NULL;
+        menu_preview_label = NULL;
+    }
+    menu_snapshot_unref(menu_window_snapshot);
+    MenuSnapshot* snapshot = menu_snapshot_acquire();
+    menu_window_snapshot = snapshot;
+    
+    // Create a simple window-based menu instead of popup
+    GtkWidget* window = gtk_window_new(GTK_WINDOW_POPUP);
+    gtk_window_set_type_hint(GTK_WINDOW(window), GDK_WINDOW_TYPE_HINT_MENU);
+    gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
+    gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
+    // Create menu container
+    GtkWidget* vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
+    gtk_container_add(GTK_CONTAINER(window), vbox);
+    
+    // Add title; its text is filled in on every show
+    GtkWidget* title_label = gtk_label_new("AI Translator");
+    gtk_widget_set_margin_top(title_label, 8);
+    gtk_widget_set_margin_bottom(title_label, 4);
+    gtk_widget_set_margin_start(title_label, 8);
+    gtk_widget_set_margin_end(title_label, 8);
+    
+    // Make title bold
+    PangoAttrList* attrs = pango_attr_list_new();
+    pango_attr_list_insert(attrs, pango_attr_weight_new(PANGO_WEIGHT_BOLD));
+    gtk_label_set_attributes(GTK_LABEL(title_label), attrs);
+    pango_attr_list_unref(attrs);
+    
+    gtk_box_pack_start(GTK_BOX(vbox), title_label, FALSE, FALSE, 0);
+    
+    // Live preview of the likely action; shown once its first chunk arrives
+    GtkWidget* preview_label = gtk_label_new(NULL);
+    gtk_label_set_line_wrap(GTK_LABEL(preview_label), TRUE);
+    gtk_label_set_max_width_chars(GTK_LABEL(preview_label), 40);
+    gtk_label_set_ellipsize(GTK_LABEL(preview_label), PANGO_ELLIPSIZE_END);
+    gtk_label_set_lines(GTK_LABEL(preview_label), 3);
+    gtk_label_set_xalign(GTK_LABEL(preview_label), 0.0);
+    gtk_widget_set_margin_start(preview_label, 8);
+    gtk_widget_set_margin_end(preview_label, 8);
+    gtk_widget_set_margin_bottom(preview_label, 4);
+    gtk_widget_set_sensitive(preview_label, FALSE);  // Dimmed: not applied yet
+    gtk_widget_set_no_show_all(preview_label, TRUE);
+    gtk_box_pack_start(GTK_BOX(vbox), preview_label, FALSE, FALSE, 0);
+    
+    // Add separator
+    GtkWidget* separator = gtk_separator_new(GTK_ORIENTATION_HORIZONTAL);
+    gtk_box_pack_start(GTK_BOX(vbox), separator, FALSE, FALSE, 0);
+    
+    // Add menu items
+    if (snapshot && snapshot->count > 0) {
+        for (int i = 0; i < snapshot->count; i++) {
+            if (snapshot->items[i].enabled) {
+                GtkWidget* button = gtk_button_new_with_label(snapshot->items[i].label);
+                gtk_widget_set_margin_start(button, 4);
+                gtk_widget_set_margin_end(button, 4);
+                gtk_widget_set_margin_top(button, 2);
+                gtk_widget_set_margin_bottom(button, 2);
+                
+                // Index into menu_window_snapshot
+                g_object_set_data(G_OBJECT(button), "menu_index", GINT_TO_POINTER(i));
+                
+                // Connect click handler
+                g_signal_connect(button, "clicked", G_CALLBACK(on_menu_button_clicked), NULL);
+                
+                gtk_box_pack_start(GTK_BOX(vbox), button, FALSE, FALSE, 0);
+            }
+        }
+    } else {
+        GtkWidget* no_items_label = gtk_label_new("No AI actions available");
+        gtk_widget_set_margin_start(no_items_label, 8);
+        gtk_widget_set_margin_end(no_items_label, 8);
+        gtk_widget_set_margin_top(no_items_label, 4);
+        gtk_widget_set_margin_bottom(no_items_label, 8);
+        gtk_box_pack_start(GTK_BOX(vbox), no_items_label, FALSE, FALSE, 0);
+    }
+    
+    // Close on focus out
+    g_signal_connect(window, "focus-out-event", G_CALLBACK(on_window_focus_out), NULL);
+    
+    // Realize now so showing is just map + paint
+    gtk_widget_show_all(vbox);
+    gtk_widget_realize(window);
+    
+    menu_window = window;
+    menu_title_label = title_label;
+    menu_preview_label = preview_label;
+    
+    printf("Context menu window built (%d items)\n", snapshot ? snapshot->count : 0);
+}
+
+// Whether two snapshots would produce the same popup and actions
+static gboolean menu_snapshot_same_items(const MenuSnapshot* a, const MenuSnapshot* b) {
+    if (a == b) {
+        return TRUE;
+    }
+    if (!a || !b || a->count != b->count) {
+        return FALSE;
+    }
+    for (int i = 0; i < a->count; i++) {
+        const MenuItem* x = &a->items[i];
+        const MenuItem* y = &b->items[i];
+        if (x->enabled != y->enabled || g_strcmp0(x->id, y->id) != 0 ||
+            g_strcmp0(x->label, y->label) != 0 || g_strcmp0(x->operation, y->operation) != 0 ||
+            g_strcmp0(x->ai_instruction, y->ai_instruction) != 0) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// Whether the built window still shows the published items. A republished
+// but identical item set is adopted in place, so the window is kept.
+static gboolean menu_window_is_current() {
+    if (!menu_window) {
+        return FALSE;
+    }
+    MenuSnapshot* snapshot = menu_snapshot_acquire();
+    if (!menu_snapshot_same_items(menu_window_snapshot, snapshot)) {
+        menu_snapshot_unref(snapshot);
+        return FALSE;
+    }
+    // Buttons index into the snapshot; the items are identical
+    menu_snapshot_unref(menu_window_snapshot);
+    menu_window_snapshot = snapshot;
+    return TRUE;
+}
+
+// Rebuild ahead of time after the item set changes. An open menu is left
+// alone and rebuilt once it is hidden.
+static gboolean prebuild_menu_in_main_thread(gpointer data) {
+    if (menu_window_is_current()) {
+        return FALSE;
+    }
+    if (menu_window_open) {
+        menu_rebuild_pending = TRUE;
+        return FALSE;
+    }
+    build_menu_window();
+    return FALSE;
+}
+
+// Item set changed: rebuild the popup when idle
+static void menu_items_changed() {
+    g_idle_add(prebuild_menu_in_main_thread, NULL);
+}
+
 // Data structure for menu creation in main thread
 typedef struct {
     int x;
     int y;
     SelectionData* selection;
+    gint64 requested_at;
 } MenuCreationData;
 
 // Show notification dialog in main thread
@@ -178,7 +491,7 @@ static gboolean show_notification_in_main_thread(gpointer data) {
         GTK_DIALOG_MODAL,
         GTK_MESSAGE_INFO,
         GTK_BUTTONS_OK,
-        "Instant AI Translator\n\nHotkey Ctrl+Shift+M detected!\nPlease select some text first.");
+        "Instant AI Translator\n\nHotkey detected!\nPlease select some text first.");
     
     gtk_dialog_run(GTK_DIALOG(dialog));
     gtk_widget_destroy(dialog);
@@ -193,28 +506,109 @@ static void show_no_text_notification() {
     g_idle_add(show_notification_in_main_thread, NULL);
 }
 
-// Create menu in GTK main thread
+// Most likely action among the popup's items: the last-used item if
+// still offered, else the first
+static const char* pick_speculative_menu_id() {
+    MenuSnapshot* snapshot = menu_window_snapshot;
+    if (!snapshot) {
+        return NULL;
+    }
+    
+    const char* first_enabled = NULL;
+    for (int i = 0; i < snapshot->count; i++) {
+        if (!snapshot->items[i].enabled) continue;
+        if (last_used_menu_id && strcmp(snapshot->items[i].id, last_used_menu_id) == 0) {
+            return snapshot->items[i].id;
+        }
+        if (!first_enabled) first_enabled = snapshot->items[i].id;
+    }
+    return first_enabled;
+}
+
+// Show the newest speculative preview if it is still for the open popup
+static gboolean update_preview_in_main_thread(gpointer data) {
+    g_mutex_lock(&preview_lock);
+    char* text = preview_text;
+    char* operation = preview_operation;
+    char* partial = preview_partial;
+    preview_text = preview_operation = preview_partial = NULL;
+    preview_queued = FALSE;
+    g_mutex_unlock(&preview_lock);
+    
+    if (menu_window_open && menu_preview_label && menu_window_snapshot &&
+        current_selection && current_selection->text && text &&
+        strcmp(current_selection->text, text) == 0) {
+        const char* label = operation;
+        for (int i = 0; i < menu_window_snapshot->count; i++) {
+            if (strcmp(menu_window_snapshot->items[i].id, operation) == 0) {
+                label = menu_window_snapshot->items[i].label;
+                break;
+            }
+        }
+        
+        char* preview = g_strdup_printf("%s: %s", label, partial);
+        gtk_label_set_text(GTK_LABEL(menu_preview_label), preview);
+        gtk_widget_show(menu_preview_label);
+        g_free(preview);
+    }
+    
+    free(text);
+    free(operation);
+    free(partial);
+    return FALSE;
+}
+
+// Speculation streamed more of its result (D-Bus dispatcher thread)
+static void on_speculation_preview(const char* text, const char* operation, const char* partial) {
+    g_mutex_lock(&preview_lock);
+    if (preview_text) free(preview_text);
+    if (preview_operation) free(preview_operation);
+    if (preview_partial) free(preview_partial);
+    preview_text = strdup(text);
+    preview_operation = strdup(operation);
+    preview_partial = strdup(partial);
+    
+    // One idle update however fast chunks arrive
+    if (!preview_queued) {
+        preview_queued = TRUE;
+        g_idle_add(update_preview_in_main_thread, NULL);
+    }
+    g_mutex_unlock(&preview_lock);
+}
+
+// Show the popup in GTK main thread, rebuilding it only when needed
 static gboolean create_menu_in_main_thread(gpointer data) {
     MenuCreationData* menu_data = (MenuCreationData*)data;
     int x = menu_data->x;
     int y = menu_data->y;
     SelectionData* selection = menu_data->selection;
     
-    printf("Creating context menu at position (%d, %d) in main thread\n", x, y);
+    printf("Showing context menu at position (%d, %d) in main thread\n", x, y);
     
     // Store current selection
     current_selection = selection;
     
-    // Create a simple window-based menu instead of popup
-    GtkWidget* window = gtk_window_new(GTK_WINDOW_POPUP);
-    gtk_window_set_type_hint(GTK_WINDOW(window), GDK_WINDOW_TYPE_HINT_MENU);
-    gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
-    gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
-    // Create menu container
-    GtkWidget* vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 2);
-    gtk_container_add(GTK_CONTAINER(window), vbox);
+    // Reuse the realized window unless the items changed (or reuse is off)
+    gboolean rebuilt = FALSE;
+    if (!menu_window_reuse || !menu_window_is_current()) {
+        build_menu_window();
+        rebuilt = TRUE;
+    }
     
-    // Add title
+    // A preview from the previous selection must not linger
+    gtk_widget_hide(menu_preview_label);
+    
+    // Start the likely action while the user is still reading the menu.
+    // Whoever handles the action, native callback or Dart, picks the
+    // result up through send_processing_request.
+    if (speculation_is_enabled() && selection && selection->text) {
+        const char* likely_id = pick_speculative_menu_id();
+        if (likely_id) {
+            speculation_start(selection->text, likely_id);
+        }
+    }
+    
+    // Update title
     char title_text[256];
     if (selection && selection->text) {
         int text_len = strlen(selection->text);
@@ -226,68 +620,35 @@ static gboolean create_menu_in_main_thread(gpointer data) {
     } else {
         snprintf(title_text, sizeof(title_text), "AI Translator");
     }
+    gtk_label_set_text(GTK_LABEL(menu_title_label), title_text);
     
-    GtkWidget* title_label = gtk_label_new(title_text);
-    gtk_widget_set_margin_top(title_label, 8);
-    gtk_widget_set_margin_bottom(title_label, 4);
-    gtk_widget_set_margin_start(title_label, 8);
-    gtk_widget_set_margin_end(title_label, 8);
-    
-    // Make title bold
-    PangoAttrList* attrs = pango_attr_list_new();
-    pango_attr_list_insert(attrs, pango_attr_weight_new(PANGO_WEIGHT_BOLD));
-    gtk_label_set_attributes(GTK_LABEL(title_label), attrs);
-    pango_attr_list_unref(attrs);
-    
-    gtk_box_pack_start(GTK_BOX(vbox), title_label, FALSE, FALSE, 0);
-    
-    // Add separator
-    GtkWidget* separator = gtk_separator_new(GTK_ORIENTATION_HORIZONTAL);
-    gtk_box_pack_start(GTK_BOX(vbox), separator, FALSE, FALSE, 0);
+    // Restart the auto-close of a menu that is already up
+    if (menu_timeout_id > 0) {
+        g_source_remove(menu_timeout_id);
+        menu_timeout_id = 0;
+    }
     
-    // Add menu items
-    if (registered_menu_items && menu_item_count > 0) {
-        for (int i = 0; i < menu_item_count; i++) {
-            if (registered_menu_items[i].enabled) {
-                GtkWidget* button = gtk_button_new_with_label(registered_menu_items[i].label);
-                gtk_widget_set_margin_start(button, 4);
-                gtk_widget_set_margin_end(button, 4);
-                gtk_widget_set_margin_top(button, 2);
-                gtk_widget_set_margin_bottom(button, 2);
-                
-                // Set button data
-                g_object_set_data(G_OBJECT(button), "menu_id", (gpointer)registered_menu_items[i].id);
-                g_object_set_data(G_OBJECT(button), "window", window);
-                
-                // Connect click handler
-                g_signal_connect(button, "clicked", G_CALLBACK(on_menu_button_clicked), NULL);
-                
-                gtk_box_pack_start(GTK_BOX(vbox), button, FALSE, FALSE, 0);
-            }
+    // Shrink to the new title, position and show
+    gtk_window_resize(GTK_WINDOW(menu_window), 1, 1);
+    gtk_window_move(GTK_WINDOW(menu_window), x, y);
+    gtk_widget_show(menu_window);
+    menu_window_open = TRUE;
+    
+    // Measure request -> first painted frame
+    GdkFrameClock* clock = gtk_widget_get_frame_clock(menu_window);
+    if (clock) {
+        if (frame_handler_id > 0) {
+            g_signal_handler_disconnect(clock, frame_handler_id);
         }
-    } else {
-        GtkWidget* no_items_label = gtk_label_new("No AI actions available");
-        gtk_widget_set_margin_start(no_items_label, 8);
-        gtk_widget_set_margin_end(no_items_label, 8);
-        gtk_widget_set_margin_top(no_items_label, 4);
-        gtk_widget_set_margin_bottom(no_items_label, 8);
-        gtk_box_pack_start(GTK_BOX(vbox), no_items_label, FALSE, FALSE, 0);
+        frame_requested_at = menu_data->requested_at;
+        frame_rebuilt = rebuilt;
+        frame_handler_id = g_signal_connect(clock, "after-paint", G_CALLBACK(on_menu_after_paint), NULL);
     }
     
-    // Position the window
-    gtk_window_move(GTK_WINDOW(window), x, y);
-    
-    // Show the window
-    gtk_widget_show_all(window);
-    
     // Auto-close after 10 seconds
-    guint timeout_id = g_timeout_add(10000, on_window_timeout, window);
-    g_object_set_data(G_OBJECT(window), "timeout_id", GUINT_TO_POINTER(timeout_id));
-    
-    // Close on focus out
-    g_signal_connect(window, "focus-out-event", G_CALLBACK(on_window_focus_out), NULL);
+    menu_timeout_id = g_timeout_add(10000, on_window_timeout, NULL);
     
-    printf("Context menu window created and shown\n");
+    printf("Context menu window shown (%s)\n", rebuilt ? "rebuilt" : "reused");
     
     // Cleanup menu creation data
     free(menu_data);
@@ -296,8 +657,9 @@ static gboolean create_menu_in_main_thread(gpointer data) {
     return FALSE;
 }
 
-// Show context menu at specific position (thread-safe)
-static void show_menu_at_position(int x, int y, SelectionData* selection) {
+// Show context menu at specific position (thread-safe). `requested_at` is
+// the monotonic time the request started, for frame latency.
+static void show_menu_at_position(int x, int y, SelectionData* selection, gint64 requested_at) {
     printf("Queuing context menu creation for position (%d, %d)\n", x, y);
     
     // Create data for menu creation in main thread
@@ -305,162 +667,153 @@ static void show_menu_at_position(int x, int y, SelectionData* selection) {
     menu_data->x = x;
     menu_data->y = y;
     menu_data->selection = selection;
+    menu_data->requested_at = requested_at;
     
     // Schedule menu creation in GTK main thread
     g_idle_add(create_menu_in_main_thread, menu_data);
 }
 
-// Hotkey monitoring thread (Ctrl+Shift+M)
-static gpointer hotkey_monitor_thread(gpointer data) {
-    KeySym ctrl_l = XK_Control_L;
-    KeySym ctrl_r = XK_Control_R;
-    KeySym shift_l = XK_Shift_L;
-    KeySym shift_r = XK_Shift_R;
-    KeySym m_key = XK_m;
-    
-    KeyCode ctrl_l_code = XKeysymToKeycode(x_display, ctrl_l);
-    KeyCode ctrl_r_code = XKeysymToKeycode(x_display, ctrl_r);
-    KeyCode shift_l_code = XKeysymToKeycode(x_display, shift_l);
-    KeyCode shift_r_code = XKeysymToKeycode(x_display, shift_r);
-    KeyCode m_code = XKeysymToKeycode(x_display, m_key);
-    
-    printf("Registering global hotkey: Ctrl+Shift+M\n");
-    printf("Keycodes: Ctrl=%d/%d, Shift=%d/%d, M=%d\n", 
-           ctrl_l_code, ctrl_r_code, shift_l_code, shift_r_code, m_code);
-    
-    Window root = DefaultRootWindow(x_display);
-    
-    // Register global hotkey using XGrabKey
-    // Modifier mask: ControlMask + ShiftMask
-    unsigned int modifiers = ControlMask | ShiftMask;
-    
-    // Grab the key combination globally
-    XGrabKey(x_display, m_code, modifiers, root, True, GrabModeAsync, GrabModeAsync);
-    XGrabKey(x_display, m_code, modifiers | LockMask, root, True, GrabModeAsync, GrabModeAsync); // With CapsLock
-    XGrabKey(x_display, m_code, modifiers | Mod2Mask, root, True, GrabModeAsync, GrabModeAsync); // With NumLock
-    XGrabKey(x_display, m_code, modifiers | LockMask | Mod2Mask, root, True, GrabModeAsync, GrabModeAsync); // Both
-    
-    XSelectInput(x_display, root, KeyPressMask);
-    XSync(x_display, False);
-    
-    printf("Global hotkey registered successfully\n");
-    
-    while (hotkey_monitoring) {
-        XEvent event;
-        if (XPending(x_display) > 0) {
-            XNextEvent(x_display, &event);
-            
-            if (event.type == KeyPress) {
-                printf("Global key event: keycode=%d, state=%d\n", event.xkey.keycode, event.xkey.state);
-                
-                // Check if this is our hotkey
-                if (event.xkey.keycode == m_code && 
-                    (event.xkey.state & (ControlMask | ShiftMask)) == (ControlMask | ShiftMask)) {
-                    
-                    printf("🎯 Hotkey triggered: Ctrl+Shift+M detected!\n");
-                    
-                    // Get current selection
-                    SelectionData* selection = get_selected_text();
-                    if (selection && selection->text && strlen(selection->text) > 0) {
-                        printf("📝 Showing menu for selected text: '%s'\n", selection->text);
-                        
-                        // Show menu at mouse position
-                        show_menu_at_position(selection->x, selection->y, selection);
-                    } else {
-                        printf("⚠️  No text selected - showing simple notification\n");
-                        
-                        // Show a simple notification that hotkey works (thread-safe)
-                        show_no_text_notification();
-                    }
-                }
-            }
+// Record one KeyPress -> show_menu_at_position dispatch
+static void record_hotkey_latency(gint64 elapsed_us) {
+    g_mutex_lock(&latency_lock);
+    latency_stats.count++;
+    latency_stats.last_us = elapsed_us;
+    if (elapsed_us > latency_stats.max_us) {
+        latency_stats.max_us = elapsed_us;
+    }
+    if (elapsed_us > HOTKEY_LATENCY_BUDGET_US) {
+        latency_stats.over_budget++;
+    }
+    latency_total_us += elapsed_us;
+    latency_stats.mean_us = latency_total_us / latency_stats.count;
+    g_mutex_unlock(&latency_lock);
+}
+
+// Menu action bound directly to a hotkey
+typedef struct {
+    char* menu_id;
+    SelectionData* selection;
+} HotkeyActionData;
+
+// Look up a registered, enabled menu item by id
+static gboolean menu_item_enabled(const char* menu_id) {
+    MenuSnapshot* snapshot = menu_snapshot_acquire();
+    gboolean enabled = FALSE;
+    for (int i = 0; snapshot && i < snapshot->count; i++) {
+        if (strcmp(snapshot->items[i].id, menu_id) == 0) {
+            enabled = snapshot->items[i].enabled;
+            break;
         }
-        
-        // Small sleep to prevent high CPU usage
-        usleep(10000); // 10ms
-        
-        // Small delay to prevent high CPU usage
-        usleep(10000); // 10ms
     }
-    
-    return NULL;
+    menu_snapshot_unref(snapshot);
+    return enabled;
 }
 
-// Initialize context menu system
-int init_context_menu_system() {
-    // Open X display for hotkey monitoring
-    x_display = XOpenDisplay(NULL);
-    if (!x_display) {
-        return STATUS_ERROR_NO_DISPLAY;
+// Run a hotkey-bound menu action in the GTK main thread
+static gboolean run_hotkey_action_in_main_thread(gpointer data) {
+    HotkeyActionData* action = (HotkeyActionData*)data;
+    
+    if (menu_item_enabled(action->menu_id)) {
+        // Same selection lifetime as the popup: the latest one stays current
+        current_selection = action->selection;
+        dispatch_menu_action(action->menu_id, action->selection);
+    } else {
+        printf("⚠️  Hotkey bound to unknown or disabled menu item: %s\n", action->menu_id);
+        free_selection_data(action->selection);
     }
     
-    // Check if XTest extension is available
-    int event_base, error_base, major_version, minor_version;
-    if (!XTestQueryExtension(x_display, &event_base, &error_base, &major_version, &minor_version)) {
-        XCloseDisplay(x_display);
-        return STATUS_ERROR_INIT;
+    free(action->menu_id);
+    free(action);
+    return FALSE;
+}
+
+// Handle a bound hotkey press (reactor thread)
+void context_menu_handle_hotkey(const char* accelerator, int action, const char* menu_item_id,
+                                int root_x, int root_y) {
+    gint64 dispatch_start = g_get_monotonic_time();
+    
+    // Cached selection and the pointer position carried by the event;
+    // nothing here waits on the X server or the selection owner
+    SelectionData* selection = get_selected_text_at(root_x, root_y);
+    if (selection && action == HOTKEY_ACTION_MENU_ITEM) {
+        // Skip the popup and run the bound item on the GTK thread
+        HotkeyActionData* data = (HotkeyActionData*)malloc(sizeof(HotkeyActionData));
+        data->menu_id = strdup(menu_item_id);
+        data->selection = selection;
+        g_idle_add(run_hotkey_action_in_main_thread, data);
+    } else if (selection) {
+        show_menu_at_position(selection->x, selection->y, selection, dispatch_start);
     }
     
-    // Start hotkey monitoring
-    hotkey_monitoring = TRUE;
-    hotkey_thread = g_thread_new("hotkey-monitor", hotkey_monitor_thread, NULL);
+    gint64 elapsed_us = g_get_monotonic_time() - dispatch_start;
+    record_hotkey_latency(elapsed_us);
     
-    if (!hotkey_thread) {
-        cleanup_context_menu_system();
-        return STATUS_ERROR_INIT;
+    if (selection) {
+        printf("🎯 Hotkey %s: %s queued in %ldus for '%s'\n", accelerator,
+               action == HOTKEY_ACTION_MENU_ITEM ? menu_item_id : "menu",
+               (long)elapsed_us, selection->text);
+    } else {
+        printf("⚠️  Hotkey %s with no text selected - showing simple notification\n", accelerator);
+        
+        // Show a simple notification that hotkey works (thread-safe)
+        show_no_text_notification();
     }
-    
+}
+
+// Initialize context menu system
+int init_context_menu_system() {
+    // Hotkeys are grabbed by the hotkey registry and land in
+    // context_menu_handle_hotkey()
+    g_mutex_init(&latency_lock);
+    reset_context_menu_latency_stats();
+    
+    // Stream the likely action's result into the popup
+    g_mutex_init(&preview_lock);
+    speculation_set_preview_callback(on_speculation_preview);
+    
+    // INSTANT_TRANSLATOR_REBUILD_MENU=1 rebuilds the popup on every show,
+    // for comparing against the reused window
+    const char* rebuild = getenv("INSTANT_TRANSLATOR_REBUILD_MENU");
+    menu_window_reuse = !(rebuild && strcmp(rebuild, "1") == 0);
+    
+    // Realize the (empty) popup before the first hotkey
+    menu_items_changed();
     return STATUS_SUCCESS;
 }
 
 // Cleanup context menu system
 void cleanup_context_menu_system() {
-    // Stop hotkey monitoring
-    hotkey_monitoring = FALSE;
-    
-    if (hotkey_thread) {
-        g_thread_join(hotkey_thread);
-        hotkey_thread = NULL;
-    }
-    
-    // Ungrab the global hotkey
-    if (x_display) {
-        KeyCode m_code = XKeysymToKeycode(x_display, XK_m);
-        unsigned int modifiers = ControlMask | ShiftMask;
-        Window root = DefaultRootWindow(x_display);
-        
-        XUngrabKey(x_display, m_code, modifiers, root);
-        XUngrabKey(x_display, m_code, modifiers | LockMask, root);
-        XUngrabKey(x_display, m_code, modifiers | Mod2Mask, root);
-        XUngrabKey(x_display, m_code, modifiers | LockMask | Mod2Mask, root);
-        
-        XSync(x_display, False);
-        printf("Global hotkey unregistered\n");
-    }
-    
     // Cleanup menu
     if (popup_menu) {
         gtk_widget_destroy(popup_menu);
         popup_menu = NULL;
     }
+    menu_rebuild_pending = FALSE;
+    if (menu_window) {
+        hide_menu_window();
+        gtk_widget_destroy(menu_window);
+        menu_window = NULL;
+        menu_title_label = NULL;
+        menu_preview_label = NULL;
+    }
+    
+    speculation_set_preview_callback(NULL);
+    g_mutex_lock(&preview_lock);
+    if (preview_text) free(preview_text);
+    if (preview_operation) free(preview_operation);
+    if (preview_partial) free(preview_partial);
+    preview_text = preview_operation = preview_partial = NULL;
+    g_mutex_unlock(&preview_lock);
+    
+    menu_snapshot_unref(menu_window_snapshot);
+    menu_window_snapshot = NULL;
     
     // Cleanup registered menu items
-    if (registered_menu_items) {
-        for (int i = 0; i < menu_item_count; i++) {
-            if (registered_menu_items[i].id) free(registered_menu_items[i].id);
-            if (registered_menu_items[i].label) free(registered_menu_items[i].label);
-            if (registered_menu_items[i].operation) free(registered_menu_items[i].operation);
-            if (registered_menu_items[i].ai_instruction) free(registered_menu_items[i].ai_instruction);
-        }
-        free(registered_menu_items);
-        registered_menu_items = NULL;
-        menu_item_count = 0;
-    }
+    menu_snapshot_unref((MenuSnapshot*)g_atomic_pointer_exchange(&published_menu, NULL));
     
-    // Close X display
-    if (x_display) {
-        XCloseDisplay(x_display);
-        x_display = NULL;
+    if (last_used_menu_id) {
+        free(last_used_menu_id);
+        last_used_menu_id = NULL;
     }
 }
 
@@ -470,40 +823,41 @@ int register_menu_items(MenuItem* menu_items, int count) {
         return STATUS_ERROR_INIT;
     }
     
-    // Cleanup existing menu items
-    unregister_menu_items();
-    
-    // Allocate memory for new menu items
-    registered_menu_items = (MenuItem*)malloc(sizeof(MenuItem) * count);
-    if (!registered_menu_items) {
+    // Build the new snapshot completely before anyone can see it
+    MenuSnapshot* snapshot = (MenuSnapshot*)malloc(sizeof(MenuSnapshot));
+    if (!snapshot) {
+        return STATUS_ERROR_INIT;
+    }
+    snapshot->items = (MenuItem*)malloc(sizeof(MenuItem) * count);
+    if (!snapshot->items) {
+        free(snapshot);
         return STATUS_ERROR_INIT;
     }
     
     // Copy menu items
     for (int i = 0; i < count; i++) {
-        registered_menu_items[i].id = strdup(menu_items[i].id);
-        registered_menu_items[i].label = strdup(menu_items[i].label);
-        registered_menu_items[i].operation = strdup(menu_items[i].operation);
-        registered_menu_items[i].ai_instruction = strdup(menu_items[i].ai_instruction);
-        registered_menu_items[i].enabled = menu_items[i].enabled;
+        snapshot->items[i].id = strdup(menu_items[i].id);
+        snapshot->items[i].label = strdup(menu_items[i].label);
+        snapshot->items[i].operation = strdup(menu_items[i].operation);
+        snapshot->items[i].ai_instruction = strdup(menu_items[i].ai_instruction);
+        snapshot->items[i].enabled = menu_items[i].enabled;
     }
+    snapshot->count = count;
+    snapshot->refcount = 1;  // The published reference
     
-    menu_item_count = count;
+    // Cached results of re-instructed or removed items are now wrong
+    result_cache_sync_menu_items(snapshot->items, count);
+    
+    // Replaces the previous items in one step; an open menu keeps its own
+    publish_menu_snapshot(snapshot);
     return STATUS_SUCCESS;
 }
 
 // Unregister menu items
 int unregister_menu_items() {
-    if (registered_menu_items) {
-        for (int i = 0; i < menu_item_count; i++) {
-            if (registered_menu_items[i].id) free(registered_menu_items[i].id);
-            if (registered_menu_items[i].label) free(registered_menu_items[i].label);
-            if (registered_menu_items[i].operation) free(registered_menu_items[i].operation);
-            if (registered_menu_items[i].ai_instruction) free(registered_menu_items[i].ai_instruction);
-        }
-        free(registered_menu_items);
-        registered_menu_items = NULL;
-        menu_item_count = 0;
+    if (g_atomic_pointer_get(&published_menu)) {
+        result_cache_sync_menu_items(NULL, 0);
+        publish_menu_snapshot(NULL);
     }
     
     return STATUS_SUCCESS;
@@ -522,7 +876,44 @@ int show_context_menu_at(int x, int y, SelectionData* selection) {
     }
     
     // Show menu directly
-    show_menu_at_position(x, y, selection);
+    show_menu_at_position(x, y, selection, g_get_monotonic_time());
+    
+    return STATUS_SUCCESS;
+}
+
+// Hotkey dispatch latency since the last reset
+int get_context_menu_latency_stats(HotkeyLatencyStats* stats) {
+    if (!stats) {
+        return STATUS_ERROR_INIT;
+    }
     
+    g_mutex_lock(&latency_lock);
+    *stats = latency_stats;
+    g_mutex_unlock(&latency_lock);
     return STATUS_SUCCESS;
 }
+
+// Menu request -> first frame latency, for rebuilt and reused windows
+int get_context_menu_frame_stats(HotkeyLatencyStats* rebuilt, HotkeyLatencyStats* reused) {
+    if (!rebuilt || !reused) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    g_mutex_lock(&latency_lock);
+    *rebuilt = frame_stats_rebuilt;
+    *reused = frame_stats_reused;
+    g_mutex_unlock(&latency_lock);
+    return STATUS_SUCCESS;
+}
+
+// Clear the hotkey dispatch latency statistics
+void reset_context_menu_latency_stats() {
+    g_mutex_lock(&latency_lock);
+    memset(&latency_stats, 0, sizeof(latency_stats));
+    latency_total_us = 0;
+    memset(&frame_stats_rebuilt, 0, sizeof(frame_stats_rebuilt));
+    memset(&frame_stats_reused, 0, sizeof(frame_stats_reused));
+    frame_total_rebuilt_us = 0;
+    frame_total_reused_us = 0;
+    g_mutex_unlock(&latency_lock);
+}
@@ -25,6 +25,21 @@ int set_context_menu_callback(MenuActionCallback callback);
 // Show context menu at coordinates
 int show_context_menu_at(int x, int y, SelectionData* selection);
 
+// Handle a bound hotkey press at raw root coordinates (reactor thread).
+// `action` is a HotkeyAction; `menu_item_id` is used for
+// HOTKEY_ACTION_MENU_ITEM.
+void context_menu_handle_hotkey(const char* accelerator, int action, const char* menu_item_id,
+                                int root_x, int root_y);
+
+// Hotkey dispatch latency since the last reset
+int get_context_menu_latency_stats(HotkeyLatencyStats* stats);
+
+// Menu request -> first frame latency, for rebuilt and reused windows
+int get_context_menu_frame_stats(HotkeyLatencyStats* rebuilt, HotkeyLatencyStats* reused);
+
+// Clear the hotkey dispatch and frame latency statistics
+void reset_context_menu_latency_stats();
+
 #ifdef __cplusplus
 }
 #endif
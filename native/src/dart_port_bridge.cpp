@@ -0,0 +1,181 @@
+#include "dart_port_bridge.h"
+#include "text_selection_monitor.h"
+#include "context_menu_injector.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef HAVE_DART_API_DL
+#include "dart_api_dl.h"
+
+// Port events go to; set from the Dart thread, read by event threads
+static GMutex port_lock;
+static int64_t event_port = 0;
+static gboolean api_ready = FALSE;
+
+// Growable little-endian payload; ownership passes to Dart once posted
+typedef struct {
+    uint8_t* data;
+    size_t length;
+    size_t capacity;
+} Payload;
+
+static void payload_put(Payload* payload, const void* bytes, size_t count) {
+    if (payload->length + count > payload->capacity) {
+        size_t capacity = payload->capacity ? payload->capacity : 256;
+        while (capacity < payload->length + count) capacity *= 2;
+        payload->data = (uint8_t*)realloc(payload->data, capacity);
+        payload->capacity = capacity;
+    }
+    memcpy(payload->data + payload->length, bytes, count);
+    payload->length += count;
+}
+
+static void payload_put_i32(Payload* payload, int32_t value) {
+    guint32 le = GUINT32_TO_LE((guint32)value);
+    payload_put(payload, &le, sizeof(le));
+}
+
+static void payload_put_string(Payload* payload, const char* value) {
+    size_t length = value ? strlen(value) : 0;
+    payload_put_i32(payload, (int32_t)length);
+    if (length > 0) {
+        payload_put(payload, value, length);
+    }
+}
+
+static void payload_put_selection(Payload* payload, SelectionData* selection) {
+    payload_put_string(payload, selection->text);
+    payload_put_string(payload, selection->app_name);
+    payload_put_i32(payload, selection->x);
+    payload_put_i32(payload, selection->y);
+}
+
+// Runs when Dart collects the Uint8List
+static void free_payload(void* isolate_callback_data, void* peer) {
+    free(peer);
+}
+
+// Post [kind, payload] without copying the payload
+static void post_event(int32_t kind, Payload* payload) {
+    g_mutex_lock(&port_lock);
+    int64_t port = event_port;
+    g_mutex_unlock(&port_lock);
+
+    if (port == 0) {
+        free(payload->data);
+        return;
+    }
+
+    Dart_CObject kind_object;
+    kind_object.type = Dart_CObject_kInt32;
+    kind_object.value.as_int32 = kind;
+
+    Dart_CObject payload_object;
+    payload_object.type = Dart_CObject_kExternalTypedData;
+    payload_object.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    payload_object.value.as_external_typed_data.length = payload->length;
+    payload_object.value.as_external_typed_data.data = payload->data;
+    payload_object.value.as_external_typed_data.peer = payload->data;
+    payload_object.value.as_external_typed_data.callback = free_payload;
+
+    Dart_CObject* values[2] = {&kind_object, &payload_object};
+    Dart_CObject message;
+    message.type = Dart_CObject_kArray;
+    message.value.as_array.length = 2;
+    message.value.as_array.values = values;
+
+    // On failure Dart never takes the buffer, so the finalizer won't run
+    if (!Dart_PostCObject_DL(port, &message)) {
+        free(payload->data);
+    }
+}
+
+// Selection monitor callback (reactor thread); owns `selection`
+static void post_selection_event(SelectionData* selection) {
+    Payload payload = {NULL, 0, 0};
+    payload_put_selection(&payload, selection);
+    free_selection_data(selection);
+    post_event(DART_EVENT_SELECTION, &payload);
+}
+
+// GTK main thread; `selection` stays with the menu
+void dart_port_bridge_post_menu_action(const char* menu_id, SelectionData* selection) {
+    Payload payload = {NULL, 0, 0};
+    payload_put_string(&payload, menu_id);
+    payload_put_selection(&payload, selection);
+    post_event(DART_EVENT_MENU_ACTION, &payload);
+}
+
+void dart_port_bridge_post_completion(int request_id) {
+    Payload payload = {NULL, 0, 0};
+    payload_put_i32(&payload, request_id);
+    post_event(DART_EVENT_PROCESSING_DONE, &payload);
+}
+
+void dart_port_bridge_post_progress(int request_id, const char* chunk) {
+    Payload payload = {NULL, 0, 0};
+    payload_put_i32(&payload, request_id);
+    payload_put_string(&payload, chunk);
+    post_event(DART_EVENT_PROCESSING_PROGRESS, &payload);
+}
+
+void dart_port_bridge_post_chunk_progress(const char* operation, int completed, int total) {
+    Payload payload = {NULL, 0, 0};
+    payload_put_string(&payload, operation);
+    payload_put_i32(&payload, completed);
+    payload_put_i32(&payload, total);
+    post_event(DART_EVENT_CHUNK_PROGRESS, &payload);
+}
+
+int dart_port_bridge_init(void* api_dl_data) {
+    if (Dart_InitializeApiDL(api_dl_data) != 0) {
+        printf("❌ Dart API DL version mismatch\n");
+        return STATUS_ERROR_INIT;
+    }
+    api_ready = TRUE;
+    return STATUS_SUCCESS;
+}
+
+int dart_port_bridge_set_port(int64_t port) {
+    if (!api_ready) {
+        return STATUS_ERROR_INIT;
+    }
+
+    g_mutex_lock(&port_lock);
+    event_port = port;
+    g_mutex_unlock(&port_lock);
+
+    // The port replaces a raw selection callback. Menu actions are posted
+    // by the menu itself, next to its callback or the action channel.
+    set_text_selection_callback(port ? post_selection_event : NULL);
+
+    printf("%s Dart event port %s\n", port ? "✅" : "📴", port ? "attached" : "detached");
+    return STATUS_SUCCESS;
+}
+
+#else // HAVE_DART_API_DL
+
+int dart_port_bridge_init(void* api_dl_data) {
+    printf("⚠️  Built without Dart API DL; event ports unavailable\n");
+    return STATUS_ERROR_INIT;
+}
+
+int dart_port_bridge_set_port(int64_t port) {
+    return STATUS_ERROR_INIT;
+}
+
+void dart_port_bridge_post_menu_action(const char* menu_id, SelectionData* selection) {
+}
+
+void dart_port_bridge_post_completion(int request_id) {
+}
+
+void dart_port_bridge_post_progress(int request_id, const char* chunk) {
+}
+
+void dart_port_bridge_post_chunk_progress(const char* operation, int completed, int total) {
+}
+
+#endif // HAVE_DART_API_DL
@@ -0,0 +1,53 @@
+#ifndef DART_PORT_BRIDGE_H
+#define DART_PORT_BRIDGE_H
+
+#include "../include/instant_translator.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Events posted to the Dart port are a two-element array:
+//   [int kind, Uint8List payload]
+// The payload is external typed data (handed over, not copied) holding
+// little-endian fields; strings are u32 length + UTF-8 bytes.
+//   DART_EVENT_SELECTION:   text, app_name, i32 x, i32 y
+//   DART_EVENT_MENU_ACTION: menu_id, text, app_name, i32 x, i32 y
+#define DART_EVENT_SELECTION 1
+#define DART_EVENT_MENU_ACTION 2
+//   DART_EVENT_PROCESSING_DONE: i32 request_id (claim it with
+//                               take_processing_result)
+#define DART_EVENT_PROCESSING_DONE 3
+//   DART_EVENT_PROCESSING_PROGRESS: i32 request_id, chunk (append it to
+//                                   what earlier events delivered)
+#define DART_EVENT_PROCESSING_PROGRESS 4
+//   DART_EVENT_CHUNK_PROGRESS: operation, i32 completed, i32 total
+#define DART_EVENT_CHUNK_PROGRESS 5
+
+// Hook up Dart_PostCObject from NativeApi.initializeApiDLData. Returns
+// STATUS_SUCCESS, or STATUS_ERROR_INIT when the library was built without
+// the Dart API DL sources or the Dart VM is incompatible.
+int dart_port_bridge_init(void* api_dl_data);
+
+// Post selection and menu-action events to `port` (0 stops posting)
+int dart_port_bridge_set_port(int64_t port);
+
+// Post a chosen menu item, if a port is attached (GTK main thread). Sent in
+// addition to the native callback or action channel delivery.
+void dart_port_bridge_post_menu_action(const char* menu_id, SelectionData* selection);
+
+// Announce that an asynchronous processing request finished (any thread)
+void dart_port_bridge_post_completion(int request_id);
+
+// Forward one streamed chunk of a processing request (any thread)
+void dart_port_bridge_post_progress(int request_id, const char* chunk);
+
+// Report how many chunks of a long selection are done (any thread)
+void dart_port_bridge_post_chunk_progress(const char* operation, int completed, int total);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DART_PORT_BRIDGE_H
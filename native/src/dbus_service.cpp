@@ -1,122 +1,367 @@
 #include "dbus_service.h"
+#include "speculative_processing.h"
+#include "dart_port_bridge.h"
+#include "result_cache.h"
+#include "segmented_processing.h"
+#include "translation_memory.h"
+#include "chunked_processing.h"
+#include "admission_control.h"
+#include "processing_scheduler.h"
 #include <dbus/dbus.h>
 #include <dbus/dbus-glib.h>
+#include <glib.h>
+#include <glib-unix.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
 // D-Bus connection
 static DBusConnection* connection = NULL;
+
+// Direct connection to the backend, bypassing dbus-daemon. The backend
+// finds peer_server's address with GetPeerAddress on the bus and connects;
+// requests then go over it while it lasts. A new connection replaces the
+// current one only once it has authenticated as our own user.
+static DBusServer* peer_server = NULL;
+static GMutex peer_lock;
+static DBusConnection* peer_connection = NULL;  // Guarded by peer_lock
+static GList* peer_links = NULL;                // PeerLink*, guarded by peer_lock
+
+// How long a new peer connection gets to authenticate
+#define PEER_AUTH_TIMEOUT_MS 5000
+
+// One accepted peer connection and the thread dispatching it
+typedef struct {
+    DBusConnection* conn;   // The thread's reference
+    GThread* thread;
+    gboolean done;          // The thread has returned; guarded by peer_lock
+} PeerLink;
 static DBusError error;
 
+// Dispatcher thread that completes pending calls
+static GThread* dispatch_thread = NULL;
+static gint dispatch_running = 0;
+
+// Set on threads that dispatch a connection; they can't wait for a reply
+// they would have to dispatch themselves
+static GPrivate dispatcher_thread_key = G_PRIVATE_INIT(NULL);
+
+// Pending-call data slot marking a call whose reply has been claimed: the
+// notify and start_pending_call may both try to deliver it
+static dbus_int32_t reply_claimed_slot = -1;
+
+typedef struct Flight Flight;
+
+// One asynchronous ProcessText (or ProcessTextStream) call
+typedef struct {
+    gint refcount;          // Request table + libdbus notify + transient lookups
+    int id;
+    int timeout_ms;
+    gint64 created_at;
+    AdmissionTicket* ticket;    // Backend slot (or place in its queue) until finished
+    int priority;           // ProcessingPriority it was admitted at
+    DBusPendingCall* call;  // Dropped once the request finishes
+    DBusConnection* conn;   // The current call's (ref'd), or NULL
+    ProcessingCallback callback;
+    ProcessingProgressCallback progress;
+    void* user_data;
+    gint finished;          // Set once by whoever completes the request
+    gboolean parked;        // Outcome waiting for take_processing_result
+    int status;
+    char* result;
+    
+    // Chunks of streaming requests arrive on the dispatcher thread
+    gboolean streaming;
+    char* text;             // Kept to send once admitted, or resend as ProcessText
+    char* operation;
+    GString* partial;       // Everything received so far
+    guint32 next_chunk;     // Chunks below this sequence are duplicates
+    
+    // Text sent as a memfd, kept (-1 otherwise) until the backend has shown
+    // it takes ProcessTextFd, to resend inline if it doesn't
+    int payload_fd;
+    
+    // Released with the request
+    GDestroyNotify user_data_free;
+    
+    // Requests made by callers ride on a flight's call instead of their own
+    Flight* flight;
+    size_t delivered;       // Bytes of the flight's partial result posted to Dart
+} PendingRequest;
+
+// In-flight and unclaimed requests by id, guarded by requests_lock
+static GMutex requests_lock;
+static GHashTable* requests = NULL;
+static gint next_request_id = 1;
+
+// Identical (text, operation) requests in flight share one call: the first
+// starts an internal request, the rest join it. Every caller keeps its own
+// id, callback and cancellation; the shared call is only cancelled once
+// no caller is left.
+struct Flight {
+    gint refcount;          // Flight table entry + the shared request
+    char* key;              // mode \x1f operation \x1f text, see flight_key
+    char* text;             // What the shared request sends, to reissue it
+    char* operation;
+    gboolean streaming;
+    int upstream_id;        // The shared request; 0 until it has been sent
+    GList* members;         // PendingRequest* (ref'd), guarded by flights_lock
+    gboolean landed;        // Members have been handed the outcome
+    int priority;           // Most urgent member's
+};
+
+static GMutex flights_lock;
+static GHashTable* flights = NULL;  // key -> Flight*, guarded by flights_lock
+
+// What the backend at the other end of one connection turned out to
+// lack, kept with the connection: an older backend (or our own name) on
+// the bus says nothing about one that connects directly later
+typedef struct {
+    gint batch_unsupported;     // ProcessTextBatch
+    gint streaming_unsupported; // ProcessTextStream
+    gint hint_unsupported;      // ProcessTextWithHint
+    gint fd_unsupported;        // ProcessTextFd
+    gint fd_confirmed;          // ProcessTextFd has answered once
+} BackendFeatures;
+
+static dbus_int32_t features_slot = -1;
+static BackendFeatures no_features;     // For a connection without its own
+
+// Multi-sentence selections are processed sentence by sentence
+static gint segmentation_enabled = 1;
+
 // Service and interface names
 #define DBUS_SERVICE_NAME "com.instantai.Translator"
 #define DBUS_OBJECT_PATH "/com/instantai/Translator"
 #define DBUS_INTERFACE_NAME "com.instantai.Translator"
 
-// Initialize D-Bus service
-int init_dbus_service() {
-    // Initialize error
-    dbus_error_init(&error);
+// Streamed partial results, only from the backend's name
+#define DBUS_RESULT_CHUNK_MATCH \
+    "type='signal',sender='" DBUS_SERVICE_NAME "',interface='" DBUS_INTERFACE_NAME "',member='ResultChunk'"
+
+// Give a new connection its own (all unknown) BackendFeatures
+static void attach_features(DBusConnection* conn) {
+    BackendFeatures* features = (BackendFeatures*)calloc(1, sizeof(BackendFeatures));
+    if (!dbus_connection_set_data(conn, features_slot, features, free)) {
+        free(features);
+    }
+}
+
+static BackendFeatures* features_of(DBusConnection* conn) {
+    BackendFeatures* features = conn ? (BackendFeatures*)dbus_connection_get_data(conn, features_slot) : NULL;
+    return features ? features : &no_features;
+}
+
+// Connection requests should use: the backend's direct peer connection
+// once it is authenticated, otherwise the session bus. Unref when done.
+static DBusConnection* acquire_request_connection() {
+    DBusConnection* conn = NULL;
+    g_mutex_lock(&peer_lock);
+    if (peer_connection && dbus_connection_get_is_connected(peer_connection) &&
+        dbus_connection_get_is_authenticated(peer_connection)) {
+        conn = dbus_connection_ref(peer_connection);
+    }
+    g_mutex_unlock(&peer_lock);
     
-    // Connect to session bus
-    connection = dbus_bus_get(DBUS_BUS_SESSION, &error);
-    if (dbus_error_is_set(&error)) {
-        dbus_error_free(&error);
-        return STATUS_ERROR_DBUS;
+    if (!conn && connection) {
+        conn = dbus_connection_ref(connection);
+    }
+    return conn;
+}
+
+// Copy `text` into a memfd sealed against any further change, so the
+// backend can map it without defending against us. Returns the fd or -1.
+static int create_payload_fd(const char* text, size_t length) {
+    int fd = memfd_create("instant-translator-text", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        return -1;
     }
     
-    if (!connection) {
-        return STATUS_ERROR_DBUS;
+    size_t written = 0;
+    while (written < length) {
+        ssize_t count = write(fd, text + written, length - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            close(fd);
+            return -1;
+        }
+        written += count;
     }
     
-    // Request service name
-    int result = dbus_bus_request_name(connection, DBUS_SERVICE_NAME,
-                                      DBUS_NAME_FLAG_REPLACE_EXISTING, &error);
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Read a whole text payload fd of at most `max_length` bytes into a
+// malloc'd string. Only sealed memfds are accepted, so the sender can't
+// change or truncate the text while it is read; NULL for anything else.
+static char* read_payload_fd(int fd, size_t max_length) {
+    struct stat info;
+    if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode)) {
+        return NULL;
+    }
+    if ((guint64)info.st_size > max_length) {
+        printf("⚠️  Rejected a %lld byte payload fd\n", (long long)info.st_size);
+        return NULL;
+    }
     
-    if (dbus_error_is_set(&error)) {
-        dbus_error_free(&error);
-        cleanup_dbus_service();
-        return STATUS_ERROR_DBUS;
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) != (F_SEAL_SHRINK | F_SEAL_WRITE)) {
+        printf("⚠️  Rejected a payload fd that is not a sealed memfd\n");
+        return NULL;
     }
     
-    if (result != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
-        cleanup_dbus_service();
-        return STATUS_ERROR_DBUS;
+    size_t length = info.st_size;
+    char* text = (char*)malloc(length + 1);
+    if (!text) {
+        return NULL;
     }
     
-    return STATUS_SUCCESS;
-}
-
-// Cleanup D-Bus service
-void cleanup_dbus_service() {
-    if (connection) {
-        // Release service name
-        dbus_bus_release_name(connection, DBUS_SERVICE_NAME, &error);
-        if (dbus_error_is_set(&error)) {
-            dbus_error_free(&error);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t count = pread(fd, text + done, length - done, done);
+        if (count < 0 && errno == EINTR) {
+            continue;
         }
-        
-        // Don't close shared connections - just unref
-        dbus_connection_unref(connection);
-        connection = NULL;
+        if (count <= 0) {
+            break;
+        }
+        done += count;
     }
+    
+    text[done] = '\0';
+    return text;
 }
 
-// Send processing request to Flutter app
-int send_processing_request(const char* text, const char* operation, char** result) {
-    if (!connection || !text || !operation || !result) {
-        return STATUS_ERROR_DBUS;
-    }
+// Whether `text` should travel over `conn` as a memfd rather than inline
+static gboolean wants_payload_fd(DBusConnection* conn, const char* text) {
+    return !g_atomic_int_get(&features_of(conn)->fd_unsupported) &&
+           strlen(text) > DBUS_INLINE_PAYLOAD_MAX &&
+           dbus_connection_can_send_type(conn, DBUS_TYPE_UNIX_FD);
+}
+
+// Build a ProcessText(text, operation) method call, or for large text a
+// ProcessTextFd(h text, s operation) call. In the latter case the memfd
+// is handed back in `payload_fd` (else -1) for the caller to close.
+static DBusMessage* new_process_text_message(DBusConnection* conn, const char* text, const char* operation,
+                                             int* payload_fd) {
+    *payload_fd = -1;
     
-    *result = NULL;
+    int fd = -1;
+    if (wants_payload_fd(conn, text)) {
+        fd = create_payload_fd(text, strlen(text));
+        if (fd < 0) {
+            printf("⚠️  memfd unavailable (%s), sending text inline\n", strerror(errno));
+        }
+    }
     
     // Create method call message
     DBusMessage* message = dbus_message_new_method_call(
         DBUS_SERVICE_NAME,      // destination
         DBUS_OBJECT_PATH,       // object path
         DBUS_INTERFACE_NAME,    // interface
-        "ProcessText"           // method
+        fd >= 0 ? "ProcessTextFd" : "ProcessText"  // method
     );
     
     if (!message) {
-        return STATUS_ERROR_DBUS;
+        if (fd >= 0) close(fd);
+        return NULL;
     }
     
-    // Add arguments
+    // Add arguments; libdbus duplicates the fd
     DBusMessageIter args;
     dbus_message_iter_init_append(message, &args);
     
-    if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &text) ||
+    dbus_bool_t appended = fd >= 0
+        ? dbus_message_iter_append_basic(&args, DBUS_TYPE_UNIX_FD, &fd)
+        : dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &text);
+    if (!appended ||
         !dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &operation)) {
+        if (fd >= 0) close(fd);
         dbus_message_unref(message);
-        return STATUS_ERROR_DBUS;
+        return NULL;
     }
     
-    // Send message and get reply
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(
-        connection, message, 30000, &error); // 30 second timeout
-    
-    dbus_message_unref(message);
-    
-    if (dbus_error_is_set(&error)) {
-        dbus_error_free(&error);
-        return STATUS_ERROR_DBUS;
+    *payload_fd = fd;
+    return message;
+}
+
+// True for the error a backend without some optional method returns
+static gboolean is_unknown_method(DBusMessage* reply) {
+    return dbus_message_get_type(reply) == DBUS_MESSAGE_TYPE_ERROR &&
+           dbus_message_get_error_name(reply) &&
+           strcmp(dbus_message_get_error_name(reply), DBUS_ERROR_UNKNOWN_METHOD) == 0;
+}
+
+// The backend on `conn` has no ProcessTextFd; large text goes inline to it
+static void payload_fd_unsupported(DBusConnection* conn) {
+    BackendFeatures* features = features_of(conn);
+    if (!g_atomic_int_get(&features->fd_unsupported)) {
+        printf("⚠️  Backend has no ProcessTextFd, large text goes inline\n");
+        g_atomic_int_set(&features->fd_unsupported, 1);
+    }
+}
+
+// Status for a failed blocking call
+static int status_from_error(const DBusError* call_error) {
+    if (dbus_error_has_name(call_error, DBUS_ERROR_NO_REPLY) ||
+        dbus_error_has_name(call_error, DBUS_ERROR_TIMEOUT)) {
+        return STATUS_TIMEOUT;
     }
+    return STATUS_ERROR_DBUS;
+}
+
+// How a blocking call went, as admission control should count it. An
+// unknown method says nothing about the backend's load.
+static int admission_outcome(const DBusError* call_error) {
+    if (!dbus_error_is_set(call_error)) {
+        return STATUS_SUCCESS;
+    }
+    if (dbus_error_has_name(call_error, DBUS_ERROR_UNKNOWN_METHOD)) {
+        return STATUS_CANCELLED;
+    }
+    return status_from_error(call_error);
+}
+
+// Turn a ProcessText reply (or error reply) into a status and result
+static int read_process_text_reply(DBusMessage* reply, char** result) {
+    *result = NULL;
     
-    if (!reply) {
+    if (dbus_message_get_type(reply) == DBUS_MESSAGE_TYPE_ERROR) {
+        const char* name = dbus_message_get_error_name(reply);
+        if (name && (strcmp(name, DBUS_ERROR_NO_REPLY) == 0 ||
+                     strcmp(name, DBUS_ERROR_TIMEOUT) == 0)) {
+            return STATUS_TIMEOUT;
+        }
         return STATUS_ERROR_DBUS;
     }
     
     // Read reply
     DBusMessageIter reply_args;
     if (!dbus_message_iter_init(reply, &reply_args)) {
-        dbus_message_unref(reply);
         return STATUS_ERROR_DBUS;
     }
     
+    // Large results come back the way large text went out
+    if (dbus_message_iter_get_arg_type(&reply_args) == DBUS_TYPE_UNIX_FD) {
+        int fd;
+        dbus_message_iter_get_basic(&reply_args, &fd);
+        *result = read_payload_fd(fd, DBUS_PAYLOAD_FD_MAX);
+        close(fd);
+        return *result ? STATUS_SUCCESS : STATUS_ERROR_DBUS;
+    }
+    
     if (dbus_message_iter_get_arg_type(&reply_args) != DBUS_TYPE_STRING) {
-        dbus_message_unref(reply);
         return STATUS_ERROR_DBUS;
     }
     
@@ -125,8 +370,1776 @@ int send_processing_request(const char* text, const char* operation, char** resu
     
     // Copy result
     *result = strdup(reply_text);
+    return STATUS_SUCCESS;
+}
+
+static void flight_unref(void* data);
+
+static PendingRequest* request_ref(PendingRequest* request) {
+    g_atomic_int_inc(&request->refcount);
+    return request;
+}
+
+static void request_unref(void* data) {
+    PendingRequest* request = (PendingRequest*)data;
+    if (g_atomic_int_dec_and_test(&request->refcount)) {
+        if (request->result) free(request->result);
+        if (request->text) free(request->text);
+        if (request->operation) free(request->operation);
+        if (request->partial) g_string_free(request->partial, TRUE);
+        if (request->payload_fd >= 0) close(request->payload_fd);
+        if (request->conn) dbus_connection_unref(request->conn);
+        if (request->user_data_free) request->user_data_free(request->user_data);
+        if (request->flight) flight_unref(request->flight);
+        free(request);
+    }
+}
+
+// Look up a request and take a reference to it
+static PendingRequest* lookup_request(int request_id) {
+    g_mutex_lock(&requests_lock);
+    PendingRequest* request = (PendingRequest*)g_hash_table_lookup(requests, GINT_TO_POINTER(request_id));
+    if (request) {
+        request_ref(request);
+    }
+    g_mutex_unlock(&requests_lock);
+    return request;
+}
+
+// Drop a request from the table (and the table's reference)
+static void forget_request(int request_id) {
+    g_mutex_lock(&requests_lock);
+    PendingRequest* request = (PendingRequest*)g_hash_table_lookup(requests, GINT_TO_POINTER(request_id));
+    if (request) {
+        g_hash_table_remove(requests, GINT_TO_POINTER(request_id));
+    }
+    g_mutex_unlock(&requests_lock);
+    
+    if (request) {
+        request_unref(request);
+    }
+}
+
+// Give back the request's backend slot, or its place in the queue
+static void end_admission(PendingRequest* request, int status) {
+    g_mutex_lock(&requests_lock);
+    AdmissionTicket* ticket = request->ticket;
+    request->ticket = NULL;
+    g_mutex_unlock(&requests_lock);
+    
+    if (ticket && !admission_withdraw(ticket)) {
+        admission_release(ticket, status);
+    }
+}
+
+// Deliver a request's outcome exactly once. Takes ownership of `result`.
+static void finish_request(PendingRequest* request, int status, char* result) {
+    if (!g_atomic_int_compare_and_exchange(&request->finished, 0, 1)) {
+        if (result) free(result);
+        return;
+    }
+    end_admission(request, status);
+    
+    // The pending call has nothing more to tell us
+    g_mutex_lock(&requests_lock);
+    DBusPendingCall* call = request->call;
+    request->call = NULL;
+    g_mutex_unlock(&requests_lock);
+    if (call) {
+        dbus_pending_call_unref(call);
+    }
+    
+    if (request->callback) {
+        // The callback only borrows the result
+        request->callback(request->id, status, result, request->user_data);
+        if (result) free(result);
+        forget_request(request->id);
+        return;
+    }
+    
+    // No callback: park the outcome for take_processing_result
+    g_mutex_lock(&requests_lock);
+    request->status = status;
+    request->result = result;
+    request->parked = TRUE;
+    g_mutex_unlock(&requests_lock);
+    
+    dart_port_bridge_post_completion(request->id);
+}
+
+static gboolean start_pending_call(PendingRequest* request, DBusConnection* conn, DBusMessage* message);
+
+// The backend lacks the optional method this request used: send it again
+// as the plainest call it can take (dispatcher thread)
+static void resend_plain(PendingRequest* request) {
+    // What this call's connection lacks; the request holds it until resent
+    BackendFeatures* features = features_of(request->conn);
+    if (request->streaming && !g_atomic_int_get(&features->streaming_unsupported)) {
+        printf("⚠️  Backend has no ProcessTextStream, results won't stream\n");
+        g_atomic_int_set(&features->streaming_unsupported, 1);
+    }
+    
+    // The text is either still in hand or in the memfd we kept
+    char* text = NULL;
+    if (request->payload_fd >= 0) {
+        payload_fd_unsupported(request->conn);
+        text = read_payload_fd(request->payload_fd, G_MAXSIZE);  // Our own
+        close(request->payload_fd);
+        request->payload_fd = -1;
+    }
+    
+    g_mutex_lock(&requests_lock);
+    request->streaming = FALSE;
+    DBusPendingCall* call = request->call;
+    request->call = NULL;
+    g_mutex_unlock(&requests_lock);
+    if (call) {
+        dbus_pending_call_unref(call);
+    }
+    
+    int payload_fd = -1;
+    const char* plain_text = text ? text : request->text;
+    DBusConnection* conn = acquire_request_connection();
+    DBusMessage* message = plain_text && conn
+        ? new_process_text_message(conn, plain_text, request->operation, &payload_fd) : NULL;
+    if (payload_fd >= 0) {
+        close(payload_fd);  // Can't happen once ProcessTextFd is ruled out
+    }
+    if (!message || !start_pending_call(request, conn, message)) {
+        finish_request(request, STATUS_ERROR_DBUS, NULL);
+    }
+    if (message) {
+        dbus_message_unref(message);
+    }
+    if (conn) {
+        dbus_connection_unref(conn);
+    }
+    if (text) {
+        free(text);
+    }
+}
+
+// libdbus notify: the reply (or its timeout) arrived (dispatcher thread)
+static void on_pending_call_complete(DBusPendingCall* call, void* data) {
+    PendingRequest* request = (PendingRequest*)data;
+    
+    // Only the first of the two paths that can get here takes the reply
+    g_mutex_lock(&requests_lock);
+    gboolean claimed = dbus_pending_call_get_data(call, reply_claimed_slot) != NULL;
+    if (!claimed) {
+        dbus_pending_call_set_data(call, reply_claimed_slot, GINT_TO_POINTER(1), NULL);
+    }
+    g_mutex_unlock(&requests_lock);
+    if (claimed) {
+        return;
+    }
+    
+    DBusMessage* reply = dbus_pending_call_steal_reply(call);
+    if (!reply) {
+        // A notification for a call we already replaced
+        g_mutex_lock(&requests_lock);
+        gboolean stale = request->call != call;
+        g_mutex_unlock(&requests_lock);
+        if (!stale) {
+            finish_request(request, STATUS_ERROR_DBUS, NULL);
+        }
+        return;
+    }
+    
+    if ((request->streaming || request->payload_fd >= 0) && is_unknown_method(reply)) {
+        dbus_message_unref(reply);
+        resend_plain(request);
+        return;
+    }
     
+    if (request->payload_fd >= 0 && dbus_message_get_type(reply) != DBUS_MESSAGE_TYPE_ERROR) {
+        g_atomic_int_set(&features_of(request->conn)->fd_confirmed, 1);
+    }
+    
+    char* result = NULL;
+    int status = read_process_text_reply(reply, &result);
     dbus_message_unref(reply);
+    finish_request(request, status, result);
+}
+
+// ResultChunk(i request_id, u sequence, s chunk) from the backend, on the
+// connection its request went out on (dispatcher or peer thread)
+static DBusHandlerResult on_connection_message(DBusConnection* conn, DBusMessage* message, void* data) {
+    // Discovery: GetPeerAddress() -> s, empty when peer mode is off
+    if (dbus_message_is_method_call(message, DBUS_INTERFACE_NAME, "GetPeerAddress")) {
+        char* address = peer_server ? dbus_server_get_address(peer_server) : NULL;
+        const char* reply_address = address ? address : "";
+        DBusMessage* reply = dbus_message_new_method_return(message);
+        if (reply) {
+            dbus_message_append_args(reply, DBUS_TYPE_STRING, &reply_address, DBUS_TYPE_INVALID);
+            dbus_connection_send(conn, reply, NULL);
+            dbus_message_unref(reply);
+        }
+        if (address) dbus_free(address);
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
     
-    return STATUS_SUCCESS;
+    if (!dbus_message_is_signal(message, DBUS_INTERFACE_NAME, "ResultChunk")) {
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+    
+    dbus_int32_t id;
+    dbus_uint32_t sequence;
+    const char* chunk;
+    if (!dbus_message_get_args(message, NULL,
+                               DBUS_TYPE_INT32, &id,
+                               DBUS_TYPE_UINT32, &sequence,
+                               DBUS_TYPE_STRING, &chunk,
+                               DBUS_TYPE_INVALID)) {
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+    
+    // On the bus, a signal sent to us directly skips the match rule and
+    // could come from anyone; a broadcast one reached us through it, so
+    // from the backend's name. Peer connections carry only the backend.
+    if (conn == connection && dbus_message_get_destination(message)) {
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+    
+    PendingRequest* request = lookup_request(id);
+    if (!request) {
+        return DBUS_HANDLER_RESULT_HANDLED;  // Finished, cancelled or not ours
+    }
+    
+    // The bus dispatcher and peer threads all run this filter; `partial`
+    // is only touched under the lock
+    g_mutex_lock(&requests_lock);
+    gboolean fresh = request->partial && request->conn == conn &&
+                     !g_atomic_int_get(&request->finished) && sequence >= request->next_chunk;
+    char* partial = NULL;
+    if (fresh) {
+        g_string_append(request->partial, chunk);
+        request->next_chunk = sequence + 1;
+        if (request->progress) {
+            partial = g_strdup(request->partial->str);
+        }
+    }
+    g_mutex_unlock(&requests_lock);
+    
+    if (partial) {
+        request->progress(request->id, partial, request->user_data);
+        g_free(partial);
+    } else if (fresh && !request->callback) {
+        dart_port_bridge_post_progress(request->id, chunk);
+    }
+    
+    request_unref(request);
+    return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+// Read, dispatch and run pending-call notifications until cleanup
+static void expire_flight_members();
+
+static gpointer dispatch_thread_func(gpointer data) {
+    g_private_set(&dispatcher_thread_key, GINT_TO_POINTER(1));
+    while (g_atomic_int_get(&dispatch_running)) {
+        if (!dbus_connection_read_write_dispatch(connection, 100)) {
+            break;  // Disconnected
+        }
+        expire_flight_members();
+    }
+    return NULL;
+}
+
+// A peer connection authenticated: make it the one requests use, and
+// close the one it replaces
+static void adopt_peer_connection(DBusConnection* peer) {
+    g_mutex_lock(&peer_lock);
+    DBusConnection* replaced = peer_connection;
+    peer_connection = dbus_connection_ref(peer);
+    g_mutex_unlock(&peer_lock);
+    
+    if (replaced) {
+        dbus_connection_close(replaced);  // Its thread sees it and returns
+        dbus_connection_unref(replaced);
+    }
+    printf("🔗 Backend connected directly, bypassing the session bus\n");
+}
+
+// Dispatch one peer connection until it drops or is replaced. It takes
+// over from the current one once authenticated, and is closed if that
+// takes too long.
+static gpointer peer_thread_func(gpointer data) {
+    PeerLink* link = (PeerLink*)data;
+    DBusConnection* peer = link->conn;
+    g_private_set(&dispatcher_thread_key, GINT_TO_POINTER(1));
+    
+    gint64 auth_deadline = g_get_monotonic_time() + (gint64)PEER_AUTH_TIMEOUT_MS * 1000;
+    gboolean adopted = FALSE;
+    while (g_atomic_int_get(&dispatch_running) &&
+           dbus_connection_read_write_dispatch(peer, 100)) {
+        if (adopted) {
+            continue;
+        }
+        if (dbus_connection_get_is_authenticated(peer)) {
+            adopt_peer_connection(peer);
+            adopted = TRUE;
+        } else if (g_get_monotonic_time() >= auth_deadline) {
+            printf("⚠️  Peer connection did not authenticate in time, closing it\n");
+            dbus_connection_close(peer);
+            break;
+        }
+    }
+    
+    g_mutex_lock(&peer_lock);
+    gboolean current = peer_connection == peer;
+    if (current) {
+        peer_connection = NULL;
+        dbus_connection_unref(peer);  // The slot's reference
+    }
+    link->done = TRUE;
+    g_mutex_unlock(&peer_lock);
+    
+    if (current) {
+        printf("📴 Backend peer connection closed, requests use the session bus\n");
+    }
+    return NULL;
+}
+
+// Join peer threads that have returned, or every one of them (closing
+// their connections first) when `all` is set
+static void reap_peer_links(gboolean all) {
+    GList* reaped = NULL;
+    g_mutex_lock(&peer_lock);
+    for (GList* node = peer_links; node;) {
+        GList* next = node->next;
+        PeerLink* link = (PeerLink*)node->data;
+        if (all || link->done) {
+            peer_links = g_list_delete_link(peer_links, node);
+            reaped = g_list_prepend(reaped, link);
+        }
+        node = next;
+    }
+    g_mutex_unlock(&peer_lock);
+    
+    for (GList* node = reaped; node; node = node->next) {
+        PeerLink* link = (PeerLink*)node->data;
+        if (all) {
+            dbus_connection_close(link->conn);
+        }
+        g_thread_join(link->thread);
+        dbus_connection_unref(link->conn);
+        free(link);
+    }
+    g_list_free(reaped);
+}
+
+// Close every peer connection and wait for their threads
+static void drop_peer_connection() {
+    reap_peer_links(TRUE);
+    
+    g_mutex_lock(&peer_lock);
+    DBusConnection* peer = peer_connection;
+    peer_connection = NULL;
+    g_mutex_unlock(&peer_lock);
+    if (peer) {
+        dbus_connection_unref(peer);
+    }
+}
+
+// Only our own user may stand in for the backend
+static dbus_bool_t allow_peer_user(DBusConnection* conn, unsigned long uid, void* data) {
+    return uid == (unsigned long)getuid();
+}
+
+// Something connected to the peer socket (GTK main thread). Abstract
+// socket names are visible to every local user, so the current backend
+// connection stays until this one authenticates on its own thread.
+static void on_new_peer_connection(DBusServer* server, DBusConnection* peer, void* data) {
+    reap_peer_links(FALSE);
+    
+    dbus_connection_set_exit_on_disconnect(peer, FALSE);
+    dbus_connection_set_unix_user_function(peer, allow_peer_user, NULL, NULL);
+    attach_features(peer);
+    dbus_connection_add_filter(peer, on_connection_message, NULL, NULL);
+    
+    PeerLink* link = (PeerLink*)calloc(1, sizeof(PeerLink));
+    link->conn = dbus_connection_ref(peer);
+    g_mutex_lock(&peer_lock);
+    link->thread = g_thread_new("dbus-peer", peer_thread_func, link);
+    peer_links = g_list_prepend(peer_links, link);
+    g_mutex_unlock(&peer_lock);
+}
+
+// DBusServer watches, served from the GTK main loop like the action channel
+static gboolean on_peer_server_watch(gint fd, GIOCondition condition, gpointer data) {
+    unsigned int flags = 0;
+    if (condition & G_IO_IN) flags |= DBUS_WATCH_READABLE;
+    if (condition & G_IO_OUT) flags |= DBUS_WATCH_WRITABLE;
+    if (condition & G_IO_HUP) flags |= DBUS_WATCH_HANGUP;
+    if (condition & G_IO_ERR) flags |= DBUS_WATCH_ERROR;
+    dbus_watch_handle((DBusWatch*)data, flags);
+    return TRUE;
+}
+
+static dbus_bool_t add_peer_server_watch(DBusWatch* watch, void* data) {
+    if (!dbus_watch_get_enabled(watch)) {
+        return TRUE;  // Added by toggle once enabled
+    }
+    
+    unsigned int flags = dbus_watch_get_flags(watch);
+    int condition = G_IO_HUP | G_IO_ERR;
+    if (flags & DBUS_WATCH_READABLE) condition |= G_IO_IN;
+    if (flags & DBUS_WATCH_WRITABLE) condition |= G_IO_OUT;
+    
+    guint source = g_unix_fd_add(dbus_watch_get_unix_fd(watch), (GIOCondition)condition,
+                                 on_peer_server_watch, watch);
+    dbus_watch_set_data(watch, GUINT_TO_POINTER(source), NULL);
+    return TRUE;
+}
+
+static void remove_peer_server_watch(DBusWatch* watch, void* data) {
+    guint source = GPOINTER_TO_UINT(dbus_watch_get_data(watch));
+    if (source) {
+        g_source_remove(source);
+        dbus_watch_set_data(watch, NULL, NULL);
+    }
+}
+
+static void toggle_peer_server_watch(DBusWatch* watch, void* data) {
+    remove_peer_server_watch(watch, data);
+    add_peer_server_watch(watch, data);
+}
+
+// Listen for the backend on a private abstract socket. Not fatal: without
+// it everything keeps going through the bus.
+static void start_peer_server() {
+    // INSTANT_TRANSLATOR_DBUS_PEER=0 keeps all traffic on the session bus
+    const char* peer_mode = getenv("INSTANT_TRANSLATOR_DBUS_PEER");
+    if (peer_mode && strcmp(peer_mode, "0") == 0) {
+        return;
+    }
+    
+    char* address = g_strdup_printf("unix:abstract=instant-translator-%d-%08x",
+                                    (int)getpid(), g_random_int());
+    DBusError listen_error;
+    dbus_error_init(&listen_error);
+    peer_server = dbus_server_listen(address, &listen_error);
+    g_free(address);
+    
+    if (!peer_server) {
+        printf("⚠️  Peer D-Bus server unavailable: %s\n",
+               dbus_error_is_set(&listen_error) ? listen_error.message : "unknown error");
+        dbus_error_free(&listen_error);
+        return;
+    }
+    
+    dbus_server_set_new_connection_function(peer_server, on_new_peer_connection, NULL, NULL);
+    if (!dbus_server_set_watch_functions(peer_server, add_peer_server_watch, remove_peer_server_watch,
+                                         toggle_peer_server_watch, NULL, NULL)) {
+        dbus_server_disconnect(peer_server);
+        dbus_server_unref(peer_server);
+        peer_server = NULL;
+        return;
+    }
+    
+    char* listening = dbus_server_get_address(peer_server);
+    printf("✅ Peer D-Bus server listening on %s\n", listening);
+    dbus_free(listening);
+}
+
+// Initialize D-Bus service
+int init_dbus_service() {
+    // Requests come from several threads and complete on the dispatcher
+    dbus_threads_init_default();
+
+    // Initialize error
+    dbus_error_init(&error);
+    
+    // Connect to session bus
+    connection = dbus_bus_get(DBUS_BUS_SESSION, &error);
+    if (dbus_error_is_set(&error)) {
+        dbus_error_free(&error);
+        return STATUS_ERROR_DBUS;
+    }
+    
+    if (!connection) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    // Request service name
+    // Never take the name from, or queue behind, another running instance
+    int result = dbus_bus_request_name(connection, DBUS_SERVICE_NAME,
+                                      DBUS_NAME_FLAG_DO_NOT_QUEUE, &error);
+    
+    if (dbus_error_is_set(&error)) {
+        printf("❌ Could not request %s: %s\n", DBUS_SERVICE_NAME, error.message);
+        dbus_error_free(&error);
+        cleanup_dbus_service();
+        return STATUS_ERROR_DBUS;
+    }
+    
+    if (result != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER &&
+        result != DBUS_REQUEST_NAME_REPLY_ALREADY_OWNER) {
+        printf("❌ %s is already owned by another instance\n", DBUS_SERVICE_NAME);
+        cleanup_dbus_service();
+        return STATUS_ERROR_DBUS;
+    }
+    
+    if (!dbus_pending_call_allocate_data_slot(&reply_claimed_slot) ||
+        !dbus_connection_allocate_data_slot(&features_slot)) {
+        cleanup_dbus_service();
+        return STATUS_ERROR_DBUS;
+    }
+    attach_features(connection);
+    
+    // Partial results arrive as signals; without the match the bus drops them
+    dbus_bus_add_match(connection, DBUS_RESULT_CHUNK_MATCH, NULL);
+    dbus_connection_add_filter(connection, on_connection_message, NULL, NULL);
+    
+    // Start completing asynchronous requests
+    g_mutex_init(&requests_lock);
+    requests = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_mutex_init(&flights_lock);
+    flights = g_hash_table_new(g_str_hash, g_str_equal);
+    g_atomic_int_set(&dispatch_running, 1);
+    dispatch_thread = g_thread_new("dbus-dispatch", dispatch_thread_func, NULL);
+    
+    // The bus is only for discovery once the backend connects directly
+    start_peer_server();
+    
+    return STATUS_SUCCESS;
+}
+
+// Cleanup D-Bus service
+void cleanup_dbus_service() {
+    // Stop accepting the backend and drop its direct connection
+    if (peer_server) {
+        dbus_server_disconnect(peer_server);
+        dbus_server_unref(peer_server);
+        peer_server = NULL;
+    }
+    drop_peer_connection();
+    
+    // Stop dispatching, then cancel whatever is still in flight
+    if (dispatch_thread) {
+        g_atomic_int_set(&dispatch_running, 0);
+        g_thread_join(dispatch_thread);
+        dispatch_thread = NULL;
+    }
+    
+    if (requests) {
+        GList* ids = NULL;
+        g_mutex_lock(&requests_lock);
+        GHashTableIter iter;
+        gpointer key, value;
+        g_hash_table_iter_init(&iter, requests);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            ids = g_list_prepend(ids, key);
+        }
+        g_mutex_unlock(&requests_lock);
+        
+        for (GList* node = ids; node; node = node->next) {
+            int id = GPOINTER_TO_INT(node->data);
+            int status;
+            char* result = NULL;
+            cancel_processing_request(id);
+            if (take_processing_result(id, &status, &result) == 1 && result) {
+                free(result);
+            }
+        }
+        g_list_free(ids);
+        
+        g_hash_table_destroy(requests);
+        requests = NULL;
+    }
+    
+    // Every flight landed when its shared request was cancelled above
+    if (flights) {
+        g_hash_table_destroy(flights);
+        flights = NULL;
+    }
+    
+    if (connection) {
+        dbus_connection_remove_filter(connection, on_connection_message, NULL);
+        dbus_bus_remove_match(connection, DBUS_RESULT_CHUNK_MATCH, NULL);
+        
+        // Release service name
+        dbus_bus_release_name(connection, DBUS_SERVICE_NAME, &error);
+        if (dbus_error_is_set(&error)) {
+            dbus_error_free(&error);
+        }
+        
+        // Don't close shared connections - just unref. Our data goes first,
+        // the slot is released below.
+        if (features_slot >= 0) {
+            dbus_connection_set_data(connection, features_slot, NULL, NULL);
+        }
+        dbus_connection_unref(connection);
+        connection = NULL;
+    }
+    
+    if (reply_claimed_slot >= 0) {
+        dbus_pending_call_free_data_slot(&reply_claimed_slot);
+    }
+    if (features_slot >= 0) {
+        dbus_connection_free_data_slot(&features_slot);
+    }
+}
+
+// ProcessText on this thread's own blocking call
+static int process_text_call(const char* text, const char* operation, char** result) {
+    *result = NULL;
+    
+    // The shared error is not thread-safe; each call gets its own
+    DBusError call_error;
+    dbus_error_init(&call_error);
+    
+    DBusConnection* conn = acquire_request_connection();
+    int payload_fd;
+    DBusMessage* message = new_process_text_message(conn, text, operation, &payload_fd);
+    if (!message) {
+        dbus_connection_unref(conn);
+        return STATUS_ERROR_DBUS;
+    }
+    gboolean via_fd = payload_fd >= 0;
+    if (via_fd) {
+        close(payload_fd);  // The message holds its own copy
+    }
+    
+    // Send message and get reply
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(
+        conn, message, DBUS_PROCESSING_TIMEOUT_MS, &call_error);
+    dbus_message_unref(message);
+    
+    // Backend predates ProcessTextFd: retry inline
+    if (via_fd && dbus_error_has_name(&call_error, DBUS_ERROR_UNKNOWN_METHOD)) {
+        dbus_error_free(&call_error);
+        payload_fd_unsupported(conn);
+        dbus_connection_unref(conn);
+        return process_text_call(text, operation, result);
+    }
+    if (via_fd && !dbus_error_is_set(&call_error)) {
+        g_atomic_int_set(&features_of(conn)->fd_confirmed, 1);
+    }
+    dbus_connection_unref(conn);
+    
+    if (dbus_error_is_set(&call_error)) {
+        int status = status_from_error(&call_error);
+        dbus_error_free(&call_error);
+        return status;
+    }
+    
+    if (!reply) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    int status = read_process_text_reply(reply, result);
+    dbus_message_unref(reply);
+    return status;
+}
+
+// process_text_call once admission control lets it through
+static int process_text_blocking(const char* text, const char* operation, char** result) {
+    *result = NULL;
+    AdmissionTicket* ticket;
+    int status = admission_acquire(operation, strlen(text), scheduler_thread_priority(),
+                                   DBUS_PROCESSING_TIMEOUT_MS, &ticket);
+    if (status != STATUS_SUCCESS) {
+        return status;
+    }
+    
+    status = process_text_call(text, operation, result);
+    admission_release(ticket, status);
+    return status;
+}
+
+// Outcome of a flight awaited by a blocking caller
+typedef struct {
+    GMutex lock;
+    GCond cond;
+    gboolean done;
+    int status;
+    char* result;
+} FlightWaiter;
+
+static void on_waiter_done(int request_id, int status, const char* result, void* data) {
+    FlightWaiter* waiter = (FlightWaiter*)data;
+    g_mutex_lock(&waiter->lock);
+    waiter->status = status;
+    waiter->result = result ? strdup(result) : NULL;
+    waiter->done = TRUE;
+    g_cond_signal(&waiter->cond);
+    g_mutex_unlock(&waiter->lock);
+}
+
+// Blocking ProcessText round trip, safe to call from any thread. It rides
+// on an identical request already in flight, if there is one.
+int dbus_process_text(const char* text, const char* operation, char** result) {
+    if (!connection || !text || !operation || !result) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    // A dispatcher thread would wait for a reply only it can dispatch
+    if (g_private_get(&dispatcher_thread_key) || !g_atomic_int_get(&dispatch_running)) {
+        return process_text_blocking(text, operation, result);
+    }
+    
+    FlightWaiter waiter;
+    g_mutex_init(&waiter.lock);
+    g_cond_init(&waiter.cond);
+    waiter.done = FALSE;
+    waiter.status = STATUS_ERROR_DBUS;
+    waiter.result = NULL;
+    
+    int id = send_processing_request_async(text, operation, DBUS_PROCESSING_TIMEOUT_MS,
+                                           on_waiter_done, &waiter);
+    if (id > 0) {
+        g_mutex_lock(&waiter.lock);
+        while (!waiter.done) {
+            g_cond_wait(&waiter.cond, &waiter.lock);
+        }
+        g_mutex_unlock(&waiter.lock);
+    }
+    
+    g_cond_clear(&waiter.cond);
+    g_mutex_clear(&waiter.lock);
+    *result = waiter.result;
+    return id > 0 ? waiter.status : id;
+}
+
+// ProcessText with the closest earlier (text, result) pair attached, so the
+// backend can keep wording consistent with what it produced before
+static int dbus_process_text_with_hint(const char* text, const char* operation,
+                                       const char* hint_source, const char* hint_result,
+                                       double similarity, char** result) {
+    // The features live as long as we hold the connection
+    DBusConnection* conn = acquire_request_connection();
+    BackendFeatures* features = features_of(conn);
+    if (!conn || g_atomic_int_get(&features->hint_unsupported)) {
+        if (conn) dbus_connection_unref(conn);
+        return dbus_process_text(text, operation, result);
+    }
+    
+    *result = NULL;
+    DBusMessage* message = dbus_message_new_method_call(
+        DBUS_SERVICE_NAME,
+        DBUS_OBJECT_PATH,
+        DBUS_INTERFACE_NAME,
+        "ProcessTextWithHint"
+    );
+    if (!message) {
+        dbus_connection_unref(conn);
+        return STATUS_ERROR_DBUS;
+    }
+    if (!dbus_message_append_args(message,
+                                  DBUS_TYPE_STRING, &text,
+                                  DBUS_TYPE_STRING, &operation,
+                                  DBUS_TYPE_STRING, &hint_source,
+                                  DBUS_TYPE_STRING, &hint_result,
+                                  DBUS_TYPE_DOUBLE, &similarity,
+                                  DBUS_TYPE_INVALID)) {
+        dbus_message_unref(message);
+        dbus_connection_unref(conn);
+        return STATUS_ERROR_DBUS;
+    }
+    
+    AdmissionTicket* ticket;
+    int admission = admission_acquire(operation, strlen(text) + strlen(hint_result),
+                                      scheduler_thread_priority(), DBUS_PROCESSING_TIMEOUT_MS, &ticket);
+    if (admission != STATUS_SUCCESS) {
+        dbus_message_unref(message);
+        dbus_connection_unref(conn);
+        return admission;
+    }
+    
+    DBusError call_error;
+    dbus_error_init(&call_error);
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(
+        conn, message, DBUS_PROCESSING_TIMEOUT_MS, &call_error);
+    dbus_message_unref(message);
+    
+    admission_release(ticket, admission_outcome(&call_error));
+    
+    if (dbus_error_has_name(&call_error, DBUS_ERROR_UNKNOWN_METHOD)) {
+        dbus_error_free(&call_error);
+        printf("⚠️  Backend has no ProcessTextWithHint, sending without hints\n");
+        g_atomic_int_set(&features->hint_unsupported, 1);
+        dbus_connection_unref(conn);
+        return dbus_process_text(text, operation, result);
+    }
+    dbus_connection_unref(conn);
+    if (dbus_error_is_set(&call_error)) {
+        int status = status_from_error(&call_error);
+        dbus_error_free(&call_error);
+        return status;
+    }
+    if (!reply) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    int status = read_process_text_reply(reply, result);
+    dbus_message_unref(reply);
+    return status;
+}
+
+// Keep a fresh backend answer for exact and near-duplicate repeats
+static void remember_result(const char* text, const char* operation, const char* result) {
+    result_cache_store(text, operation, result);
+    translation_memory_add(text, operation, result);
+}
+
+// A near-duplicate of an earlier text: serve the earlier result when the
+// serve threshold allows it, else send it along as a hint. FALSE when the
+// translation memory has nothing close enough. `*fresh` tells whether
+// the result came from the backend for exactly this text.
+static gboolean process_with_memory(const char* text, const char* operation, int* status,
+                                    char** result, gboolean* fresh) {
+    double hint_similarity, serve_similarity;
+    translation_memory_get_thresholds(&hint_similarity, &serve_similarity);
+    double threshold = hint_similarity > 0 && (serve_similarity <= 0 || hint_similarity < serve_similarity)
+                           ? hint_similarity : serve_similarity;
+    
+    char* source;
+    char* prior;
+    double similarity;
+    if (threshold <= 0 ||
+        !translation_memory_lookup(text, operation, threshold, &source, &prior, &similarity)) {
+        return FALSE;
+    }
+    
+    if (serve_similarity > 0 && similarity >= serve_similarity) {
+        printf("📚 Served from translation memory (similarity %.2f)\n", similarity);
+        free(source);
+        *result = prior;
+        *status = STATUS_SUCCESS;
+        *fresh = FALSE;
+        return TRUE;
+    }
+    
+    gboolean hinted = hint_similarity > 0 && similarity >= hint_similarity;
+    if (hinted) {
+        *status = dbus_process_text_with_hint(text, operation, source, prior, similarity, result);
+    }
+    free(source);
+    free(prior);
+    return hinted;
+}
+
+void dbus_set_segmentation_enabled(int enabled) {
+    g_atomic_int_set(&segmentation_enabled, enabled ? 1 : 0);
+}
+
+// Process text that isn't in the result cache: sentence by sentence,
+// against the translation memory or as one call
+static int process_uncached(const char* text, const char* operation, char** result) {
+    int status;
+    gboolean fresh = TRUE;
+    gboolean segmented = g_atomic_int_get(&segmentation_enabled) &&
+                         process_by_segments(text, operation, send_processing_batch, &status, result);
+    if (!segmented && !process_with_memory(text, operation, &status, result, &fresh)) {
+        status = dbus_process_text(text, operation, result);
+    }
+    
+    if (status == STATUS_SUCCESS && *result && fresh) {
+        remember_result(text, operation, *result);
+    }
+    return status;
+}
+
+// One chunk of a long selection (chunk pool worker)
+static int process_chunk(const char* chunk, const char* operation, char** result) {
+    if (result_cache_lookup(chunk, operation, result)) {
+        return STATUS_SUCCESS;
+    }
+    return process_uncached(chunk, operation, result);
+}
+
+// Send processing request to Flutter app
+int send_processing_request(const char* text, const char* operation, char** result) {
+    if (!text || !operation || !result) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    // The same text and action again: no round trip at all
+    if (result_cache_lookup(text, operation, result)) {
+        return STATUS_SUCCESS;
+    }
+    
+    // Reuse the request started when the menu opened, if it matches. One
+    // preempted or cancelled meanwhile is just sent again.
+    int status;
+    if (speculation_take(text, operation, &status, result)) {
+        if (status != STATUS_CANCELLED) {
+            if (status == STATUS_SUCCESS && *result) {
+                remember_result(text, operation, *result);
+            }
+            return status;
+        }
+        if (*result) {
+            free(*result);
+            *result = NULL;
+        }
+    }
+    
+    // Too long for one call: chunks in parallel. Their workers need the
+    // dispatcher, so a dispatcher thread sends it whole.
+    if (chunked_processing_wanted(text) && !g_private_get(&dispatcher_thread_key)) {
+        status = process_in_chunks(text, operation, process_chunk, result);
+        if (status == STATUS_SUCCESS) {
+            remember_result(text, operation, *result);
+        }
+        return status;
+    }
+    
+    return process_uncached(text, operation, result);
+}
+
+// Build a ProcessTextBatch(a(iss)) method call
+static DBusMessage* new_process_text_batch_message(const ProcessingSegment* segments, int count) {
+    DBusMessage* message = dbus_message_new_method_call(
+        DBUS_SERVICE_NAME,
+        DBUS_OBJECT_PATH,
+        DBUS_INTERFACE_NAME,
+        "ProcessTextBatch"
+    );
+    
+    if (!message) {
+        return NULL;
+    }
+    
+    DBusMessageIter args, array, entry;
+    dbus_message_iter_init_append(message, &args);
+    if (!dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(iss)", &array)) {
+        dbus_message_unref(message);
+        return NULL;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        dbus_int32_t id = segments[i].id;
+        const char* text = segments[i].text;
+        const char* operation = segments[i].operation;
+        
+        // Only fails when out of memory; the message is discarded whole
+        if (!dbus_message_iter_open_container(&array, DBUS_TYPE_STRUCT, NULL, &entry) ||
+            !dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT32, &id) ||
+            !dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &text) ||
+            !dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &operation) ||
+            !dbus_message_iter_close_container(&array, &entry)) {
+            dbus_message_unref(message);
+            return NULL;
+        }
+    }
+    
+    if (!dbus_message_iter_close_container(&args, &array)) {
+        dbus_message_unref(message);
+        return NULL;
+    }
+    
+    return message;
+}
+
+// Spread an a(iis) reply over `results` using the id -> index+1 table.
+// Unknown or repeated ids are ignored; unanswered segments keep their error.
+static int read_process_text_batch_reply(DBusMessage* reply, GHashTable* index_by_id,
+                                         ProcessingSegmentResult* results, gboolean* answered) {
+    DBusMessageIter args, array, entry;
+    if (!dbus_message_iter_init(reply, &args) ||
+        dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY ||
+        dbus_message_iter_get_element_type(&args) != DBUS_TYPE_STRUCT) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    dbus_message_iter_recurse(&args, &array);
+    while (dbus_message_iter_get_arg_type(&array) == DBUS_TYPE_STRUCT) {
+        dbus_int32_t id, status;
+        const char* text;
+        
+        dbus_message_iter_recurse(&array, &entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_INT32) {
+            return STATUS_ERROR_DBUS;
+        }
+        dbus_message_iter_get_basic(&entry, &id);
+        dbus_message_iter_next(&entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_INT32) {
+            return STATUS_ERROR_DBUS;
+        }
+        dbus_message_iter_get_basic(&entry, &status);
+        dbus_message_iter_next(&entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_STRING) {
+            return STATUS_ERROR_DBUS;
+        }
+        dbus_message_iter_get_basic(&entry, &text);
+        dbus_message_iter_next(&array);
+        
+        int index = GPOINTER_TO_INT(g_hash_table_lookup(index_by_id, GINT_TO_POINTER(id))) - 1;
+        if (index < 0 || answered[index]) {
+            continue;
+        }
+        
+        answered[index] = TRUE;
+        if (status == STATUS_SUCCESS) {
+            results[index].status = STATUS_SUCCESS;
+            results[index].result = strdup(text);
+        } else {
+            // Backends report our StatusCodes; anything else is a plain failure
+            results[index].status = status < 0 ? status : STATUS_ERROR_DBUS;
+        }
+    }
+    
+    return STATUS_SUCCESS;
+}
+
+// Segments of a batch the backend cannot take in one call, awaited together
+typedef struct {
+    GMutex lock;
+    GCond cond;
+    int remaining;
+} SegmentWaiter;
+
+typedef struct {
+    SegmentWaiter* waiter;
+    ProcessingSegmentResult* answer;
+} SegmentSeat;
+
+static void on_segment_done(int request_id, int status, const char* result, void* data) {
+    SegmentSeat* seat = (SegmentSeat*)data;
+    SegmentWaiter* waiter = seat->waiter;
+    g_mutex_lock(&waiter->lock);
+    seat->answer->status = status;
+    seat->answer->result = result ? strdup(result) : NULL;
+    if (--waiter->remaining == 0) {
+        g_cond_signal(&waiter->cond);
+    }
+    g_mutex_unlock(&waiter->lock);
+}
+
+// Send every segment as its own ProcessText at once and wait for all of
+// them, so the batch takes about as long as its slowest segment
+static void process_segments_concurrently(const ProcessingSegment* segments, int count,
+                                          ProcessingSegmentResult* batch) {
+    // A dispatcher thread would wait for replies only it can dispatch
+    if (g_private_get(&dispatcher_thread_key) || !g_atomic_int_get(&dispatch_running)) {
+        for (int i = 0; i < count; i++) {
+            batch[i].status = dbus_process_text(segments[i].text, segments[i].operation, &batch[i].result);
+        }
+        return;
+    }
+    
+    SegmentWaiter waiter;
+    g_mutex_init(&waiter.lock);
+    g_cond_init(&waiter.cond);
+    waiter.remaining = count;
+    SegmentSeat* seats = (SegmentSeat*)malloc(sizeof(SegmentSeat) * count);
+    
+    for (int i = 0; i < count; i++) {
+        seats[i].waiter = &waiter;
+        seats[i].answer = &batch[i];
+        int id = send_processing_request_async(segments[i].text, segments[i].operation,
+                                               DBUS_PROCESSING_TIMEOUT_MS, on_segment_done, &seats[i]);
+        if (id < 0) {
+            // Never started, so no callback will come for it
+            g_mutex_lock(&waiter.lock);
+            batch[i].status = id;
+            waiter.remaining--;
+            g_mutex_unlock(&waiter.lock);
+        }
+    }
+    
+    g_mutex_lock(&waiter.lock);
+    while (waiter.remaining > 0) {
+        g_cond_wait(&waiter.cond, &waiter.lock);
+    }
+    g_mutex_unlock(&waiter.lock);
+    
+    g_cond_clear(&waiter.cond);
+    g_mutex_clear(&waiter.lock);
+    free(seats);
+}
+
+// One ProcessTextBatch round trip for every segment
+int send_processing_batch(const ProcessingSegment* segments, int count, ProcessingSegmentResult** results) {
+    if (!results) {
+        return STATUS_ERROR_INIT;
+    }
+    *results = NULL;
+    
+    if (!connection) {
+        return STATUS_ERROR_DBUS;
+    }
+    if (count <= 0) {
+        return count == 0 ? STATUS_SUCCESS : STATUS_ERROR_INIT;
+    }
+    if (!segments) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    // Ids must be unique to route the unordered reply
+    GHashTable* index_by_id = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (int i = 0; i < count; i++) {
+        if (!segments[i].text || !segments[i].operation ||
+            g_hash_table_contains(index_by_id, GINT_TO_POINTER(segments[i].id))) {
+            g_hash_table_destroy(index_by_id);
+            return STATUS_ERROR_INIT;
+        }
+        g_hash_table_insert(index_by_id, GINT_TO_POINTER(segments[i].id), GINT_TO_POINTER(i + 1));
+    }
+    
+    ProcessingSegmentResult* batch = (ProcessingSegmentResult*)calloc(count, sizeof(ProcessingSegmentResult));
+    for (int i = 0; i < count; i++) {
+        batch[i].id = segments[i].id;
+        batch[i].status = STATUS_ERROR_DBUS;
+    }
+    
+    int status = STATUS_ERROR_DBUS;
+    DBusConnection* conn = acquire_request_connection();
+    BackendFeatures* features = features_of(conn);
+    gboolean fall_back = g_atomic_int_get(&features->batch_unsupported);
+    
+    if (!fall_back) {
+        DBusError call_error;
+        dbus_error_init(&call_error);
+        
+        // The whole batch is one backend call
+        size_t bytes = 0;
+        for (int i = 0; i < count; i++) {
+            bytes += strlen(segments[i].text);
+        }
+        AdmissionTicket* ticket = NULL;
+        int admission = admission_acquire(segments[0].operation, bytes, scheduler_thread_priority(),
+                                          DBUS_PROCESSING_TIMEOUT_MS, &ticket);
+        
+        DBusMessage* message = admission == STATUS_SUCCESS ? new_process_text_batch_message(segments, count) : NULL;
+        DBusMessage* reply = NULL;
+        gboolean sent = message != NULL;
+        if (message) {
+            reply = dbus_connection_send_with_reply_and_block(
+                conn, message, DBUS_PROCESSING_TIMEOUT_MS, &call_error);
+            dbus_message_unref(message);
+        }
+        if (admission == STATUS_SUCCESS) {
+            admission_release(ticket, sent ? admission_outcome(&call_error) : STATUS_CANCELLED);
+        } else {
+            status = admission;
+        }
+        
+        if (dbus_error_is_set(&call_error)) {
+            if (dbus_error_has_name(&call_error, DBUS_ERROR_UNKNOWN_METHOD)) {
+                printf("⚠️  Backend has no ProcessTextBatch, sending segments concurrently\n");
+                g_atomic_int_set(&features->batch_unsupported, 1);
+                fall_back = TRUE;
+            } else {
+                status = status_from_error(&call_error);
+            }
+            dbus_error_free(&call_error);
+        } else if (reply) {
+            gboolean* answered = (gboolean*)calloc(count, sizeof(gboolean));
+            status = read_process_text_batch_reply(reply, index_by_id, batch, answered);
+            free(answered);
+        }
+        
+        if (reply) {
+            dbus_message_unref(reply);
+        }
+    }
+    
+    dbus_connection_unref(conn);
+    
+    if (fall_back) {
+        process_segments_concurrently(segments, count, batch);
+        status = STATUS_SUCCESS;
+    }
+    
+    g_hash_table_destroy(index_by_id);
+    
+    if (status != STATUS_SUCCESS) {
+        free_processing_results(batch, count);
+        return status;
+    }
+    
+    *results = batch;
+    return STATUS_SUCCESS;
+}
+
+void free_processing_results(ProcessingSegmentResult* results, int count) {
+    if (!results) {
+        return;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (results[i].result) free(results[i].result);
+    }
+    free(results);
+}
+
+// Build a ProcessTextStream(request_id, text, operation) method call
+static DBusMessage* new_process_text_stream_message(int request_id, const char* text, const char* operation) {
+    DBusMessage* message = dbus_message_new_method_call(
+        DBUS_SERVICE_NAME,
+        DBUS_OBJECT_PATH,
+        DBUS_INTERFACE_NAME,
+        "ProcessTextStream"
+    );
+    
+    if (!message) {
+        return NULL;
+    }
+    
+    dbus_int32_t id = request_id;
+    if (!dbus_message_append_args(message,
+                                  DBUS_TYPE_INT32, &id,
+                                  DBUS_TYPE_STRING, &text,
+                                  DBUS_TYPE_STRING, &operation,
+                                  DBUS_TYPE_INVALID)) {
+        dbus_message_unref(message);
+        return NULL;
+    }
+    
+    return message;
+}
+
+// Add a request to the table before its call goes out, so nothing that
+// arrives for its id is missed. The table holds the only reference.
+static PendingRequest* new_request(int timeout_ms, ProcessingCallback callback,
+                                   ProcessingProgressCallback progress, void* user_data,
+                                   GDestroyNotify user_data_free) {
+    PendingRequest* request = (PendingRequest*)calloc(1, sizeof(PendingRequest));
+    request->refcount = 1;
+    request->id = g_atomic_int_add(&next_request_id, 1);
+    request->timeout_ms = timeout_ms > 0 ? timeout_ms : DBUS_PROCESSING_TIMEOUT_MS;
+    request->created_at = g_get_monotonic_time();
+    request->callback = callback;
+    request->progress = progress;
+    request->user_data = user_data;
+    request->user_data_free = user_data_free;
+    request->payload_fd = -1;
+    
+    g_mutex_lock(&requests_lock);
+    g_hash_table_insert(requests, GINT_TO_POINTER(request->id), request);
+    g_mutex_unlock(&requests_lock);
+    
+    return request;
+}
+
+// Send `message` as the request's current call. Returns FALSE only if it
+// could not be sent; every later failure finishes the request instead.
+static gboolean start_pending_call(PendingRequest* request, DBusConnection* conn, DBusMessage* message) {
+    DBusPendingCall* call = NULL;
+    if (!dbus_connection_send_with_reply(conn, message, &call, request->timeout_ms) || !call) {
+        return FALSE;
+    }
+    
+    g_mutex_lock(&requests_lock);
+    gboolean finished = g_atomic_int_get(&request->finished);
+    DBusConnection* replaced = NULL;
+    if (!finished) {
+        request->call = call;
+        replaced = request->conn;
+        request->conn = dbus_connection_ref(conn);
+    }
+    g_mutex_unlock(&requests_lock);
+    if (replaced) {
+        dbus_connection_unref(replaced);
+    }
+    
+    if (finished) {
+        // Cancelled while the call was being replaced
+        dbus_pending_call_cancel(call);
+        dbus_pending_call_unref(call);
+        return TRUE;
+    }
+    
+    // The notify keeps its own reference until libdbus frees the call
+    request_ref(request);
+    if (!dbus_pending_call_set_notify(call, on_pending_call_complete, request_ref(request), request_unref)) {
+        request_unref(request);
+        finish_request(request, STATUS_ERROR_DBUS, NULL);
+        request_unref(request);
+        return TRUE;
+    }
+    
+    // A reply that raced the notify registration would otherwise be lost.
+    // If the notify runs too, whichever comes second finds it claimed.
+    if (dbus_pending_call_get_completed(call)) {
+        on_pending_call_complete(call, request);
+    }
+    request_unref(request);
+    return TRUE;
+}
+
+// Send the request's call: ProcessTextStream for a streaming request the
+// backend can stream, else ProcessText. FALSE if it could not be sent.
+static gboolean send_request_call(PendingRequest* request) {
+    // Known not to stream: don't pay for the failed call every time. Large
+    // text only travels by memfd, which ProcessTextStream doesn't take.
+    DBusConnection* conn = acquire_request_connection();
+    if (request->streaming &&
+        (g_atomic_int_get(&features_of(conn)->streaming_unsupported) || wants_payload_fd(conn, request->text))) {
+        request->streaming = FALSE;
+    }
+    
+    int payload_fd = -1;
+    DBusMessage* message = request->streaming
+        ? new_process_text_stream_message(request->id, request->text, request->operation)
+        : new_process_text_message(conn, request->text, request->operation, &payload_fd);
+    if (payload_fd >= 0 && g_atomic_int_get(&features_of(conn)->fd_confirmed)) {
+        close(payload_fd);  // No resend will ever need it
+    } else if (payload_fd >= 0) {
+        request->payload_fd = payload_fd;
+    }
+    
+    gboolean sent = message && start_pending_call(request, conn, message);
+    if (message) {
+        dbus_message_unref(message);
+    }
+    dbus_connection_unref(conn);
+    return sent;
+}
+
+// A queued request's turn came, or it waited too long (admission thread)
+static void on_request_admitted(int status, void* data) {
+    PendingRequest* request = lookup_request(GPOINTER_TO_INT(data));
+    if (!request) {
+        return;  // Finished, and its ticket with it
+    }
+    
+    if (status != STATUS_SUCCESS) {
+        finish_request(request, status, NULL);
+    } else if (!g_atomic_int_get(&request->finished)) {
+        // The wait came out of its deadline
+        gint64 waited_ms = (g_get_monotonic_time() - request->created_at) / 1000;
+        request->timeout_ms = (int)MAX(1, request->timeout_ms - waited_ms);
+        if (!send_request_call(request)) {
+            finish_request(request, STATUS_ERROR_DBUS, NULL);
+        }
+    }
+    request_unref(request);
+}
+
+// A more urgent call needs the request's backend slot (admission thread)
+static void on_request_preempted(int status, void* data) {
+    cancel_processing_request(GPOINTER_TO_INT(data));
+}
+
+// Start a request of its own, streaming or not, once admission control lets
+// it through at `priority`; until then it waits in the queue. Calls below
+// PRIORITY_INTERACTIVE may be preempted, completing with STATUS_CANCELLED.
+// `user_data_free` runs when the request is released.
+static int start_request(const char* text, const char* operation, int priority, int timeout_ms,
+                         gboolean streaming, ProcessingProgressCallback progress,
+                         ProcessingCallback callback, void* user_data, GDestroyNotify user_data_free) {
+    PendingRequest* request = new_request(timeout_ms, callback, progress, user_data, user_data_free);
+    int id = request->id;
+    request->priority = priority;
+    request->streaming = streaming;
+    request->text = strdup(text);
+    request->operation = strdup(operation);
+    if (streaming) {
+        request->partial = g_string_new(NULL);
+    }
+    
+    // Held while sending: a quick reply may finish and forget the request
+    request_ref(request);
+    int admission = admission_request(operation, strlen(text), priority, request->timeout_ms,
+                                      on_request_admitted,
+                                      priority > PRIORITY_INTERACTIVE ? on_request_preempted : NULL,
+                                      GINT_TO_POINTER(id), &request->ticket);
+    int status = admission == ADMISSION_QUEUED ? STATUS_SUCCESS : admission;
+    if (admission == STATUS_SUCCESS && !send_request_call(request)) {
+        status = STATUS_ERROR_DBUS;
+        end_admission(request, STATUS_CANCELLED);  // Never reached the backend
+    }
+    request_unref(request);
+    
+    if (status != STATUS_SUCCESS) {
+        forget_request(id);
+        return status;
+    }
+    return id;
+}
+
+static Flight* flight_ref(Flight* flight) {
+    g_atomic_int_inc(&flight->refcount);
+    return flight;
+}
+
+static void flight_unref(void* data) {
+    Flight* flight = (Flight*)data;
+    if (g_atomic_int_dec_and_test(&flight->refcount)) {
+        g_free(flight->key);
+        free(flight->text);
+        free(flight->operation);
+        free(flight);
+    }
+}
+
+// Take a flight out of the table so later callers start a new one. Caller
+// holds flights_lock.
+static void ground_flight_locked(Flight* flight) {
+    if (flights && g_hash_table_lookup(flights, flight->key) == flight) {
+        g_hash_table_remove(flights, flight->key);
+        flight_unref(flight);
+    }
+}
+
+// Hand every member its outcome and empty the flight. Takes ownership
+// of nothing; each member gets a copy of `result`.
+static void land_flight(Flight* flight, int status, const char* result) {
+    g_mutex_lock(&flights_lock);
+    ground_flight_locked(flight);
+    GList* members = g_list_reverse(flight->members);
+    flight->members = NULL;
+    flight->landed = TRUE;
+    g_mutex_unlock(&flights_lock);
+    
+    for (GList* node = members; node; node = node->next) {
+        PendingRequest* member = (PendingRequest*)node->data;
+        finish_request(member, status, result ? strdup(result) : NULL);
+        request_unref(member);
+    }
+    g_list_free(members);
+}
+
+static int launch_flight(Flight* flight, int priority, int timeout_ms);
+
+// The shared request completed (dispatcher thread, or a cancelling one).
+// It runs on the deadline of whoever started it; when that passes, members
+// who joined with a later one get the call sent again for the time they
+// have left.
+static void on_flight_done(int request_id, int status, const char* result, void* data) {
+    Flight* flight = (Flight*)data;
+    if (status != STATUS_TIMEOUT) {
+        land_flight(flight, status, result);
+        return;
+    }
+    
+    gint64 now = g_get_monotonic_time();
+    gint64 latest = 0;
+    g_mutex_lock(&flights_lock);
+    for (GList* node = flight->members; node; node = node->next) {
+        PendingRequest* member = (PendingRequest*)node->data;
+        gint64 deadline = member->created_at + (gint64)member->timeout_ms * 1000;
+        if (!g_atomic_int_get(&member->finished) && deadline > latest) {
+            latest = deadline;
+        }
+    }
+    gboolean reissue = !flight->landed && latest - now >= 1000;
+    int priority = flight->priority;
+    if (reissue) {
+        flight->upstream_id = 0;  // Sending again
+    }
+    g_mutex_unlock(&flights_lock);
+    
+    if (!reissue || launch_flight(flight, priority, (int)((latest - now) / 1000)) < 0) {
+        land_flight(flight, status, result);
+        return;
+    }
+    printf("⏱️  Shared call %d timed out, resent for members with later deadlines\n", request_id);
+}
+
+// A chunk of the shared request arrived (dispatcher thread)
+static void on_flight_progress(int request_id, const char* partial, void* data) {
+    Flight* flight = (Flight*)data;
+    
+    g_mutex_lock(&flights_lock);
+    GList* members = NULL;
+    for (GList* node = flight->members; node; node = node->next) {
+        members = g_list_prepend(members, request_ref((PendingRequest*)node->data));
+    }
+    g_mutex_unlock(&flights_lock);
+    
+    // Only this thread touches `delivered`
+    size_t length = strlen(partial);
+    for (GList* node = members; node; node = node->next) {
+        PendingRequest* member = (PendingRequest*)node->data;
+        if (!g_atomic_int_get(&member->finished)) {
+            if (member->progress) {
+                member->progress(member->id, partial, member->user_data);
+            } else if (!member->callback && length > member->delivered) {
+                dart_port_bridge_post_progress(member->id, partial + member->delivered);
+                member->delivered = length;
+            }
+        }
+        request_unref(member);
+    }
+    g_list_free(members);
+}
+
+// Raise a request of its own, and its place in admission control, to
+// `priority`
+static void promote_request(int request_id, int priority) {
+    PendingRequest* request = lookup_request(request_id);
+    if (!request) {
+        return;
+    }
+    
+    // Holding requests_lock keeps end_admission from releasing the ticket
+    g_mutex_lock(&requests_lock);
+    if (priority < request->priority) {
+        request->priority = priority;
+        admission_promote(request->ticket, priority);
+    }
+    g_mutex_unlock(&requests_lock);
+    request_unref(request);
+}
+
+// Flight table key; streaming and plain calls are kept apart because only
+// a streaming call has chunks for a streaming caller
+static char* flight_key(const char* text, const char* operation, gboolean streaming) {
+    return g_strconcat(streaming ? "s" : "p", "\x1f", operation, "\x1f", text, NULL);
+}
+
+// Send the flight's shared request with `timeout_ms`, the caller holding a
+// reference to the flight. The upstream id, or a negative StatusCode if
+// nothing went out.
+static int launch_flight(Flight* flight, int priority, int timeout_ms) {
+    // The shared request holds the last reference
+    int upstream_id = start_request(flight->text, flight->operation, priority, timeout_ms,
+                                    flight->streaming, flight->streaming ? on_flight_progress : NULL,
+                                    on_flight_done, flight_ref(flight), flight_unref);
+    if (upstream_id < 0) {
+        return upstream_id;
+    }
+    
+    g_mutex_lock(&flights_lock);
+    flight->upstream_id = upstream_id;
+    gboolean abandoned = !flight->members && !flight->landed;
+    int raised = flight->priority;  // A more urgent caller may have joined meanwhile
+    g_mutex_unlock(&flights_lock);
+    
+    // Every caller cancelled before the call was even sent
+    if (abandoned) {
+        cancel_processing_request(upstream_id);
+    } else if (raised < priority) {
+        promote_request(upstream_id, raised);
+    }
+    return upstream_id;
+}
+
+// Give a caller its own request on the flight for (text, operation),
+// starting the shared call if there is none yet. A plain caller also rides
+// on a streaming call. A more urgent caller raises the shared call to its
+// priority.
+static int join_flight(const char* text, const char* operation, int priority, int timeout_ms,
+                       gboolean streaming, ProcessingProgressCallback progress,
+                       ProcessingCallback callback, void* user_data) {
+    if (!connection || !requests || !flights || !text || !operation) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    char* key = flight_key(text, operation, streaming);
+    char* streaming_key = streaming ? NULL : flight_key(text, operation, TRUE);
+    PendingRequest* member = new_request(timeout_ms, callback, progress, user_data, NULL);
+    int id = member->id;
+    
+    g_mutex_lock(&flights_lock);
+    Flight* flight = streaming_key ? (Flight*)g_hash_table_lookup(flights, streaming_key) : NULL;
+    if (!flight) {
+        flight = (Flight*)g_hash_table_lookup(flights, key);
+    }
+    g_free(streaming_key);
+    gboolean joined = flight != NULL;
+    int promote_id = 0;
+    if (joined) {
+        g_free(key);
+        if (priority < flight->priority) {
+            flight->priority = priority;
+            promote_id = flight->upstream_id;  // 0 while still sending; checked after
+        }
+    } else {
+        flight = (Flight*)calloc(1, sizeof(Flight));
+        flight->refcount = 1;  // The table's
+        flight->key = key;
+        flight->text = strdup(text);
+        flight->operation = strdup(operation);
+        flight->streaming = streaming;
+        flight->priority = priority;
+        g_hash_table_insert(flights, flight->key, flight);
+    }
+    member->flight = flight_ref(flight);
+    flight->members = g_list_prepend(flight->members, request_ref(member));
+    if (!joined) {
+        flight_ref(flight);  // Ours, while the shared call is being sent
+    }
+    g_mutex_unlock(&flights_lock);
+    
+    if (joined) {
+        printf("🔗 Request %d joined an identical one in flight\n", id);
+        if (promote_id > 0) {
+            promote_request(promote_id, priority);
+        }
+        return id;
+    }
+    
+    int upstream_id = launch_flight(flight, priority, timeout_ms);
+    if (upstream_id < 0) {
+        // Nothing went out: callers who joined meanwhile fail with it, and
+        // this one just gets the error
+        g_mutex_lock(&flights_lock);
+        flight->members = g_list_remove(flight->members, member);
+        g_mutex_unlock(&flights_lock);
+        request_unref(member);
+        forget_request(id);
+        land_flight(flight, upstream_id, NULL);
+        flight_unref(flight);
+        return upstream_id;
+    }
+    flight_unref(flight);
+    return id;
+}
+
+// A caller gives up its seat; the last one out cancels the shared call
+static void leave_flight(PendingRequest* member) {
+    Flight* flight = member->flight;
+    int upstream_id = 0;
+    
+    g_mutex_lock(&flights_lock);
+    GList* link = g_list_find(flight->members, member);
+    if (link) {
+        flight->members = g_list_delete_link(flight->members, link);
+        if (!flight->members && !flight->landed) {
+            ground_flight_locked(flight);
+            upstream_id = flight->upstream_id;  // 0 while join_flight is still sending
+        }
+    }
+    g_mutex_unlock(&flights_lock);
+    
+    if (link) {
+        request_unref(member);  // The flight's reference
+    }
+    if (upstream_id > 0) {
+        cancel_processing_request(upstream_id);
+    }
+}
+
+// Finish flight members past their own deadline with STATUS_TIMEOUT; the
+// shared call runs on the first caller's and is resent for the rest when
+// that passes (dispatcher thread)
+static void expire_flight_members() {
+    gint64 now = g_get_monotonic_time();
+    GList* expired = NULL;
+    
+    g_mutex_lock(&flights_lock);
+    if (flights) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, flights);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            for (GList* node = ((Flight*)value)->members; node; node = node->next) {
+                PendingRequest* member = (PendingRequest*)node->data;
+                if (!g_atomic_int_get(&member->finished) &&
+                    now >= member->created_at + (gint64)member->timeout_ms * 1000) {
+                    expired = g_list_prepend(expired, request_ref(member));
+                }
+            }
+        }
+    }
+    g_mutex_unlock(&flights_lock);
+    
+    for (GList* node = expired; node; node = node->next) {
+        PendingRequest* member = (PendingRequest*)node->data;
+        printf("⏱️  Request %d passed its deadline while sharing a call\n", member->id);
+        leave_flight(member);
+        finish_request(member, STATUS_TIMEOUT, NULL);
+        request_unref(member);
+    }
+    g_list_free(expired);
+}
+
+// Start ProcessText without waiting for it
+int send_processing_request_async(const char* text, const char* operation, int timeout_ms,
+                                  ProcessingCallback callback, void* user_data) {
+    return join_flight(text, operation, scheduler_thread_priority(), timeout_ms, FALSE, NULL,
+                       callback, user_data);
+}
+
+// Start ProcessTextStream, reporting ResultChunk signals as they arrive
+int send_processing_request_streaming(const char* text, const char* operation, int timeout_ms,
+                                      ProcessingProgressCallback progress,
+                                      ProcessingCallback callback, void* user_data) {
+    return dbus_start_streaming_request(text, operation, scheduler_thread_priority(), timeout_ms,
+                                        progress, callback, user_data);
+}
+
+int dbus_start_streaming_request(const char* text, const char* operation, int priority, int timeout_ms,
+                                 ProcessingProgressCallback progress,
+                                 ProcessingCallback callback, void* user_data) {
+    return join_flight(text, operation, CLAMP(priority, 0, PROCESSING_PRIORITY_COUNT - 1), timeout_ms,
+                       TRUE, progress, callback, user_data);
+}
+
+// Raise a caller's request, or the shared call it rides on
+void dbus_promote_request(int request_id, int priority) {
+    PendingRequest* member = requests ? lookup_request(request_id) : NULL;
+    if (!member) {
+        return;
+    }
+    
+    int upstream_id = member->id;
+    if (member->flight) {
+        g_mutex_lock(&flights_lock);
+        upstream_id = 0;
+        if (priority < member->flight->priority) {
+            member->flight->priority = priority;
+            upstream_id = member->flight->upstream_id;
+        }
+        g_mutex_unlock(&flights_lock);
+    }
+    request_unref(member);
+    
+    if (upstream_id > 0) {
+        promote_request(upstream_id, priority);
+    }
+}
+
+// Cancel an in-flight request; its callback runs with STATUS_CANCELLED
+int cancel_processing_request(int request_id) {
+    if (!requests) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    PendingRequest* request = lookup_request(request_id);
+    if (!request) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    if (request->flight) {
+        leave_flight(request);
+    } else {
+        g_mutex_lock(&requests_lock);
+        DBusPendingCall* call = request->call ? dbus_pending_call_ref(request->call) : NULL;
+        g_mutex_unlock(&requests_lock);
+        
+        // Stops the timeout and drops the reply if one still comes. If the
+        // reply won the race, finish_request keeps its outcome.
+        if (call) {
+            dbus_pending_call_cancel(call);
+            dbus_pending_call_unref(call);
+        }
+    }
+    finish_request(request, STATUS_CANCELLED, NULL);
+    request_unref(request);
+    return STATUS_SUCCESS;
+}
+
+// Claim the outcome of a request started without a callback
+int take_processing_result(int request_id, int* status, char** result) {
+    if (!requests || !status || !result) {
+        return STATUS_ERROR_DBUS;
+    }
+    
+    g_mutex_lock(&requests_lock);
+    PendingRequest* request = (PendingRequest*)g_hash_table_lookup(requests, GINT_TO_POINTER(request_id));
+    if (!request || request->callback) {
+        g_mutex_unlock(&requests_lock);
+        return STATUS_ERROR_INIT;
+    }
+    if (!request->parked) {
+        g_mutex_unlock(&requests_lock);
+        return 0;
+    }
+    
+    g_hash_table_remove(requests, GINT_TO_POINTER(request_id));
+    *status = request->status;
+    *result = request->result;
+    request->result = NULL;
+    g_mutex_unlock(&requests_lock);
+    
+    request_unref(request);
+    return 1;
 }
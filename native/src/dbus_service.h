@@ -13,9 +13,63 @@ int init_dbus_service();
 // Cleanup D-Bus service
 void cleanup_dbus_service();
 
-// Send processing request to Flutter app
+// Default ProcessText deadline
+#define DBUS_PROCESSING_TIMEOUT_MS 30000
+
+// Text longer than this (bytes) is sent as a sealed memfd through
+// ProcessTextFd(h text, s operation) instead of inline. Any ProcessText*
+// reply may carry its result as a memfd (h) instead of a string (s); it is
+// refused unless sealed against writes and shrinking, or if larger than
+// DBUS_PAYLOAD_FD_MAX. Each side copies once: the text into the memfd and
+// the result out of it, since results are handed to callers as malloc'd
+// strings that outlive the fd.
+#define DBUS_INLINE_PAYLOAD_MAX (64 * 1024)
+
+// Largest result accepted from a backend's memfd (bytes)
+#define DBUS_PAYLOAD_FD_MAX (16 * 1024 * 1024)
+
+// Blocking ProcessText round trip, safe to call from any thread
+int dbus_process_text(const char* text, const char* operation, char** result);
+
+// Send processing request to Flutter app, reusing a matching speculation.
+// Text longer than the chunk budget goes through process_in_chunks.
+// Multi-sentence text goes through process_by_segments: only sentences
+// the result cache or translation memory can't answer are sent (as one
+// ProcessTextBatch), and their results are cached per sentence.
 int send_processing_request(const char* text, const char* operation, char** result);
 
+// ProcessTextWithHint(s text, s operation, s hint_source, s hint_result,
+// d similarity) -> s result is ProcessText plus the closest earlier
+// (text, result) pair from the translation memory. Backends without it
+// get plain ProcessText.
+
+// Turn sentence-level processing on or off (on by default)
+void dbus_set_segmentation_enabled(int enabled);
+
+// ProcessTextStream(i request_id, s text, s operation) -> s result behaves
+// like ProcessText but meanwhile emits ResultChunk(i request_id,
+// u sequence, s chunk) signals to the caller, sequence counting from 0.
+int send_processing_request_streaming(const char* text, const char* operation, int timeout_ms,
+                                      ProcessingProgressCallback progress,
+                                      ProcessingCallback callback, void* user_data);
+
+// send_processing_request_streaming at `priority` rather than the calling
+// thread's (see processing_scheduler.h)
+int dbus_start_streaming_request(const char* text, const char* operation, int priority, int timeout_ms,
+                                 ProcessingProgressCallback progress,
+                                 ProcessingCallback callback, void* user_data);
+
+// Raise an asynchronous request, and a backend call it shares, to a more
+// urgent ProcessingPriority (a user now waits on it)
+void dbus_promote_request(int request_id, int priority);
+
+// ProcessTextBatch(a(iss) segments) -> a(iis) results: segments are
+// (id, text, operation); results are (id, status, text) in any order, with
+// status a StatusCode and text empty on failure. Backends without it get
+// one ProcessText per segment, all in flight at once.
+int send_processing_batch(const ProcessingSegment* segments, int count, ProcessingSegmentResult** results);
+void free_processing_results(ProcessingSegmentResult* results, int count);
+
 #ifdef __cplusplus
 }
 #endif
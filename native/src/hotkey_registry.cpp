@@ -0,0 +1,443 @@
+#include "hotkey_registry.h"
+#include "context_menu_injector.h"
+#include "x11_reactor.h"
+#include <X11/Xlib.h>
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+#include <glib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Modifiers that tell bindings apart; everything else (CapsLock, NumLock,
+// ScrollLock) is ignored when matching
+#define HOTKEY_MOD_SHIFT   (1 << 0)
+#define HOTKEY_MOD_CONTROL (1 << 1)
+#define HOTKEY_MOD_ALT     (1 << 2)
+#define HOTKEY_MOD_SUPER   (1 << 3)
+#define HOTKEY_MOD_COMBINATIONS 16
+
+// One accelerator binding
+typedef struct {
+    gboolean in_use;
+    char* accelerator;
+    KeySym keysym;
+    unsigned int modifiers;     // HOTKEY_MOD_* bits
+    int action;                 // HotkeyAction
+    char* menu_item_id;
+    KeyCode grabbed_code;       // Keycode grabbed under the current keymap
+    unsigned int grabbed_mask;  // Real modifier mask grabbed
+    int generation;             // Tells this binding's id from earlier users of the slot
+} HotkeyBinding;
+
+// Registry state (reactor thread only)
+static Display* display = NULL;
+static Window root_window = None;
+static HotkeyBinding bindings[HOTKEY_MAX_BINDINGS];
+static int next_generation = 0;
+
+// keycode x cleaned modifier index -> binding slot + 1, 0 when unbound
+static unsigned char dispatch_table[256][HOTKEY_MOD_COMBINATIONS];
+
+// Real modifier masks under the current keymap
+static unsigned int alt_mask = Mod1Mask;
+static unsigned int super_mask = Mod4Mask;
+static unsigned int num_lock_mask = Mod2Mask;
+static unsigned int scroll_lock_mask = 0;
+
+// XKB keyboard change notifications
+static int xkb_event_base = -1;
+static unsigned int rebuild_timer = 0;
+
+// Parse "Ctrl+Shift+M" style accelerators
+static gboolean parse_accelerator(const char* accelerator, KeySym* keysym, unsigned int* modifiers) {
+    *keysym = NoSymbol;
+    *modifiers = 0;
+
+    gchar** parts = g_strsplit(accelerator, "+", -1);
+    gboolean ok = TRUE;
+
+    for (int i = 0; parts[i] && ok; i++) {
+        char* part = g_strstrip(parts[i]);
+        gboolean last = parts[i + 1] == NULL;
+
+        if (!last) {
+            if (!strcasecmp(part, "Ctrl") || !strcasecmp(part, "Control") || !strcasecmp(part, "Primary")) {
+                *modifiers |= HOTKEY_MOD_CONTROL;
+            } else if (!strcasecmp(part, "Shift")) {
+                *modifiers |= HOTKEY_MOD_SHIFT;
+            } else if (!strcasecmp(part, "Alt") || !strcasecmp(part, "Mod1")) {
+                *modifiers |= HOTKEY_MOD_ALT;
+            } else if (!strcasecmp(part, "Super") || !strcasecmp(part, "Win") || !strcasecmp(part, "Mod4")) {
+                *modifiers |= HOTKEY_MOD_SUPER;
+            } else {
+                ok = FALSE;
+            }
+            continue;
+        }
+
+        // Single characters name the unshifted key ("M" means XK_m)
+        if (strlen(part) == 1) {
+            char lower[2] = { (char)g_ascii_tolower(part[0]), '\0' };
+            *keysym = XStringToKeysym(lower);
+        } else {
+            *keysym = XStringToKeysym(part);
+        }
+        ok = *keysym != NoSymbol;
+    }
+
+    g_strfreev(parts);
+    return ok && *keysym != NoSymbol;
+}
+
+// Real modifier mask that holds `keysym`, or 0
+static unsigned int modifier_mask_for(XModifierKeymap* map, KeySym keysym) {
+    KeyCode code = XKeysymToKeycode(display, keysym);
+    if (code == 0) return 0;
+
+    for (int mod = 0; mod < 8; mod++) {
+        for (int k = 0; k < map->max_keypermod; k++) {
+            if (map->modifiermap[mod * map->max_keypermod + k] == code) {
+                return 1u << mod;
+            }
+        }
+    }
+    return 0;
+}
+
+// Resolve where Alt, Super, NumLock and ScrollLock live in this keymap
+static void refresh_modifier_masks() {
+    XModifierKeymap* map = XGetModifierMapping(display);
+    if (!map) return;
+
+    unsigned int mask;
+    alt_mask = (mask = modifier_mask_for(map, XK_Alt_L)) ? mask : Mod1Mask;
+    super_mask = (mask = modifier_mask_for(map, XK_Super_L)) ? mask : Mod4Mask;
+    num_lock_mask = modifier_mask_for(map, XK_Num_Lock);
+    scroll_lock_mask = modifier_mask_for(map, XK_Scroll_Lock);
+    XFreeModifiermap(map);
+}
+
+static unsigned int real_mask_for(unsigned int modifiers) {
+    unsigned int mask = 0;
+    if (modifiers & HOTKEY_MOD_SHIFT) mask |= ShiftMask;
+    if (modifiers & HOTKEY_MOD_CONTROL) mask |= ControlMask;
+    if (modifiers & HOTKEY_MOD_ALT) mask |= alt_mask;
+    if (modifiers & HOTKEY_MOD_SUPER) mask |= super_mask;
+    return mask;
+}
+
+// Table column for an event's modifier state
+static unsigned int clean_modifiers(unsigned int state) {
+    unsigned int modifiers = 0;
+    if (state & ShiftMask) modifiers |= HOTKEY_MOD_SHIFT;
+    if (state & ControlMask) modifiers |= HOTKEY_MOD_CONTROL;
+    if (state & alt_mask) modifiers |= HOTKEY_MOD_ALT;
+    if (state & super_mask) modifiers |= HOTKEY_MOD_SUPER;
+    return modifiers;
+}
+
+// Grab every lock-key variant of one chord
+static void grab_chord(KeyCode code, unsigned int mask, gboolean grab) {
+    unsigned int locks[] = { 0, LockMask, num_lock_mask, scroll_lock_mask };
+
+    // Every subset of the lock modifiers present in this keymap
+    for (unsigned int subset = 0; subset < 8; subset++) {
+        unsigned int extra = 0;
+        gboolean valid = TRUE;
+        for (int bit = 0; bit < 3; bit++) {
+            if (!(subset & (1u << bit))) continue;
+            if (locks[bit + 1] == 0) valid = FALSE;
+            extra |= locks[bit + 1];
+        }
+        if (!valid) continue;
+
+        if (grab) {
+            XGrabKey(display, code, mask | extra, root_window, True, GrabModeAsync, GrabModeAsync);
+        } else {
+            XUngrabKey(display, code, mask | extra, root_window);
+        }
+    }
+}
+
+static void ungrab_binding(HotkeyBinding* binding) {
+    if (binding->grabbed_code != 0) {
+        grab_chord(binding->grabbed_code, binding->grabbed_mask, FALSE);
+        binding->grabbed_code = 0;
+    }
+}
+
+// Grab a binding under the current keymap and enter it in the table
+static void grab_binding(int slot) {
+    HotkeyBinding* binding = &bindings[slot];
+    KeyCode code = XKeysymToKeycode(display, binding->keysym);
+    if (code == 0) {
+        printf("⚠️  Hotkey %s has no key in the current keymap\n", binding->accelerator);
+        return;
+    }
+
+    binding->grabbed_code = code;
+    binding->grabbed_mask = real_mask_for(binding->modifiers);
+    grab_chord(code, binding->grabbed_mask, TRUE);
+    dispatch_table[code][binding->modifiers] = (unsigned char)(slot + 1);
+}
+
+// Regrab every binding after the keymap or modifier mapping changed
+static void rebuild_grabs() {
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS; i++) {
+        if (bindings[i].in_use) ungrab_binding(&bindings[i]);
+    }
+
+    refresh_modifier_masks();
+    memset(dispatch_table, 0, sizeof(dispatch_table));
+
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS; i++) {
+        if (bindings[i].in_use) grab_binding(i);
+    }
+    XFlush(display);
+}
+
+static void rebuild_timer_task(Display* task_display, void* user_data) {
+    rebuild_timer = 0;
+    printf("⌨️  Keyboard mapping changed - rebuilding hotkey grabs\n");
+    rebuild_grabs();
+}
+
+// Coalesce bursts of mapping notifications into one rebuild
+static void schedule_rebuild() {
+    if (rebuild_timer == 0) {
+        rebuild_timer = x11_reactor_add_timeout(0, rebuild_timer_task, NULL);
+    }
+}
+
+// Reactor handler: dispatch bound chords and track keymap changes
+static int hotkey_event_handler(XEvent* event, void* user_data) {
+    if (event->type == KeyPress) {
+        unsigned int column = clean_modifiers(event->xkey.state);
+        int entry = dispatch_table[event->xkey.keycode & 0xff][column];
+        if (entry == 0) {
+            return 0;
+        }
+
+        HotkeyBinding* binding = &bindings[entry - 1];
+        context_menu_handle_hotkey(binding->accelerator, binding->action, binding->menu_item_id,
+                                   event->xkey.x_root, event->xkey.y_root);
+        return 1;
+    }
+
+    if (event->type == MappingNotify) {
+        if (event->xmapping.request != MappingPointer) {
+            XRefreshKeyboardMapping(&event->xmapping);
+            schedule_rebuild();
+        }
+        return 0;
+    }
+
+    if (xkb_event_base >= 0 && event->type == xkb_event_base) {
+        XkbEvent* xkb_event = (XkbEvent*)event;
+        if (xkb_event->any.xkb_type == XkbNewKeyboardNotify ||
+            xkb_event->any.xkb_type == XkbMapNotify) {
+            schedule_rebuild();
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void free_binding(HotkeyBinding* binding) {
+    if (binding->accelerator) free(binding->accelerator);
+    if (binding->menu_item_id) free(binding->menu_item_id);
+    memset(binding, 0, sizeof(*binding));
+}
+
+static void setup_registry_task(Display* task_display, void* user_data) {
+    display = task_display;
+    root_window = DefaultRootWindow(display);
+
+    // Ask for keyboard replacement and keymap change notifications
+    int opcode, error_base;
+    int major = XkbMajorVersion, minor = XkbMinorVersion;
+    if (XkbQueryExtension(display, &opcode, &xkb_event_base, &error_base, &major, &minor)) {
+        unsigned int mask = XkbNewKeyboardNotifyMask | XkbMapNotifyMask;
+        XkbSelectEvents(display, XkbUseCoreKbd, mask, mask);
+    } else {
+        xkb_event_base = -1;
+    }
+
+    refresh_modifier_masks();
+    memset(dispatch_table, 0, sizeof(dispatch_table));
+    x11_reactor_add_handler(hotkey_event_handler, NULL);
+}
+
+static void teardown_registry_task(Display* task_display, void* user_data) {
+    x11_reactor_remove_handler(hotkey_event_handler, NULL);
+    if (rebuild_timer) {
+        x11_reactor_remove_timeout(rebuild_timer);
+        rebuild_timer = 0;
+    }
+
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS; i++) {
+        if (!bindings[i].in_use) continue;
+        ungrab_binding(&bindings[i]);
+        free_binding(&bindings[i]);
+    }
+    memset(dispatch_table, 0, sizeof(dispatch_table));
+    XSync(display, False);
+    printf("Global hotkeys unregistered\n");
+}
+
+// Initialize the hotkey registry
+int init_hotkey_registry() {
+    return x11_reactor_call(setup_registry_task, NULL);
+}
+
+// Cleanup the hotkey registry
+void cleanup_hotkey_registry() {
+    if (display) {
+        x11_reactor_call(teardown_registry_task, NULL);
+        display = NULL;
+    }
+}
+
+// Binding request handed to the reactor
+typedef struct {
+    const char* accelerator;
+    int action;
+    const char* menu_item_id;
+    int result;
+} AddBindingRequest;
+
+static void add_binding_task(Display* task_display, void* user_data) {
+    AddBindingRequest* request = (AddBindingRequest*)user_data;
+
+    KeySym keysym;
+    unsigned int modifiers;
+    if (!parse_accelerator(request->accelerator, &keysym, &modifiers)) {
+        printf("❌ Invalid hotkey accelerator: %s\n", request->accelerator);
+        request->result = STATUS_ERROR_INIT;
+        return;
+    }
+
+    // Rebinding a chord replaces the previous binding
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS; i++) {
+        if (bindings[i].in_use && bindings[i].keysym == keysym && bindings[i].modifiers == modifiers) {
+            ungrab_binding(&bindings[i]);
+            free_binding(&bindings[i]);
+            rebuild_grabs();
+        }
+    }
+
+    int slot = -1;
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS && slot < 0; i++) {
+        if (!bindings[i].in_use) slot = i;
+    }
+    if (slot < 0) {
+        request->result = STATUS_ERROR_INIT;
+        return;
+    }
+
+    HotkeyBinding* binding = &bindings[slot];
+    binding->in_use = TRUE;
+    binding->accelerator = strdup(request->accelerator);
+    binding->keysym = keysym;
+    binding->modifiers = modifiers;
+    binding->action = request->action;
+    binding->menu_item_id = request->menu_item_id ? strdup(request->menu_item_id) : NULL;
+
+    // Another client holding the chord makes XGrabKey fail with BadAccess
+    x11_reactor_trap_errors();
+    grab_binding(slot);
+    int error_code = x11_reactor_untrap_errors();
+    if (error_code != Success) {
+        printf("❌ Hotkey %s is taken by another application (X error %d)\n",
+               binding->accelerator, error_code);
+        if (binding->grabbed_code != 0) {
+            dispatch_table[binding->grabbed_code][binding->modifiers] = 0;
+        }
+        ungrab_binding(binding);
+        free_binding(binding);
+        XSync(display, False);
+        request->result = STATUS_ERROR_INIT;
+        return;
+    }
+
+    // Ids stay positive: generation * HOTKEY_MAX_BINDINGS + slot + 1
+    binding->generation = next_generation;
+    next_generation = (next_generation + 1) % (G_MAXINT / HOTKEY_MAX_BINDINGS - 1);
+
+    printf("Registered global hotkey: %s\n", binding->accelerator);
+    request->result = binding->generation * HOTKEY_MAX_BINDINGS + slot + 1;
+}
+
+// Bind an accelerator to an action
+int hotkey_registry_add(const char* accelerator, int action, const char* menu_item_id) {
+    if (!accelerator) {
+        return STATUS_ERROR_INIT;
+    }
+    if (action != HOTKEY_ACTION_SHOW_MENU && action != HOTKEY_ACTION_MENU_ITEM) {
+        return STATUS_ERROR_INIT;
+    }
+    if (action == HOTKEY_ACTION_MENU_ITEM && (!menu_item_id || !*menu_item_id)) {
+        return STATUS_ERROR_INIT;
+    }
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    AddBindingRequest request = { accelerator, action, menu_item_id, STATUS_ERROR_INIT };
+    int status = x11_reactor_call(add_binding_task, &request);
+    return status == STATUS_SUCCESS ? request.result : status;
+}
+
+typedef struct {
+    int hotkey_id;      // 0 removes everything
+    int result;
+} RemoveBindingRequest;
+
+static void remove_binding_task(Display* task_display, void* user_data) {
+    RemoveBindingRequest* request = (RemoveBindingRequest*)user_data;
+    request->result = request->hotkey_id == 0 ? STATUS_SUCCESS : STATUS_ERROR_INIT;
+
+    // A stale id names a generation its slot no longer holds
+    int slot = (request->hotkey_id - 1) % HOTKEY_MAX_BINDINGS;
+    int generation = (request->hotkey_id - 1) / HOTKEY_MAX_BINDINGS;
+    for (int i = 0; i < HOTKEY_MAX_BINDINGS; i++) {
+        if (!bindings[i].in_use ||
+            (request->hotkey_id != 0 && (i != slot || bindings[i].generation != generation))) {
+            continue;
+        }
+        ungrab_binding(&bindings[i]);
+        free_binding(&bindings[i]);
+        request->result = STATUS_SUCCESS;
+    }
+
+    // Clear stale table entries and regrab what is left
+    rebuild_grabs();
+}
+
+// Remove one binding
+int hotkey_registry_remove(int hotkey_id) {
+    if (hotkey_id <= 0) {
+        return STATUS_ERROR_INIT;
+    }
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    RemoveBindingRequest request = { hotkey_id, STATUS_ERROR_INIT };
+    int status = x11_reactor_call(remove_binding_task, &request);
+    return status == STATUS_SUCCESS ? request.result : status;
+}
+
+// Remove every binding
+int hotkey_registry_clear() {
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    RemoveBindingRequest request = { 0, STATUS_ERROR_INIT };
+    int status = x11_reactor_call(remove_binding_task, &request);
+    return status == STATUS_SUCCESS ? request.result : status;
+}
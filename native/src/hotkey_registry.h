@@ -0,0 +1,38 @@
+#ifndef HOTKEY_REGISTRY_H
+#define HOTKEY_REGISTRY_H
+
+#include "../include/instant_translator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most bindings held at once
+#define HOTKEY_MAX_BINDINGS 64
+
+// Bound to HOTKEY_ACTION_SHOW_MENU at startup
+#define DEFAULT_MENU_HOTKEY "Ctrl+Shift+M"
+
+// Initialize the hotkey registry (grabs live on the X11 reactor)
+int init_hotkey_registry();
+
+// Ungrab everything and forget all bindings
+void cleanup_hotkey_registry();
+
+// Bind an accelerator such as "Ctrl+Shift+M" to an action. `menu_item_id`
+// is required for HOTKEY_ACTION_MENU_ITEM. Returns a binding id > 0, or
+// a negative StatusCode, also when another client already grabbed the
+// chord. Ids are not reused, so a stale one removes nothing.
+int hotkey_registry_add(const char* accelerator, int action, const char* menu_item_id);
+
+// Remove one binding
+int hotkey_registry_remove(int hotkey_id);
+
+// Remove every binding
+int hotkey_registry_clear();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOTKEY_REGISTRY_H
@@ -33,37 +33,33 @@ static void on_selection_changed(SelectionData* selection) {
     printf("\n");
 }
 
-// Menu action callback for testing
-static void on_menu_action(const char* menu_id, SelectionData* selection) {
-    if (!menu_id || !selection) return;
-    
-    printf("Menu action triggered:\n");
-    printf("  Menu ID: %s\n", menu_id);
-    printf("  Selected text: '%.50s%s'\n", selection->text,
-           strlen(selection->text) > 50 ? "..." : "");
-    
-    // Simulate text processing
-    char* result = NULL;
-    int status = send_processing_request(selection->text, menu_id, &result);
+// A finished menu action, carried back to the GTK main thread
+typedef struct {
+    char* text;         // The selection it was run on
+    int status;
+    char* result;
+} MenuActionOutcome;
+
+// Replace the selection with the result (GTK main thread)
+static gboolean apply_menu_action_in_main_thread(gpointer data) {
+    MenuActionOutcome* outcome = (MenuActionOutcome*)data;
     
-    if (status == STATUS_SUCCESS && result) {
-        printf("  Processing result: %s\n", result);
+    if (outcome->status == STATUS_SUCCESS && outcome->result) {
+        printf("  Processing result: %s\n", outcome->result);
         
         // Replace the selected text
-        int replace_status = replace_text_via_clipboard(result);
+        int replace_status = replace_text_via_clipboard(outcome->result);
         if (replace_status == STATUS_SUCCESS) {
             printf("  Text replacement: SUCCESS\n");
         } else {
             printf("  Text replacement: FAILED (%d)\n", replace_status);
         }
-        
-        free(result);
     } else {
-        printf("  Processing failed with status: %d\n", status);
+        printf("  Processing failed with status: %d\n", outcome->status);
         
         // Fallback: just add "[PROCESSED]" prefix
         char fallback_text[1024];
-        snprintf(fallback_text, sizeof(fallback_text), "[PROCESSED] %s", selection->text);
+        snprintf(fallback_text, sizeof(fallback_text), "[PROCESSED] %s", outcome->text);
         
         int replace_status = replace_text_via_clipboard(fallback_text);
         if (replace_status == STATUS_SUCCESS) {
@@ -74,6 +70,47 @@ static void on_menu_action(const char* menu_id, SelectionData* selection) {
     }
     
     printf("\n");
+    free(outcome->text);
+    if (outcome->result) free(outcome->result);
+    free(outcome);
+    return FALSE;
+}
+
+// Completion of the scheduled menu action (scheduler worker thread)
+static void on_menu_action_processed(int job_id, int status, const char* result, void* user_data) {
+    MenuActionOutcome* outcome = (MenuActionOutcome*)user_data;
+    outcome->status = status;
+    outcome->result = result ? strdup(result) : NULL;
+    g_idle_add(apply_menu_action_in_main_thread, outcome);
+}
+
+// Menu action callback for testing
+static void on_menu_action(const char* menu_id, SelectionData* selection) {
+    if (!menu_id || !selection) return;
+    
+    printf("Menu action triggered:\n");
+    printf("  Menu ID: %s\n", menu_id);
+    printf("  Selected text: '%.50s%s'\n", selection->text,
+           strlen(selection->text) > 50 ? "..." : "");
+    
+    // The clipboard is captured while the text is processed
+    prepare_text_replacement();
+    
+    // Simulate text processing, as interactive work ahead of any
+    // speculation, without blocking the GTK main thread
+    MenuActionOutcome* outcome = (MenuActionOutcome*)calloc(1, sizeof(MenuActionOutcome));
+    outcome->text = strdup(selection->text);
+    int job_id = schedule_processing(selection->text, menu_id, PRIORITY_INTERACTIVE,
+                                     on_menu_action_processed, outcome);
+    if (job_id < 0) {
+        outcome->status = job_id;
+        apply_menu_action_in_main_thread(outcome);
+    }
+}
+
+// Chunk progress callback for testing
+static void on_chunk_progress(const char* operation, int completed, int total) {
+    printf("  %s: %d/%d chunks\n", operation, completed, total);
 }
 
 // Create sample menu items for testing
@@ -93,7 +130,6 @@ int main(int argc, char* argv[]) {
         printf("Requirements:\n");
         printf("- X11 display server\n");
         printf("- GTK 3.0\n");
-        printf("- xclip utility\n");
         printf("- xdotool utility\n");
         return 1;
     }
@@ -117,6 +153,7 @@ int main(int argc, char* argv[]) {
     // Set up callbacks
     set_selection_callback(on_selection_changed);
     set_menu_action_callback(on_menu_action);
+    set_chunk_progress_callback(on_chunk_progress);
     
     // Start with empty menu - Flutter will register items
     printf("System ready. Context menu will show only Flutter-registered items.\n");
@@ -145,6 +182,58 @@ int main(int argc, char* argv[]) {
     
     printf("\nShutting down...\n");
     
+    // Report hotkey dispatch latency
+    HotkeyLatencyStats stats;
+    if (get_hotkey_latency_stats(&stats) == STATUS_SUCCESS && stats.count > 0) {
+        printf("Hotkey dispatch: %d presses, mean %ldus, max %ldus, %d over %dus\n",
+               stats.count, stats.mean_us, stats.max_us, stats.over_budget,
+               HOTKEY_LATENCY_BUDGET_US);
+    }
+    
+    // Report hotkey -> first menu frame for both popup paths
+    HotkeyLatencyStats rebuilt, reused;
+    if (get_menu_frame_latency_stats(&rebuilt, &reused) == STATUS_SUCCESS) {
+        if (rebuilt.count > 0) {
+            printf("Menu first frame (rebuilt): %d shows, mean %ldus, max %ldus, %d over %dus\n",
+                   rebuilt.count, rebuilt.mean_us, rebuilt.max_us, rebuilt.over_budget,
+                   MENU_FRAME_BUDGET_US);
+        }
+        if (reused.count > 0) {
+            printf("Menu first frame (reused): %d shows, mean %ldus, max %ldus, %d over %dus\n",
+                   reused.count, reused.mean_us, reused.max_us, reused.over_budget,
+                   MENU_FRAME_BUDGET_US);
+        }
+    }
+    
+    // Report result cache effectiveness
+    ResultCacheStats cache;
+    if (get_result_cache_stats(&cache) == STATUS_SUCCESS && cache.hits + cache.misses > 0) {
+        printf("Result cache: %ld hits, %ld misses, %ld entries (%ld/%ld bytes), %ld evictions\n",
+               cache.hits, cache.misses, cache.entries, cache.bytes, cache.budget_bytes,
+               cache.evictions);
+        printf("Result store: %ld hits, %ld entries (%ld bytes)\n",
+               cache.disk_hits, cache.disk_entries, cache.disk_bytes);
+    }
+    
+    // Report backend admission
+    AdmissionStats admission;
+    if (get_admission_stats(&admission) == STATUS_SUCCESS && admission.admitted + admission.rejected > 0) {
+        printf("Backend admission: %ld admitted (mean wait %ldus), %ld rejected, limit %d (cut %ld times)\n",
+               admission.admitted, admission.mean_wait_us, admission.rejected, admission.limit,
+               admission.limit_decreases);
+    }
+    
+    // Report queue times per priority class
+    const char* class_names[PROCESSING_PRIORITY_COUNT] = {"interactive", "speculative", "background"};
+    for (int priority = 0; priority < PROCESSING_PRIORITY_COUNT; priority++) {
+        SchedulerClassStats scheduled;
+        if (get_scheduler_stats(priority, &scheduled) == STATUS_SUCCESS && scheduled.admitted > 0) {
+            printf("%s: %ld jobs done, queued %ldus avg (%ldus max), backend wait %ldus avg, %ld preempted\n",
+                   class_names[priority], scheduled.completed, scheduled.mean_queue_us, scheduled.max_queue_us,
+                   scheduled.mean_admission_wait_us, scheduled.preempted);
+        }
+    }
+    
     // Cleanup
     unregister_context_menu();
     cleanup_system_hooks();
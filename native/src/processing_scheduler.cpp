@@ -0,0 +1,257 @@
+#include "processing_scheduler.h"
+#include "admission_control.h"
+#include "dbus_service.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef struct {
+    int id;
+    int priority;
+    char* text;
+    char* operation;
+    ProcessingCallback callback;
+    void* user_data;
+    gint64 submitted_at;
+    gboolean started;       // Guarded by scheduler_lock, like cancelled
+    gboolean cancelled;
+} ScheduledJob;
+
+typedef struct {
+    int queued;
+    int running;
+    long started;
+    long completed;
+    long cancelled;
+    gint64 total_queue_us;
+    gint64 max_queue_us;
+} JobCounters;
+
+static const int class_workers[PROCESSING_PRIORITY_COUNT] = {
+    SCHEDULER_INTERACTIVE_WORKERS,
+    SCHEDULER_SPECULATIVE_WORKERS,
+    SCHEDULER_BACKGROUND_WORKERS
+};
+
+static const char* class_names[PROCESSING_PRIORITY_COUNT] = {
+    "interactive", "speculative", "background"
+};
+
+// State guarded by scheduler_lock
+static GMutex scheduler_lock;
+static GThreadPool* pools[PROCESSING_PRIORITY_COUNT] = {NULL};
+static GHashTable* jobs = NULL;     // id -> ScheduledJob*, until its callback ran
+static JobCounters job_counters[PROCESSING_PRIORITY_COUNT];
+
+static gint next_job_id = 1;
+static GPrivate priority_key;       // Priority + 1, unset outside jobs
+
+int scheduler_thread_priority() {
+    int stored = GPOINTER_TO_INT(g_private_get(&priority_key));
+    return stored > 0 ? stored - 1 : PRIORITY_INTERACTIVE;
+}
+
+void scheduler_set_thread_priority(int priority) {
+    g_private_set(&priority_key, GINT_TO_POINTER(CLAMP(priority, 0, PROCESSING_PRIORITY_COUNT - 1) + 1));
+}
+
+static void free_job(ScheduledJob* job) {
+    free(job->text);
+    free(job->operation);
+    free(job);
+}
+
+// Run one job (worker of its class)
+static void run_job(gpointer data, gpointer user_data) {
+    ScheduledJob* job = (ScheduledJob*)data;
+    JobCounters* counters = &job_counters[job->priority];
+    gint64 queued_us = g_get_monotonic_time() - job->submitted_at;
+
+    g_mutex_lock(&scheduler_lock);
+    counters->queued--;
+    gboolean cancelled = job->cancelled;
+    if (!cancelled) {
+        job->started = TRUE;
+        counters->running++;
+        counters->started++;
+        counters->total_queue_us += queued_us;
+        counters->max_queue_us = MAX(counters->max_queue_us, queued_us);
+    }
+    g_mutex_unlock(&scheduler_lock);
+
+    char* result = NULL;
+    int status = STATUS_CANCELLED;
+    if (!cancelled) {
+        // Every backend call it makes is admitted at its class
+        scheduler_set_thread_priority(job->priority);
+        status = send_processing_request(job->text, job->operation, &result);
+        scheduler_set_thread_priority(PRIORITY_INTERACTIVE);
+    }
+
+    g_mutex_lock(&scheduler_lock);
+    if (job->started) {
+        counters->running--;
+    }
+
+    if (job->cancelled) {
+        counters->cancelled++;
+        status = STATUS_CANCELLED;
+    } else {
+        counters->completed++;
+    }
+    if (jobs) {
+        g_hash_table_remove(jobs, GINT_TO_POINTER(job->id));
+    }
+    g_mutex_unlock(&scheduler_lock);
+
+    if (status == STATUS_CANCELLED && result) {
+        free(result);
+        result = NULL;
+    }
+    job->callback(job->id, status, result, job->user_data);
+    if (result) free(result);
+    free_job(job);
+}
+
+int init_processing_scheduler() {
+    g_mutex_lock(&scheduler_lock);
+    if (!jobs) {
+        jobs = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+    for (int i = 0; i < PROCESSING_PRIORITY_COUNT; i++) {
+        if (!pools[i]) {
+            pools[i] = g_thread_pool_new(run_job, NULL, class_workers[i], FALSE, NULL);
+        }
+        if (!pools[i]) {
+            g_mutex_unlock(&scheduler_lock);
+            return STATUS_ERROR_INIT;
+        }
+    }
+    g_mutex_unlock(&scheduler_lock);
+
+    printf("✅ Processing scheduler ready (%d interactive, %d speculative, %d background workers)\n",
+           SCHEDULER_INTERACTIVE_WORKERS, SCHEDULER_SPECULATIVE_WORKERS, SCHEDULER_BACKGROUND_WORKERS);
+    return STATUS_SUCCESS;
+}
+
+void cleanup_processing_scheduler() {
+    // Queued jobs report STATUS_CANCELLED as the pools drain
+    g_mutex_lock(&scheduler_lock);
+    GThreadPool* draining[PROCESSING_PRIORITY_COUNT];
+    for (int i = 0; i < PROCESSING_PRIORITY_COUNT; i++) {
+        draining[i] = pools[i];
+        pools[i] = NULL;
+    }
+    if (jobs) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, jobs);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            ScheduledJob* job = (ScheduledJob*)value;
+            if (!job->started) {
+                job->cancelled = TRUE;
+            }
+        }
+    }
+    g_mutex_unlock(&scheduler_lock);
+
+    for (int i = 0; i < PROCESSING_PRIORITY_COUNT; i++) {
+        if (draining[i]) {
+            g_thread_pool_free(draining[i], FALSE, TRUE);
+        }
+    }
+
+    g_mutex_lock(&scheduler_lock);
+    if (jobs) {
+        g_hash_table_destroy(jobs);
+        jobs = NULL;
+    }
+    g_mutex_unlock(&scheduler_lock);
+}
+
+int scheduler_submit(const char* text, const char* operation, int priority,
+                     ProcessingCallback callback, void* user_data) {
+    if (!text || !operation || !callback || priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return STATUS_ERROR_INIT;
+    }
+
+    ScheduledJob* job = (ScheduledJob*)calloc(1, sizeof(ScheduledJob));
+    job->id = g_atomic_int_add(&next_job_id, 1);
+    job->priority = priority;
+    job->text = strdup(text);
+    job->operation = strdup(operation);
+    job->callback = callback;
+    job->user_data = user_data;
+    job->submitted_at = g_get_monotonic_time();
+    int id = job->id;
+
+    g_mutex_lock(&scheduler_lock);
+    if (!pools[priority]) {
+        g_mutex_unlock(&scheduler_lock);
+        free_job(job);
+        return STATUS_ERROR_INIT;
+    }
+    g_hash_table_insert(jobs, GINT_TO_POINTER(id), job);
+    job_counters[priority].queued++;
+    g_thread_pool_push(pools[priority], job, NULL);
+    g_mutex_unlock(&scheduler_lock);
+
+    printf("📋 Scheduled %s job %d: %s\n", class_names[priority], id, operation);
+    return id;
+}
+
+int scheduler_cancel(int job_id) {
+    g_mutex_lock(&scheduler_lock);
+    ScheduledJob* job = jobs ? (ScheduledJob*)g_hash_table_lookup(jobs, GINT_TO_POINTER(job_id)) : NULL;
+    if (job) {
+        job->cancelled = TRUE;
+    }
+    g_mutex_unlock(&scheduler_lock);
+    return job ? STATUS_SUCCESS : STATUS_ERROR_INIT;
+}
+
+void scheduler_cancel_class(int priority) {
+    if (priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return;
+    }
+
+    int count = 0;
+    g_mutex_lock(&scheduler_lock);
+    if (jobs) {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, jobs);
+        while (g_hash_table_iter_next(&iter, NULL, &value)) {
+            ScheduledJob* job = (ScheduledJob*)value;
+            if (job->priority == priority && !job->cancelled) {
+                job->cancelled = TRUE;
+                count++;
+            }
+        }
+    }
+    g_mutex_unlock(&scheduler_lock);
+
+    // Running jobs stop at their next queued or preemptible backend call
+    admission_cancel_class(priority);
+    printf("📋 Cancelled %s work (%d jobs)\n", class_names[priority], count);
+}
+
+void scheduler_get_stats(int priority, SchedulerClassStats* stats) {
+    memset(stats, 0, sizeof(SchedulerClassStats));
+    if (priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return;
+    }
+
+    g_mutex_lock(&scheduler_lock);
+    JobCounters* counters = &job_counters[priority];
+    stats->queued = counters->queued;
+    stats->running = counters->running;
+    stats->completed = counters->completed;
+    stats->cancelled = counters->cancelled;
+    stats->mean_queue_us = counters->started > 0 ? (long)(counters->total_queue_us / counters->started) : 0;
+    stats->max_queue_us = (long)counters->max_queue_us;
+    g_mutex_unlock(&scheduler_lock);
+
+    admission_get_class_stats(priority, stats);
+}
@@ -0,0 +1,57 @@
+#ifndef PROCESSING_SCHEDULER_H
+#define PROCESSING_SCHEDULER_H
+
+#include "../include/instant_translator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Jobs run send_processing_request on worker pools of their own
+// ProcessingPriority class, so lower-class work never holds the workers an
+// interactive action needs. Backend slots are shared; admission control
+// hands them out by class and preempts lower-class calls. A job whose call
+// was preempted reports STATUS_CANCELLED like a cancelled one.
+//
+// Only blocking work needs a worker. The asynchronous, streaming and batch
+// entry points never enter these pools: they are admitted directly at the
+// calling thread's scheduler_thread_priority().
+#define SCHEDULER_INTERACTIVE_WORKERS 4
+#define SCHEDULER_SPECULATIVE_WORKERS 2
+#define SCHEDULER_BACKGROUND_WORKERS 1
+
+// Create the worker pools
+int init_processing_scheduler();
+
+// Cancel queued jobs and wait for running ones
+void cleanup_processing_scheduler();
+
+// Queue send_processing_request(text, operation) at `priority`. Returns a
+// job id > 0 or a negative StatusCode. `callback` runs once on the worker
+// with a borrowed result.
+int scheduler_submit(const char* text, const char* operation, int priority,
+                     ProcessingCallback callback, void* user_data);
+
+// Mark a job cancelled: a queued one never starts, a running one reports
+// STATUS_CANCELLED when its call returns
+int scheduler_cancel(int job_id);
+
+// Cancel a class's jobs and, through admission control, its queued and
+// preemptible backend calls
+void scheduler_cancel_class(int priority);
+
+void scheduler_get_stats(int priority, SchedulerClassStats* stats);
+
+// Priority of the job this thread is running, PRIORITY_INTERACTIVE outside
+// any job; backend calls made on the thread are admitted at it
+int scheduler_thread_priority();
+
+// Run this thread's next backend calls at `priority` (workers doing part of
+// a job pass its priority on)
+void scheduler_set_thread_priority(int priority);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROCESSING_SCHEDULER_H
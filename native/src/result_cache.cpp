@@ -0,0 +1,486 @@
+#include "result_cache.h"
+#include "result_store.h"
+#include "translation_memory.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// 128-bit content address of one (text, operation, instruction, model)
+// tuple; the on-disk store uses the same keys
+typedef ResultKey CacheKey;
+
+typedef struct {
+    CacheKey key;
+    char* operation;    // For invalidating one menu item's entries
+    char* result;
+    size_t bytes;       // Charged against the shard budget
+    GList* link;        // Position in the shard's LRU queue
+} CacheEntry;
+
+// Independent slice of the cache; the low key bits pick the shard
+typedef struct {
+    GMutex lock;
+    GHashTable* entries;    // CacheKey* (inside the entry) -> CacheEntry*
+    GQueue lru;             // Most recently used at the head
+    size_t bytes;
+    guint64 hits;
+    guint64 misses;
+    guint64 evictions;
+    guint64 disk_hits;
+} CacheShard;
+
+static CacheShard shards[RESULT_CACHE_SHARDS];
+static gboolean cache_ready = FALSE;
+
+// What goes into every key besides the text, guarded by config_lock
+static GRWLock config_lock;
+static GHashTable* item_instructions = NULL;    // Menu item id -> ai_instruction
+static char* model_config = NULL;
+static size_t shard_budget = 0;
+
+// MurmurHash3 x64_128; fast, and 128 bits make collisions a non-issue
+static inline guint64 rotl64(guint64 x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline guint64 fmix64(guint64 k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static CacheKey murmur3_128(const guint8* data, size_t length) {
+    const guint64 c1 = 0x87c37b91114253d5ULL;
+    const guint64 c2 = 0x4cf5ad432745937fULL;
+    guint64 h1 = 0, h2 = 0;
+    size_t blocks = length / 16;
+
+    for (size_t i = 0; i < blocks; i++) {
+        guint64 k1, k2;
+        memcpy(&k1, data + i * 16, sizeof(k1));
+        memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+        k1 = GUINT64_FROM_LE(k1);
+        k2 = GUINT64_FROM_LE(k2);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const guint8* tail = data + blocks * 16;
+    int remaining = length & 15;
+    guint64 k1 = 0, k2 = 0;
+    for (int i = remaining - 1; i >= 8; i--) {
+        k2 ^= (guint64)tail[i] << ((i - 8) * 8);
+    }
+    if (remaining > 8) {
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    for (int i = MIN(remaining, 8) - 1; i >= 0; i--) {
+        k1 ^= (guint64)tail[i] << (i * 8);
+    }
+    if (remaining > 0) {
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    CacheKey key = {h1, h2};
+    return key;
+}
+
+static guint cache_key_hash(gconstpointer data) {
+    return (guint)((const CacheKey*)data)->hi;
+}
+
+static gboolean cache_key_equal(gconstpointer a, gconstpointer b) {
+    return memcmp(a, b, sizeof(CacheKey)) == 0;
+}
+
+// Trim, CRLF -> LF, and collapse runs of spaces and tabs into one space
+static void append_normalized(GString* out, const char* text) {
+    const char* start = text;
+    while (*start && g_ascii_isspace(*start)) start++;
+    const char* end = start + strlen(start);
+    while (end > start && g_ascii_isspace(end[-1])) end--;
+
+    gboolean in_blank = FALSE;
+    for (const char* p = start; p < end; p++) {
+        if (*p == '\r' && p + 1 < end && p[1] == '\n') {
+            continue;
+        }
+        if (*p == ' ' || *p == '\t') {
+            if (!in_blank) g_string_append_c(out, ' ');
+            in_blank = TRUE;
+            continue;
+        }
+        in_blank = FALSE;
+        g_string_append_c(out, *p);
+    }
+}
+
+// Content address for a request; FALSE when caching is off
+static gboolean compute_key(const char* text, const char* operation, CacheKey* key) {
+    GString* material = g_string_sized_new(strlen(text) + 64);
+    append_normalized(material, text);
+
+    g_rw_lock_reader_lock(&config_lock);
+    gboolean enabled = shard_budget > 0;
+    const char* instruction = (const char*)g_hash_table_lookup(item_instructions, operation);
+
+    // NUL separators keep ("ab", "c") and ("a", "bc") apart
+    g_string_append_len(material, "", 1);
+    g_string_append(material, operation);
+    g_string_append_len(material, "", 1);
+    g_string_append(material, instruction ? instruction : "");
+    g_string_append_len(material, "", 1);
+    g_string_append(material, model_config ? model_config : "");
+    g_rw_lock_reader_unlock(&config_lock);
+
+    *key = murmur3_128((const guint8*)material->str, material->len);
+    g_string_free(material, TRUE);
+    return enabled;
+}
+
+static CacheShard* shard_for(const CacheKey* key) {
+    return &shards[key->lo % RESULT_CACHE_SHARDS];
+}
+
+static void free_entry(CacheEntry* entry) {
+    free(entry->operation);
+    free(entry->result);
+    free(entry);
+}
+
+// Caller holds shard->lock
+static void remove_entry_locked(CacheShard* shard, CacheEntry* entry) {
+    g_hash_table_remove(shard->entries, &entry->key);
+    g_queue_delete_link(&shard->lru, entry->link);
+    shard->bytes -= entry->bytes;
+    free_entry(entry);
+}
+
+// Evict from the cold end until `incoming` more bytes fit. Caller holds
+// shard->lock.
+static void make_room_locked(CacheShard* shard, size_t incoming, size_t budget) {
+    while (shard->bytes + incoming > budget && !g_queue_is_empty(&shard->lru)) {
+        remove_entry_locked(shard, (CacheEntry*)g_queue_peek_tail(&shard->lru));
+        shard->evictions++;
+    }
+}
+
+// Put a result in memory, replacing any entry for the key
+static void insert_entry(const CacheKey* key, const char* operation, const char* result) {
+    g_rw_lock_reader_lock(&config_lock);
+    size_t budget = shard_budget;
+    g_rw_lock_reader_unlock(&config_lock);
+
+    size_t bytes = sizeof(CacheEntry) + strlen(operation) + strlen(result) + 2;
+    if (bytes > budget) {
+        return;  // Would push out a whole shard for one answer
+    }
+
+    CacheShard* shard = shard_for(key);
+    g_mutex_lock(&shard->lock);
+
+    CacheEntry* existing = (CacheEntry*)g_hash_table_lookup(shard->entries, key);
+    if (existing) {
+        remove_entry_locked(shard, existing);
+    }
+    make_room_locked(shard, bytes, budget);
+
+    CacheEntry* entry = (CacheEntry*)malloc(sizeof(CacheEntry));
+    entry->key = *key;
+    entry->operation = strdup(operation);
+    entry->result = strdup(result);
+    entry->bytes = bytes;
+    g_queue_push_head(&shard->lru, entry);
+    entry->link = g_queue_peek_head_link(&shard->lru);
+    g_hash_table_insert(shard->entries, &entry->key, entry);
+    shard->bytes += bytes;
+
+    g_mutex_unlock(&shard->lock);
+}
+
+// Drop every in-memory entry
+static void clear_memory() {
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        CacheShard* shard = &shards[i];
+        g_mutex_lock(&shard->lock);
+        while (!g_queue_is_empty(&shard->lru)) {
+            remove_entry_locked(shard, (CacheEntry*)g_queue_peek_tail(&shard->lru));
+        }
+        g_mutex_unlock(&shard->lock);
+    }
+}
+
+// Initialize the cache
+int init_result_cache(size_t budget_bytes) {
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        g_mutex_init(&shards[i].lock);
+        shards[i].entries = g_hash_table_new(cache_key_hash, cache_key_equal);
+        g_queue_init(&shards[i].lru);
+        shards[i].bytes = 0;
+        shards[i].hits = shards[i].misses = shards[i].evictions = shards[i].disk_hits = 0;
+    }
+
+    g_rw_lock_init(&config_lock);
+    item_instructions = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+    model_config = NULL;
+    shard_budget = budget_bytes / RESULT_CACHE_SHARDS;
+    cache_ready = TRUE;
+
+    printf("✅ Result cache ready (%zu KiB budget)\n", budget_bytes / 1024);
+    return STATUS_SUCCESS;
+}
+
+// Drop every entry
+void cleanup_result_cache() {
+    if (!cache_ready) {
+        return;
+    }
+
+    clear_memory();
+    cache_ready = FALSE;
+
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        g_hash_table_destroy(shards[i].entries);
+        shards[i].entries = NULL;
+    }
+
+    g_rw_lock_writer_lock(&config_lock);
+    g_hash_table_destroy(item_instructions);
+    item_instructions = NULL;
+    if (model_config) {
+        free(model_config);
+        model_config = NULL;
+    }
+    g_rw_lock_writer_unlock(&config_lock);
+}
+
+int result_cache_lookup(const char* text, const char* operation, char** result) {
+    if (!cache_ready || !text || !operation || !result) {
+        return 0;
+    }
+
+    CacheKey key;
+    if (!compute_key(text, operation, &key)) {
+        return 0;
+    }
+
+    CacheShard* shard = shard_for(&key);
+    g_mutex_lock(&shard->lock);
+    CacheEntry* entry = (CacheEntry*)g_hash_table_lookup(shard->entries, &key);
+    if (entry) {
+        // Touch: move to the hot end
+        g_queue_unlink(&shard->lru, entry->link);
+        g_queue_push_head_link(&shard->lru, entry->link);
+        shard->hits++;
+        *result = strdup(entry->result);
+        g_mutex_unlock(&shard->lock);
+        return 1;
+    }
+    g_mutex_unlock(&shard->lock);
+
+    // Answered in an earlier run: promote it so the next hit stays in memory
+    gboolean on_disk = result_store_lookup(&key, result);
+    if (on_disk) {
+        insert_entry(&key, operation, *result);
+    }
+
+    g_mutex_lock(&shard->lock);
+    if (on_disk) {
+        shard->hits++;
+        shard->disk_hits++;
+    } else {
+        shard->misses++;
+    }
+    g_mutex_unlock(&shard->lock);
+    return on_disk;
+}
+
+int result_cache_contains(const char* text, const char* operation) {
+    if (!cache_ready || !text || !operation) {
+        return 0;
+    }
+
+    CacheKey key;
+    if (!compute_key(text, operation, &key)) {
+        return 0;
+    }
+
+    CacheShard* shard = shard_for(&key);
+    g_mutex_lock(&shard->lock);
+    gboolean found = g_hash_table_contains(shard->entries, &key);
+    g_mutex_unlock(&shard->lock);
+    return found || result_store_contains(&key);
+}
+
+void result_cache_store(const char* text, const char* operation, const char* result) {
+    if (!cache_ready || !text || !operation || !result) {
+        return;
+    }
+
+    CacheKey key;
+    if (!compute_key(text, operation, &key)) {
+        return;
+    }
+
+    insert_entry(&key, operation, result);
+    result_store_append(&key, operation, result);
+}
+
+void result_cache_sync_menu_items(const MenuItem* items, int count) {
+    if (!cache_ready) {
+        return;
+    }
+
+    GHashTable* fresh = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+    for (int i = 0; i < count; i++) {
+        if (items[i].id) {
+            g_hash_table_replace(fresh, strdup(items[i].id),
+                                 strdup(items[i].ai_instruction ? items[i].ai_instruction : ""));
+        }
+    }
+
+    // Items that disappeared or were re-instructed
+    GList* stale = NULL;
+    g_rw_lock_writer_lock(&config_lock);
+    GHashTableIter iter;
+    gpointer id, instruction;
+    g_hash_table_iter_init(&iter, item_instructions);
+    while (g_hash_table_iter_next(&iter, &id, &instruction)) {
+        const char* now = (const char*)g_hash_table_lookup(fresh, id);
+        if (!now || strcmp(now, (const char*)instruction) != 0) {
+            stale = g_list_prepend(stale, strdup((const char*)id));
+        }
+    }
+    g_hash_table_destroy(item_instructions);
+    item_instructions = fresh;
+    g_rw_lock_writer_unlock(&config_lock);
+
+    // New keys already differ; this just frees what can never hit again
+    for (GList* node = stale; node; node = node->next) {
+        result_cache_invalidate_operation((const char*)node->data);
+    }
+    g_list_free_full(stale, free);
+}
+
+void result_cache_invalidate_operation(const char* operation) {
+    if (!cache_ready || !operation) {
+        return;
+    }
+
+    int dropped = 0;
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        CacheShard* shard = &shards[i];
+        g_mutex_lock(&shard->lock);
+
+        GHashTableIter iter;
+        gpointer key, value;
+        g_hash_table_iter_init(&iter, shard->entries);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            CacheEntry* entry = (CacheEntry*)value;
+            if (strcmp(entry->operation, operation) == 0) {
+                g_hash_table_iter_remove(&iter);
+                g_queue_delete_link(&shard->lru, entry->link);
+                shard->bytes -= entry->bytes;
+                free_entry(entry);
+                dropped++;
+            }
+        }
+        g_mutex_unlock(&shard->lock);
+    }
+    result_store_invalidate_operation(operation);
+    translation_memory_forget_operation(operation);
+
+    if (dropped > 0) {
+        printf("🗑️  Result cache dropped %d entries for %s\n", dropped, operation);
+    }
+}
+
+void result_cache_clear() {
+    if (!cache_ready) {
+        return;
+    }
+
+    clear_memory();
+    result_store_clear();
+    translation_memory_clear();
+}
+
+void result_cache_set_model_config(const char* config) {
+    if (!cache_ready) {
+        return;
+    }
+
+    g_rw_lock_writer_lock(&config_lock);
+    gboolean changed = g_strcmp0(model_config, config) != 0;
+    if (changed) {
+        if (model_config) free(model_config);
+        model_config = config ? strdup(config) : NULL;
+    }
+    g_rw_lock_writer_unlock(&config_lock);
+
+    // Answers from another model are not answers for this one. The config
+    // is part of every key, so on-disk entries are left to age out: the
+    // config is set afresh on each start and the store must survive that.
+    if (changed) {
+        clear_memory();
+        translation_memory_clear();
+    }
+}
+
+void result_cache_set_budget(size_t budget_bytes) {
+    if (!cache_ready) {
+        return;
+    }
+
+    size_t budget = budget_bytes / RESULT_CACHE_SHARDS;
+    g_rw_lock_writer_lock(&config_lock);
+    shard_budget = budget;
+    g_rw_lock_writer_unlock(&config_lock);
+
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        g_mutex_lock(&shards[i].lock);
+        make_room_locked(&shards[i], 0, budget);
+        g_mutex_unlock(&shards[i].lock);
+    }
+}
+
+void result_cache_get_stats(ResultCacheStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!cache_ready) {
+        return;
+    }
+
+    for (int i = 0; i < RESULT_CACHE_SHARDS; i++) {
+        CacheShard* shard = &shards[i];
+        g_mutex_lock(&shard->lock);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->entries += g_hash_table_size(shard->entries);
+        stats->bytes += shard->bytes;
+        stats->disk_hits += shard->disk_hits;
+        g_mutex_unlock(&shard->lock);
+    }
+
+    g_rw_lock_reader_lock(&config_lock);
+    stats->budget_bytes = shard_budget * RESULT_CACHE_SHARDS;
+    g_rw_lock_reader_unlock(&config_lock);
+
+    result_store_get_usage(&stats->disk_entries, &stats->disk_bytes);
+}
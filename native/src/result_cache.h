@@ -0,0 +1,56 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "../include/instant_translator.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Results are cached under a 128-bit hash of (normalized text, operation,
+// the operation's ai_instruction, model config). Text is normalized by
+// trimming both ends, turning CRLF into LF and collapsing runs of spaces
+// and tabs, so reselecting a sentence with slightly different edges hits.
+#define RESULT_CACHE_SHARDS 16
+#define RESULT_CACHE_DEFAULT_BUDGET (8 * 1024 * 1024)
+
+// Initialize the cache with a byte budget (0 disables it)
+int init_result_cache(size_t budget_bytes);
+
+// Drop every entry
+void cleanup_result_cache();
+
+// 1 and a copy of the cached result (free with free()), or 0 on a miss
+int result_cache_lookup(const char* text, const char* operation, char** result);
+
+// Whether a result is cached, without counting a hit or miss
+int result_cache_contains(const char* text, const char* operation);
+
+// Remember a successful result, evicting least recently used entries
+void result_cache_store(const char* text, const char* operation, const char* result);
+
+// The registered menu items changed: forget entries of items that are gone
+// or whose ai_instruction changed, and key new entries by the new ones
+void result_cache_sync_menu_items(const MenuItem* items, int count);
+
+// Forget every entry for one operation. These three also reach the
+// translation memory, whose entries are results too.
+void result_cache_invalidate_operation(const char* operation);
+
+// Forget everything, on disk too
+void result_cache_clear();
+
+// Model settings that shape results; a change empties the in-memory tier
+void result_cache_set_model_config(const char* config);
+
+// New byte budget (0 disables); shrinking evicts right away
+void result_cache_set_budget(size_t budget_bytes);
+
+void result_cache_get_stats(ResultCacheStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,701 @@
+#include "result_store.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INDEX_MAGIC "ITRIDX01"
+#define LOG_MAGIC "ITRLOG01"
+#define RECORD_MAGIC 0x52545449u     // "ITTR"
+#define LOG_HEADER_SIZE 8
+
+// Stop inserting past this load; compact well before it
+#define INDEX_HARD_LIMIT (RESULT_STORE_SLOTS / 10 * 9)
+#define INDEX_SOFT_LIMIT (RESULT_STORE_SLOTS / 4 * 3)
+
+// Don't bother compacting small logs for garbage alone
+#define COMPACT_MIN_LOG (1024 * 1024)
+
+enum {
+    SLOT_EMPTY = 0,
+    SLOT_LIVE = 1,
+    SLOT_DEAD = 2,      // Tombstone: lookups probe past it
+};
+
+typedef struct {
+    char magic[8];
+    guint32 slot_count;
+    guint32 used;           // Live and dead slots; empties end a probe
+    guint32 live;
+    guint32 reserved;
+    guint64 live_bytes;     // Log bytes (headers included) still referenced
+} IndexHeader;
+
+typedef struct {
+    guint64 key_lo;
+    guint64 key_hi;
+    guint64 offset;         // Record position in the log
+    guint32 length;         // Value bytes
+    guint32 operation_tag;
+    guint32 state;
+    guint32 reserved;
+} IndexSlot;
+
+typedef struct {
+    guint32 magic;
+    guint32 length;
+    guint32 crc;            // CRC-32 of the value bytes
+    guint32 reserved;
+    guint64 key_lo;
+    guint64 key_hi;
+} RecordHeader;
+
+#define INDEX_FILE_SIZE (sizeof(IndexHeader) + RESULT_STORE_SLOTS * sizeof(IndexSlot))
+#define RECORD_SIZE(length) (sizeof(RecordHeader) + (guint64)(length))
+
+// Everything below is guarded by store_lock
+static GMutex store_lock;
+static gboolean store_ready = FALSE;
+static char* index_path = NULL;
+static char* log_path = NULL;
+static int lock_fd = -1;
+static int index_fd = -1;
+static int log_fd = -1;
+static IndexHeader* index_header = NULL;    // MAP_SHARED view of results.idx
+static IndexSlot* slots = NULL;
+static guint64 log_end = 0;
+static guint64 generation = 0;              // Bumped by clear; stale compactions abort
+
+static GThread* compact_thread = NULL;
+static gboolean compacting = FALSE;
+
+static guint32 crc_table[256];
+
+static void init_crc_table() {
+    for (guint32 i = 0; i < 256; i++) {
+        guint32 c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        }
+        crc_table[i] = c;
+    }
+}
+
+static guint32 crc32_of(const char* data, size_t length) {
+    guint32 c = 0xffffffffu;
+    for (size_t i = 0; i < length; i++) {
+        c = crc_table[(c ^ (guint8)data[i]) & 0xff] ^ (c >> 8);
+    }
+    return c ^ 0xffffffffu;
+}
+
+static guint32 operation_tag_for(const char* operation) {
+    return g_str_hash(operation);
+}
+
+// pread/pwrite that finish short transfers
+static gboolean read_fully(int fd, void* buffer, size_t length, guint64 offset) {
+    char* p = (char*)buffer;
+    while (length > 0) {
+        ssize_t n = pread(fd, p, length, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FALSE;
+        p += n;
+        length -= n;
+        offset += n;
+    }
+    return TRUE;
+}
+
+static gboolean write_fully(int fd, const void* buffer, size_t length, guint64 offset) {
+    const char* p = (const char*)buffer;
+    while (length > 0) {
+        ssize_t n = pwrite(fd, p, length, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return FALSE;
+        p += n;
+        length -= n;
+        offset += n;
+    }
+    return TRUE;
+}
+
+// Slot holding `key`, or the empty slot ending its probe; NULL when the
+// table has no empty slot left (never at INDEX_HARD_LIMIT)
+static IndexSlot* probe(IndexSlot* table, guint64 lo, guint64 hi) {
+    guint32 mask = RESULT_STORE_SLOTS - 1;
+    guint32 i = (guint32)lo & mask;
+    for (guint32 n = 0; n < RESULT_STORE_SLOTS; n++, i = (i + 1) & mask) {
+        IndexSlot* slot = &table[i];
+        if (slot->state == SLOT_EMPTY) {
+            return slot;
+        }
+        if (slot->state == SLOT_LIVE && slot->key_lo == lo && slot->key_hi == hi) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+// Caller holds store_lock
+static void kill_slot_locked(IndexSlot* slot) {
+    slot->state = SLOT_DEAD;
+    index_header->live--;
+    index_header->live_bytes -= RECORD_SIZE(slot->length);
+}
+
+// Read and verify one record; NULL when it doesn't match the slot
+static char* read_record(int fd, const IndexSlot* slot) {
+    RecordHeader header;
+    if (!read_fully(fd, &header, sizeof(header), slot->offset) ||
+        header.magic != RECORD_MAGIC || header.length != slot->length ||
+        header.key_lo != slot->key_lo || header.key_hi != slot->key_hi) {
+        return NULL;
+    }
+
+    char* value = (char*)malloc(header.length + 1);
+    if (!read_fully(fd, value, header.length, slot->offset + sizeof(header)) ||
+        crc32_of(value, header.length) != header.crc) {
+        free(value);
+        return NULL;
+    }
+    value[header.length] = '\0';
+    return value;
+}
+
+// Caller holds store_lock
+static gboolean compaction_due_locked() {
+    guint64 referenced = LOG_HEADER_SIZE + index_header->live_bytes;
+    guint64 garbage = log_end > referenced ? log_end - referenced : 0;
+    return index_header->used >= INDEX_SOFT_LIMIT ||
+           log_end >= RESULT_STORE_LOG_BUDGET ||
+           (log_end >= COMPACT_MIN_LOG && garbage > index_header->live_bytes);
+}
+
+static gboolean map_index(int fd) {
+    void* map = mmap(NULL, INDEX_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return FALSE;
+    }
+    index_header = (IndexHeader*)map;
+    slots = (IndexSlot*)((char*)map + sizeof(IndexHeader));
+    return TRUE;
+}
+
+static void unmap_index() {
+    if (index_header) {
+        munmap(index_header, INDEX_FILE_SIZE);
+        index_header = NULL;
+        slots = NULL;
+    }
+}
+
+// Fresh, empty files at the given paths
+static gboolean create_store_files(const char* idx, const char* log) {
+    int fd = open(log, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return FALSE;
+    gboolean ok = write_fully(fd, LOG_MAGIC, LOG_HEADER_SIZE, 0);
+    close(fd);
+    if (!ok) return FALSE;
+
+    fd = open(idx, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return FALSE;
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, 8);
+    header.slot_count = RESULT_STORE_SLOTS;
+    ok = ftruncate(fd, INDEX_FILE_SIZE) == 0 &&
+         write_fully(fd, &header, sizeof(header), 0);
+    close(fd);
+    return ok;
+}
+
+// Open both files and check their headers; nothing else is read
+static gboolean open_store_files() {
+    index_fd = open(index_path, O_RDWR | O_CLOEXEC);
+    log_fd = open(log_path, O_RDWR | O_CLOEXEC);
+    if (index_fd < 0 || log_fd < 0) {
+        return FALSE;
+    }
+
+    struct stat index_stat, log_stat;
+    char log_magic[8];
+    if (fstat(index_fd, &index_stat) != 0 || (size_t)index_stat.st_size != INDEX_FILE_SIZE ||
+        fstat(log_fd, &log_stat) != 0 || log_stat.st_size < LOG_HEADER_SIZE ||
+        !read_fully(log_fd, log_magic, LOG_HEADER_SIZE, 0) ||
+        memcmp(log_magic, LOG_MAGIC, LOG_HEADER_SIZE) != 0) {
+        return FALSE;
+    }
+
+    if (!map_index(index_fd)) {
+        return FALSE;
+    }
+    if (memcmp(index_header->magic, INDEX_MAGIC, 8) != 0 ||
+        index_header->slot_count != RESULT_STORE_SLOTS) {
+        unmap_index();
+        return FALSE;
+    }
+
+    log_end = (guint64)log_stat.st_size;
+    return TRUE;
+}
+
+static void close_store_files() {
+    unmap_index();
+    if (index_fd >= 0) {
+        close(index_fd);
+        index_fd = -1;
+    }
+    if (log_fd >= 0) {
+        close(log_fd);
+        log_fd = -1;
+    }
+}
+
+static int compare_offsets(const void* a, const void* b) {
+    guint64 x = ((const IndexSlot*)a)->offset;
+    guint64 y = ((const IndexSlot*)b)->offset;
+    return x < y ? -1 : x > y;
+}
+
+// Where a record copied in the first pass ended up, or 0
+static guint64 remap_offset(const IndexSlot* kept, const guint64* moved, guint32 count,
+                            guint64 offset) {
+    guint32 low = 0, high = count;
+    while (low < high) {
+        guint32 mid = (low + high) / 2;
+        if (kept[mid].offset < offset) low = mid + 1;
+        else high = mid;
+    }
+    return low < count && kept[low].offset == offset ? moved[low] : 0;
+}
+
+// Copy `slot`'s record from `from` to the end of `to`: 1 when copied, 0
+// when the source record is unreadable, -1 when writing failed
+static int copy_record(int from, int to, const IndexSlot* slot, guint64* to_end) {
+    char* value = read_record(from, slot);
+    if (!value) {
+        return 0;
+    }
+
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = RECORD_MAGIC;
+    header.length = slot->length;
+    header.crc = crc32_of(value, slot->length);
+    header.key_lo = slot->key_lo;
+    header.key_hi = slot->key_hi;
+
+    gboolean ok = write_fully(to, &header, sizeof(header), *to_end) &&
+                  write_fully(to, value, slot->length, *to_end + sizeof(header));
+    free(value);
+    if (!ok) {
+        return -1;
+    }
+    *to_end += RECORD_SIZE(slot->length);
+    return 1;
+}
+
+// Rewrite the log with only live records, keeping at most half the slots
+// and half the log budget, newest first. The bulk copy runs unlocked from
+// a snapshot (log records never move once written); only records appended
+// meanwhile are copied under the lock before the files are swapped.
+static gpointer compact_thread_func(gpointer data) {
+    (void)data;
+    gint64 started = g_get_monotonic_time();
+
+    g_mutex_lock(&store_lock);
+    if (!store_ready) {
+        compacting = FALSE;
+        g_mutex_unlock(&store_lock);
+        return NULL;
+    }
+    char* tmp_index = g_strconcat(index_path, ".tmp", NULL);
+    char* tmp_log = g_strconcat(log_path, ".tmp", NULL);
+    guint64 snapshot_generation = generation;
+    guint64 snapshot_end = log_end;
+    guint32 kept_count = 0;
+    IndexSlot* kept = (IndexSlot*)calloc(RESULT_STORE_SLOTS, sizeof(IndexSlot));
+    for (guint32 i = 0; i < RESULT_STORE_SLOTS; i++) {
+        if (slots[i].state == SLOT_LIVE) {
+            kept[kept_count++] = slots[i];
+        }
+    }
+    int source_fd = dup(log_fd);
+    g_mutex_unlock(&store_lock);
+
+    // Newest entries win when something has to go
+    qsort(kept, kept_count, sizeof(IndexSlot), compare_offsets);
+    guint32 first = kept_count;
+    guint64 kept_bytes = 0;
+    while (first > 0 && kept_count - first < RESULT_STORE_SLOTS / 2 &&
+           kept_bytes + RECORD_SIZE(kept[first - 1].length) <= RESULT_STORE_LOG_BUDGET / 2) {
+        first--;
+        kept_bytes += RECORD_SIZE(kept[first].length);
+    }
+    guint32 evicted = first;
+    memmove(kept, kept + first, sizeof(IndexSlot) * (kept_count - first));
+    kept_count -= first;
+
+    gboolean ok = source_fd >= 0 && create_store_files(tmp_index, tmp_log);
+    int out_fd = ok ? open(tmp_log, O_RDWR | O_CLOEXEC) : -1;
+    ok = ok && out_fd >= 0;
+
+    guint64* moved = (guint64*)calloc(kept_count + 1, sizeof(guint64));
+    guint64 out_end = LOG_HEADER_SIZE;
+    for (guint32 i = 0; ok && i < kept_count; i++) {
+        guint64 at = out_end;
+        int copied = copy_record(source_fd, out_fd, &kept[i], &out_end);
+        if (copied > 0) {
+            moved[i] = at;
+        }
+        ok = copied >= 0;
+    }
+
+    g_mutex_lock(&store_lock);
+    ok = ok && store_ready && generation == snapshot_generation;
+
+    // Rebuild the index from the current one, so lookups, appends and
+    // invalidations since the snapshot all carry over
+    IndexSlot* table = ok ? (IndexSlot*)calloc(RESULT_STORE_SLOTS, sizeof(IndexSlot)) : NULL;
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, 8);
+    header.slot_count = RESULT_STORE_SLOTS;
+    for (guint32 i = 0; ok && i < RESULT_STORE_SLOTS; i++) {
+        IndexSlot slot = slots[i];
+        if (slot.state != SLOT_LIVE) {
+            continue;
+        }
+        if (slot.offset < snapshot_end) {
+            slot.offset = remap_offset(kept, moved, kept_count, slot.offset);
+            if (slot.offset == 0) {
+                continue;  // Evicted, or unreadable
+            }
+        } else {
+            guint64 at = out_end;
+            int copied = copy_record(log_fd, out_fd, &slot, &out_end);
+            if (copied < 0) {
+                ok = FALSE;
+            }
+            if (copied <= 0) {
+                continue;
+            }
+            slot.offset = at;
+        }
+        *probe(table, slot.key_lo, slot.key_hi) = slot;
+        header.used++;
+        header.live++;
+        header.live_bytes += RECORD_SIZE(slot.length);
+    }
+
+    int new_index_fd = ok ? open(tmp_index, O_RDWR | O_CLOEXEC) : -1;
+    ok = ok && new_index_fd >= 0 &&
+         write_fully(new_index_fd, &header, sizeof(header), 0) &&
+         write_fully(new_index_fd, table, RESULT_STORE_SLOTS * sizeof(IndexSlot),
+                     sizeof(IndexHeader)) &&
+         g_rename(tmp_log, log_path) == 0 && g_rename(tmp_index, index_path) == 0;
+
+    if (ok) {
+        close_store_files();
+        index_fd = new_index_fd;
+        log_fd = out_fd;
+        log_end = out_end;
+        if (!map_index(index_fd)) {
+            // The files are fine; this process just runs without them
+            printf("⚠️  Result store: remapping after compaction failed\n");
+            close_store_files();
+            store_ready = FALSE;
+        }
+        new_index_fd = out_fd = -1;
+    }
+    compacting = FALSE;
+    g_mutex_unlock(&store_lock);
+
+    if (ok) {
+        printf("🧹 Result store compacted: %u entries, %llu KiB, %u evicted (%lld ms)\n",
+               header.live, (unsigned long long)(out_end / 1024), evicted,
+               (long long)((g_get_monotonic_time() - started) / 1000));
+    } else {
+        g_unlink(tmp_index);
+        g_unlink(tmp_log);
+    }
+
+    if (new_index_fd >= 0) close(new_index_fd);
+    if (out_fd >= 0) close(out_fd);
+    if (source_fd >= 0) close(source_fd);
+    free(table);
+    free(moved);
+    free(kept);
+    g_free(tmp_index);
+    g_free(tmp_log);
+    return NULL;
+}
+
+// Kick off compaction if it's due and not already running
+static void maybe_start_compaction() {
+    g_mutex_lock(&store_lock);
+    if (!store_ready || compacting || !compaction_due_locked()) {
+        g_mutex_unlock(&store_lock);
+        return;
+    }
+    compacting = TRUE;
+    GThread* finished = compact_thread;
+    compact_thread = NULL;
+    g_mutex_unlock(&store_lock);
+
+    // The previous run cleared `compacting` just before returning
+    if (finished) {
+        g_thread_join(finished);
+    }
+
+    // Started under the lock so cleanup always sees (and joins) it
+    g_mutex_lock(&store_lock);
+    if (store_ready) {
+        compact_thread = g_thread_new("result-store-compact", compact_thread_func, NULL);
+    } else {
+        compacting = FALSE;
+    }
+    g_mutex_unlock(&store_lock);
+}
+
+// Open (or create) the store
+int init_result_store() {
+    const char* enabled = getenv("INSTANT_TRANSLATOR_PERSISTENT_CACHE");
+    if (enabled && strcmp(enabled, "0") == 0) {
+        printf("ℹ️  Persistent result cache disabled\n");
+        return STATUS_SUCCESS;
+    }
+
+    gint64 started = g_get_monotonic_time();
+    init_crc_table();
+    g_mutex_init(&store_lock);
+
+    char* dir = g_build_filename(g_get_user_cache_dir(), "instant_translator", NULL);
+    if (g_mkdir_with_parents(dir, 0700) != 0) {
+        printf("⚠️  Result store: can't create %s: %s\n", dir, strerror(errno));
+        g_free(dir);
+        return STATUS_SUCCESS;
+    }
+
+    // One owner at a time; a second instance keeps its cache in memory
+    char* lock_path = g_build_filename(dir, "results.lock", NULL);
+    lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    g_free(lock_path);
+    if (lock_fd < 0 || flock(lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        printf("ℹ️  Result store in use by another instance; caching in memory only\n");
+        if (lock_fd >= 0) {
+            close(lock_fd);
+            lock_fd = -1;
+        }
+        g_free(dir);
+        return STATUS_SUCCESS;
+    }
+
+    index_path = g_build_filename(dir, "results.idx", NULL);
+    log_path = g_build_filename(dir, "results.log", NULL);
+    g_free(dir);
+
+    if (!open_store_files()) {
+        close_store_files();
+        if (!create_store_files(index_path, log_path) || !open_store_files()) {
+            printf("⚠️  Result store: can't open %s\n", index_path);
+            close_store_files();
+            return STATUS_SUCCESS;
+        }
+    }
+
+    store_ready = TRUE;
+    printf("✅ Result store ready: %u entries, %llu KiB log (%lld µs)\n",
+           index_header->live, (unsigned long long)(log_end / 1024),
+           (long long)(g_get_monotonic_time() - started));
+
+    maybe_start_compaction();
+    return STATUS_SUCCESS;
+}
+
+// Wait for compaction and unmap everything
+void cleanup_result_store() {
+    if (!index_path) {
+        return;
+    }
+
+    g_mutex_lock(&store_lock);
+    store_ready = FALSE;
+    GThread* thread = compact_thread;
+    compact_thread = NULL;
+    g_mutex_unlock(&store_lock);
+
+    if (thread) {
+        g_thread_join(thread);
+    }
+
+    close_store_files();
+    if (lock_fd >= 0) {
+        close(lock_fd);  // Releases the flock
+        lock_fd = -1;
+    }
+    g_free(index_path);
+    g_free(log_path);
+    index_path = NULL;
+    log_path = NULL;
+}
+
+int result_store_lookup(const ResultKey* key, char** result) {
+    if (!index_path || !key || !result) {
+        return 0;
+    }
+
+    g_mutex_lock(&store_lock);
+    if (!store_ready) {
+        g_mutex_unlock(&store_lock);
+        return 0;
+    }
+
+    IndexSlot* slot = probe(slots, key->lo, key->hi);
+    char* value = NULL;
+    if (slot && slot->state == SLOT_LIVE) {
+        value = read_record(log_fd, slot);
+        if (!value) {
+            kill_slot_locked(slot);  // Torn or overwritten; don't try again
+        }
+    }
+    g_mutex_unlock(&store_lock);
+
+    if (!value) {
+        return 0;
+    }
+    *result = value;
+    return 1;
+}
+
+int result_store_contains(const ResultKey* key) {
+    if (!index_path || !key) {
+        return 0;
+    }
+
+    g_mutex_lock(&store_lock);
+    IndexSlot* slot = store_ready ? probe(slots, key->lo, key->hi) : NULL;
+    gboolean found = slot && slot->state == SLOT_LIVE;
+    g_mutex_unlock(&store_lock);
+    return found;
+}
+
+void result_store_append(const ResultKey* key, const char* operation, const char* result) {
+    if (!index_path || !key || !operation || !result) {
+        return;
+    }
+
+    size_t length = strlen(result);
+    if (RECORD_SIZE(length) > RESULT_STORE_LOG_BUDGET / 16) {
+        return;  // Not worth a sixteenth of the log
+    }
+
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = RECORD_MAGIC;
+    header.length = (guint32)length;
+    header.crc = crc32_of(result, length);
+    header.key_lo = key->lo;
+    header.key_hi = key->hi;
+
+    g_mutex_lock(&store_lock);
+    if (!store_ready || index_header->used >= INDEX_HARD_LIMIT ||
+        log_end + RECORD_SIZE(length) > RESULT_STORE_LOG_BUDGET * 2) {
+        g_mutex_unlock(&store_lock);
+        maybe_start_compaction();
+        return;  // Full until compaction catches up
+    }
+
+    // Value first, then the slot, so the index never points past the log
+    guint64 offset = log_end;
+    if (!write_fully(log_fd, &header, sizeof(header), offset) ||
+        !write_fully(log_fd, result, length, offset + sizeof(header))) {
+        g_mutex_unlock(&store_lock);
+        return;
+    }
+    log_end += RECORD_SIZE(length);
+
+    IndexSlot* slot = probe(slots, key->lo, key->hi);
+    if (slot->state == SLOT_LIVE) {
+        index_header->live--;
+        index_header->live_bytes -= RECORD_SIZE(slot->length);
+    } else {
+        index_header->used++;
+    }
+    slot->key_lo = key->lo;
+    slot->key_hi = key->hi;
+    slot->offset = offset;
+    slot->length = (guint32)length;
+    slot->operation_tag = operation_tag_for(operation);
+    slot->state = SLOT_LIVE;
+    index_header->live++;
+    index_header->live_bytes += RECORD_SIZE(length);
+    g_mutex_unlock(&store_lock);
+
+    maybe_start_compaction();
+}
+
+void result_store_invalidate_operation(const char* operation) {
+    if (!index_path || !operation) {
+        return;
+    }
+
+    // Tags are 32-bit hashes, so a collision only drops a few extra entries
+    guint32 tag = operation_tag_for(operation);
+    int dropped = 0;
+    g_mutex_lock(&store_lock);
+    for (guint32 i = 0; store_ready && i < RESULT_STORE_SLOTS; i++) {
+        if (slots[i].state == SLOT_LIVE && slots[i].operation_tag == tag) {
+            kill_slot_locked(&slots[i]);
+            dropped++;
+        }
+    }
+    g_mutex_unlock(&store_lock);
+
+    if (dropped > 0) {
+        printf("🗑️  Result store dropped %d entries for %s\n", dropped, operation);
+        maybe_start_compaction();
+    }
+}
+
+void result_store_clear() {
+    if (!index_path) {
+        return;
+    }
+
+    g_mutex_lock(&store_lock);
+    if (store_ready) {
+        generation++;
+        memset(slots, 0, RESULT_STORE_SLOTS * sizeof(IndexSlot));
+        index_header->used = 0;
+        index_header->live = 0;
+        index_header->live_bytes = 0;
+        if (ftruncate(log_fd, LOG_HEADER_SIZE) == 0) {
+            log_end = LOG_HEADER_SIZE;
+        }
+    }
+    g_mutex_unlock(&store_lock);
+}
+
+void result_store_get_usage(long* entries, long* bytes) {
+    *entries = 0;
+    *bytes = 0;
+    if (!index_path) {
+        return;
+    }
+
+    g_mutex_lock(&store_lock);
+    if (store_ready) {
+        *entries = (long)index_header->live;
+        *bytes = (long)log_end;
+    }
+    g_mutex_unlock(&store_lock);
+}
@@ -0,0 +1,62 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include "../include/instant_translator.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// On-disk tier under the result cache, in $XDG_CACHE_HOME/instant_translator:
+//
+//   results.idx  fixed-size open-addressed index (linear probing), mmap'd
+//                at startup; slots hold key, log offset and value length
+//   results.log  append-only records: header (magic, length, CRC-32, key)
+//                followed by the value bytes
+//
+// Opening costs the same whatever the cache holds: nothing is scanned, and
+// index pages fault in as lookups touch them. Every read checks the
+// record's key and CRC, so a torn write or crash mid-compaction costs a
+// miss, never a wrong result. Compaction runs on a background thread once
+// garbage outweighs live data or a limit is near, and then also drops
+// the oldest entries.
+#define RESULT_STORE_SLOTS 65536                        // Power of two
+#define RESULT_STORE_LOG_BUDGET (64 * 1024 * 1024)
+
+// Content address shared with the in-memory tier
+typedef struct {
+    uint64_t lo;
+    uint64_t hi;
+} ResultKey;
+
+// Open (or create) the store. A store that can't be opened, or is held
+// by another instance, leaves the cache memory-only; that isn't an error.
+int init_result_store();
+
+// Wait for compaction and unmap everything
+void cleanup_result_store();
+
+// 1 and the stored value (free with free()), or 0
+int result_store_lookup(const ResultKey* key, char** result);
+
+// Whether a live entry exists, without reading it
+int result_store_contains(const ResultKey* key);
+
+// Append a value; `operation` tags it for invalidation
+void result_store_append(const ResultKey* key, const char* operation, const char* result);
+
+// Drop every entry tagged with `operation`
+void result_store_invalidate_operation(const char* operation);
+
+// Drop everything
+void result_store_clear();
+
+// Live entries and log size, for diagnostics
+void result_store_get_usage(long* entries, long* bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESULT_STORE_H
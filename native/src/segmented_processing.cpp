@@ -0,0 +1,91 @@
+#include "segmented_processing.h"
+#include "text_segmenter.h"
+#include "result_cache.h"
+#include "translation_memory.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Earlier result for a near-identical sentence, when serving those is on
+static gboolean memory_serves(const char* text, const char* operation, double serve_similarity,
+                              char** result) {
+    char* source;
+    if (serve_similarity <= 0 ||
+        !translation_memory_lookup(text, operation, serve_similarity, &source, result, NULL)) {
+        return FALSE;
+    }
+    free(source);
+    return TRUE;
+}
+
+int process_by_segments(const char* text, const char* operation, SegmentBatchSender send_batch,
+                        int* status, char** result) {
+    TextSpan* spans;
+    int count;
+    if (segment_text(text, &spans, &count) != STATUS_SUCCESS) {
+        return 0;
+    }
+    if (count < 2) {
+        free(spans);
+        return 0;
+    }
+
+    double hint_similarity, serve_similarity;
+    translation_memory_get_thresholds(&hint_similarity, &serve_similarity);
+
+    char** parts = (char**)calloc(count, sizeof(char*));
+    ProcessingSegment* misses = (ProcessingSegment*)malloc(sizeof(ProcessingSegment) * count);
+    int miss_count = 0;
+    int reused = 0;
+    for (int i = 0; i < count; i++) {
+        char* segment = strndup(text + spans[i].start, spans[i].length);
+        if (result_cache_lookup(segment, operation, &parts[i]) ||
+            memory_serves(segment, operation, serve_similarity, &parts[i])) {
+            free(segment);
+            reused++;
+            continue;
+        }
+        misses[miss_count].id = i;
+        misses[miss_count].text = segment;
+        misses[miss_count].operation = (char*)operation;
+        miss_count++;
+    }
+
+    *status = STATUS_SUCCESS;
+    if (miss_count > 0) {
+        ProcessingSegmentResult* answers = NULL;
+        *status = send_batch(misses, miss_count, &answers);
+        for (int j = 0; *status == STATUS_SUCCESS && j < miss_count; j++) {
+            if (answers[j].status != STATUS_SUCCESS) {
+                *status = answers[j].status;
+                break;
+            }
+            parts[misses[j].id] = answers[j].result;
+            answers[j].result = NULL;
+
+            // Kept per sentence, so an edit elsewhere doesn't resend this one
+            result_cache_store(misses[j].text, operation, parts[misses[j].id]);
+            translation_memory_add(misses[j].text, operation, parts[misses[j].id]);
+        }
+        if (answers) {
+            free_processing_results(answers, miss_count);
+        }
+    }
+
+    if (*status == STATUS_SUCCESS) {
+        *result = join_segments(text, spans, count, parts);
+        printf("🧩 %d segments, %d answered from cache\n", count, reused);
+    }
+
+    for (int j = 0; j < miss_count; j++) {
+        free(misses[j].text);
+    }
+    for (int i = 0; i < count; i++) {
+        if (parts[i]) free(parts[i]);
+    }
+    free(misses);
+    free(parts);
+    free(spans);
+    return 1;
+}
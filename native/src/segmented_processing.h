@@ -0,0 +1,29 @@
+#ifndef SEGMENTED_PROCESSING_H
+#define SEGMENTED_PROCESSING_H
+
+#include "../include/instant_translator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sends segments the caches couldn't answer, with send_processing_batch's
+// contract
+typedef int (*SegmentBatchSender)(const ProcessingSegment* segments, int count,
+                                  ProcessingSegmentResult** results);
+
+// Answer a multi-sentence selection sentence by sentence: sentences in the
+// result cache (or served by the translation memory) are reused, the rest
+// go out through `send_batch` in one call, and the answers are joined with
+// the selection's own whitespace. Every fresh answer is remembered per
+// sentence, so after editing one sentence of a paragraph only that one is
+// sent again. 0 when the text is a single sentence, leaving it to the
+// caller; otherwise 1 with `*status` (and `*result` on success).
+int process_by_segments(const char* text, const char* operation, SegmentBatchSender send_batch,
+                        int* status, char** result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SEGMENTED_PROCESSING_H
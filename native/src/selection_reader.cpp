@@ -0,0 +1,378 @@
+#include "selection_reader.h"
+#include "x11_reactor.h"
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// Requestor window on the reactor connection
+static Display* display = NULL;
+static Window requestor = None;
+static Atom transfer_property;
+static Atom incr_atom;
+
+// Progress of the conversion in flight, fed by the reactor handler
+static gboolean notify_received = FALSE;
+static Atom notify_property = None;
+static int property_updates = 0;
+
+// Text targets tried when UTF8_STRING is not offered, best first. TEXT
+// is left out: owners answer it with COMPOUND_TEXT, which isn't decoded.
+static const char* text_target_names[] = {
+    "text/plain;charset=utf-8",
+    "STRING",
+    "text/plain",
+};
+static Atom text_targets[G_N_ELEMENTS(text_target_names)];
+
+// Make room for `extra` more bytes plus the terminating NUL
+static gboolean buffer_reserve(SelectionBuffer* buffer, size_t extra) {
+    size_t needed = buffer->length + extra + 1;
+    if (needed <= buffer->capacity) {
+        return TRUE;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+
+    char* data = (char*)realloc(buffer->data, capacity);
+    if (!data) {
+        return FALSE;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return TRUE;
+}
+
+// Bytes occupied by `nitems` items of the given property format
+static size_t property_bytes(int format, unsigned long nitems) {
+    switch (format) {
+        case 32: return nitems * sizeof(long);
+        case 16: return nitems * sizeof(short);
+        default: return nitems;
+    }
+}
+
+// Reactor handler: track SelectionNotify and transfer property updates
+static int reader_event_handler(XEvent* event, void* user_data) {
+    if (event->type == SelectionNotify && event->xselection.requestor == requestor) {
+        notify_received = TRUE;
+        notify_property = event->xselection.property;
+        return 1;
+    }
+    // Deletes are left to the clipboard owner, which may be the one
+    // streaming INCR chunks to this window
+    if (event->type == PropertyNotify && event->xproperty.window == requestor &&
+        event->xproperty.atom == transfer_property &&
+        event->xproperty.state == PropertyNewValue) {
+        property_updates++;
+        return 1;
+    }
+    return 0;
+}
+
+static int notify_arrived(void* user_data) {
+    return notify_received;
+}
+
+static int property_updated(void* user_data) {
+    return property_updates > *(int*)user_data;
+}
+
+// Stream the whole transfer property into the sink and delete it
+static gboolean append_property(SelectionSink* sink, size_t* appended) {
+    long offset = 0;
+    *appended = 0;
+
+    while (TRUE) {
+        Atom actual_type;
+        int actual_format;
+        unsigned long nitems, bytes_after;
+        unsigned char* prop = NULL;
+
+        // Request in 1MB slices
+        if (XGetWindowProperty(display, requestor, transfer_property, offset, 262144,
+                               False, AnyPropertyType, &actual_type, &actual_format,
+                               &nitems, &bytes_after, &prop) != Success) {
+            return FALSE;
+        }
+
+        if (actual_type != None) {
+            sink->type = actual_type;
+            sink->format = actual_format;
+        }
+
+        size_t bytes = property_bytes(actual_format, nitems);
+        gboolean ok = bytes == 0 || sink->write(sink->ctx, (const char*)prop, bytes);
+        if (prop) XFree(prop);
+        if (!ok) {
+            XDeleteProperty(display, requestor, transfer_property);
+            return FALSE;
+        }
+        *appended += bytes;
+
+        if (bytes_after == 0) {
+            break;
+        }
+        // Offsets are counted in 32-bit units regardless of format
+        offset += (long)(nitems * actual_format / 32);
+    }
+
+    XDeleteProperty(display, requestor, transfer_property);
+    return TRUE;
+}
+
+// Receive an INCR transfer chunk by chunk
+static gboolean receive_incr(SelectionSink* sink, int timeout_ms) {
+    // Deleting the INCR property tells the owner to start sending
+    XDeleteProperty(display, requestor, transfer_property);
+    XFlush(display);
+
+    size_t total = 0;
+    while (TRUE) {
+        int seen = property_updates;
+        if (!x11_reactor_pump_until(property_updated, &seen, timeout_ms)) {
+            printf("⚠️  INCR selection transfer timed out after %zu bytes\n", total);
+            return FALSE;
+        }
+
+        size_t appended;
+        if (!append_property(sink, &appended)) {
+            return FALSE;
+        }
+        XFlush(display);
+        total += appended;
+
+        // A zero-length chunk terminates the transfer
+        if (appended == 0) {
+            return TRUE;
+        }
+    }
+}
+
+// Sink callbacks that collect everything into a SelectionBuffer
+static int buffer_sink_reserve(void* ctx, size_t size_hint) {
+    return buffer_reserve((SelectionBuffer*)ctx, size_hint);
+}
+
+static int buffer_sink_write(void* ctx, const char* data, size_t length) {
+    SelectionBuffer* buffer = (SelectionBuffer*)ctx;
+    if (!buffer_reserve(buffer, length)) {
+        return FALSE;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return TRUE;
+}
+
+static void setup_reader_task(Display* task_display, void* user_data) {
+    display = task_display;
+
+    // Unmapped window that receives converted selections
+    XSetWindowAttributes attrs;
+    attrs.event_mask = PropertyChangeMask;
+    requestor = XCreateWindow(display, DefaultRootWindow(display), -10, -10, 1, 1, 0,
+                              CopyFromParent, InputOnly, CopyFromParent,
+                              CWEventMask, &attrs);
+
+    transfer_property = XInternAtom(display, "INSTANT_TRANSLATOR_SELECTION", False);
+    incr_atom = XInternAtom(display, "INCR", False);
+    for (size_t i = 0; i < G_N_ELEMENTS(text_target_names); i++) {
+        text_targets[i] = XInternAtom(display, text_target_names[i], False);
+    }
+
+    x11_reactor_add_handler(reader_event_handler, NULL);
+}
+
+static void teardown_reader_task(Display* task_display, void* user_data) {
+    x11_reactor_remove_handler(reader_event_handler, NULL);
+    if (requestor != None) {
+        XDestroyWindow(task_display, requestor);
+        requestor = None;
+    }
+    display = NULL;
+}
+
+// Initialize the in-process selection reader
+int init_selection_reader() {
+    return x11_reactor_call(setup_reader_task, NULL);
+}
+
+// Cleanup the selection reader
+void cleanup_selection_reader() {
+    if (display) {
+        x11_reactor_call(teardown_reader_task, NULL);
+    }
+}
+
+// One conversion, executed on the reactor thread
+typedef struct {
+    Atom selection;
+    Atom target;
+    SelectionSink* sink;
+    int timeout_ms;
+    int status;
+} ReadRequest;
+
+static void read_selection_task(Display* task_display, void* user_data) {
+    ReadRequest* request = (ReadRequest*)user_data;
+    SelectionSink* sink = request->sink;
+
+    notify_received = FALSE;
+    notify_property = None;
+
+    XDeleteProperty(display, requestor, transfer_property);
+    XConvertSelection(display, request->selection, request->target, transfer_property,
+                      requestor, CurrentTime);
+
+    request->status = STATUS_ERROR_NO_SELECTION;
+    if (!x11_reactor_pump_until(notify_arrived, NULL, request->timeout_ms) ||
+        notify_property == None) {
+        return;
+    }
+
+    // Peek at the type without fetching any data yet
+    Atom actual_type;
+    int actual_format;
+    unsigned long nitems, bytes_after;
+    unsigned char* prop = NULL;
+    XGetWindowProperty(display, requestor, transfer_property, 0, 0, False,
+                       AnyPropertyType, &actual_type, &actual_format,
+                       &nitems, &bytes_after, &prop);
+    if (prop) XFree(prop);
+
+    gboolean ok;
+    if (actual_type == incr_atom) {
+        // The INCR property value is a lower bound on the total size
+        unsigned char* hint = NULL;
+        if (XGetWindowProperty(display, requestor, transfer_property, 0, 1, False,
+                               AnyPropertyType, &actual_type, &actual_format,
+                               &nitems, &bytes_after, &hint) == Success && hint) {
+            if (nitems > 0 && sink->reserve) {
+                sink->reserve(sink->ctx, (size_t)*(long*)hint);
+            }
+            XFree(hint);
+        }
+        ok = receive_incr(sink, request->timeout_ms);
+    } else {
+        size_t appended;
+        ok = append_property(sink, &appended);
+    }
+
+    request->status = ok ? STATUS_SUCCESS : STATUS_ERROR_NO_SELECTION;
+}
+
+// Convert a selection and stream the result into `sink`
+int read_selection_to_sink(Atom selection, Atom target, SelectionSink* sink, int timeout_ms) {
+    if (!sink || !sink->write) {
+        return STATUS_ERROR_INIT;
+    }
+    sink->type = None;
+    sink->format = 0;
+
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    ReadRequest request = { selection, target, sink, timeout_ms, STATUS_ERROR_NO_SELECTION };
+    int status = x11_reactor_call(read_selection_task, &request);
+    return status == STATUS_SUCCESS ? request.status : status;
+}
+
+// Convert a selection and read the result into `out`
+int read_selection(Atom selection, Atom target, SelectionBuffer* out, int timeout_ms) {
+    if (!out) {
+        return STATUS_ERROR_INIT;
+    }
+    memset(out, 0, sizeof(*out));
+
+    SelectionSink sink;
+    sink.reserve = buffer_sink_reserve;
+    sink.write = buffer_sink_write;
+    sink.ctx = out;
+
+    int status = read_selection_to_sink(selection, target, &sink, timeout_ms);
+    if (status != STATUS_SUCCESS) {
+        selection_buffer_free(out);
+        return status;
+    }
+
+    out->type = sink.type;
+    out->format = sink.format;
+    return STATUS_SUCCESS;
+}
+
+// Turn a text transfer into a malloc'd UTF-8 string, taking the buffer.
+// STRING is ISO-8859-1; anything else should already be UTF-8, and
+// invalid sequences are replaced rather than passed on.
+static char* take_text_as_utf8(SelectionBuffer* buffer, Atom target) {
+    if (buffer->length == 0) {
+        selection_buffer_free(buffer);
+        return NULL;
+    }
+    if (target != XA_STRING && g_utf8_validate(buffer->data, buffer->length, NULL)) {
+        return buffer->data;
+    }
+
+    gchar* converted = target == XA_STRING
+        ? g_convert(buffer->data, buffer->length, "UTF-8", "ISO-8859-1", NULL, NULL, NULL)
+        : g_utf8_make_valid(buffer->data, buffer->length);
+    selection_buffer_free(buffer);
+
+    char* text = converted ? strdup(converted) : NULL;
+    g_free(converted);
+    return text;
+}
+
+// Read a selection as UTF-8 text
+char* read_selection_text(Atom selection, Atom utf8_string_atom, Atom targets_atom) {
+    SelectionBuffer buffer;
+
+    // Fast path: almost every owner offers UTF8_STRING
+    if (read_selection(selection, utf8_string_atom, &buffer, SELECTION_READ_TIMEOUT_MS) == STATUS_SUCCESS) {
+        char* text = take_text_as_utf8(&buffer, utf8_string_atom);
+        if (text) {
+            return text;
+        }
+    }
+
+    // Otherwise pick the best text target the owner advertises
+    if (read_selection(selection, targets_atom, &buffer, SELECTION_READ_TIMEOUT_MS) != STATUS_SUCCESS) {
+        return NULL;
+    }
+
+    Atom* offered = (Atom*)buffer.data;
+    size_t offered_count = buffer.format == 32 ? buffer.length / sizeof(long) : 0;
+    char* text = NULL;
+
+    for (size_t t = 0; t < G_N_ELEMENTS(text_targets) && !text; t++) {
+        Atom candidate = text_targets[t];
+        for (size_t i = 0; i < offered_count; i++) {
+            if (offered[i] != candidate) continue;
+
+            SelectionBuffer text_buffer;
+            if (read_selection(selection, candidate, &text_buffer, SELECTION_READ_TIMEOUT_MS) == STATUS_SUCCESS) {
+                text = take_text_as_utf8(&text_buffer, candidate);
+            }
+            break;
+        }
+    }
+
+    selection_buffer_free(&buffer);
+    return text;
+}
+
+// Release buffer contents
+void selection_buffer_free(SelectionBuffer* buffer) {
+    if (!buffer) return;
+
+    if (buffer->data) {
+        free(buffer->data);
+    }
+    memset(buffer, 0, sizeof(*buffer));
+}
@@ -0,0 +1,60 @@
+#ifndef SELECTION_READER_H
+#define SELECTION_READER_H
+
+#include "../include/instant_translator.h"
+#include <X11/Xlib.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Growable buffer holding one converted selection value
+typedef struct {
+    char* data;         // Always NUL-terminated when length > 0
+    size_t length;      // Bytes of payload
+    size_t capacity;    // Allocated bytes
+    Atom type;          // Property type reported by the owner
+    int format;         // 8, 16 or 32 (32-bit items are stored as longs)
+} SelectionBuffer;
+
+// Receives converted data as it arrives, without intermediate copies
+typedef struct {
+    // Optional: announced total size of an INCR transfer
+    int (*reserve)(void* ctx, size_t size_hint);
+    // Called for each slice; return 0 to abort the transfer
+    int (*write)(void* ctx, const char* data, size_t length);
+    void* ctx;
+    Atom type;          // Filled in by the reader
+    int format;         // Filled in by the reader
+} SelectionSink;
+
+// Default wait for the selection owner to answer
+#define SELECTION_READ_TIMEOUT_MS 1000
+
+// Initialize the in-process selection reader (on the X11 reactor)
+int init_selection_reader();
+
+// Cleanup the selection reader
+void cleanup_selection_reader();
+
+// Convert `selection` to `target` and read the result, following INCR
+// transfers. Returns STATUS_ERROR_NO_SELECTION if the owner refused.
+int read_selection(Atom selection, Atom target, SelectionBuffer* out, int timeout_ms);
+
+// Like read_selection() but streams slices into `sink` as they arrive
+int read_selection_to_sink(Atom selection, Atom target, SelectionSink* sink, int timeout_ms);
+
+// Read a selection as UTF-8 text, falling back to other text targets
+// offered in TARGETS. STRING is converted from ISO-8859-1 and invalid
+// UTF-8 is repaired. Returns a malloc'd string or NULL.
+char* read_selection_text(Atom selection, Atom utf8_string_atom, Atom targets_atom);
+
+// Release buffer contents
+void selection_buffer_free(SelectionBuffer* buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SELECTION_READER_H
@@ -0,0 +1,261 @@
+#include "speculative_processing.h"
+#include "dbus_service.h"
+#include "result_cache.h"
+#include "chunked_processing.h"
+#include "processing_scheduler.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+// One background request, shared by the worker and a promoting caller
+typedef struct {
+    gint refcount;
+    char* text;
+    char* operation;
+    int request_id;     // Asynchronous ProcessText call, 0 until sent
+    gboolean done;
+    gboolean cancelled;
+    int status;
+    char* result;
+    gint64 started_at;
+    gboolean streamed;  // At least one chunk arrived
+} Speculation;
+
+// State guarded by speculation_lock
+static GMutex speculation_lock;
+static GCond speculation_cond;
+static Speculation* current_speculation = NULL;
+static gboolean speculation_enabled = TRUE;
+static SpeculationPreviewCallback preview_callback = NULL;
+
+static void speculation_unref(Speculation* speculation) {
+    if (speculation && g_atomic_int_dec_and_test(&speculation->refcount)) {
+        free(speculation->text);
+        free(speculation->operation);
+        if (speculation->result) free(speculation->result);
+        free(speculation);
+    }
+}
+
+// Detach the current speculation and return the request to cancel once
+// speculation_lock is released (cancelling runs its callback, which takes
+// the lock). Caller holds speculation_lock.
+static int detach_current_locked() {
+    if (!current_speculation) return 0;
+
+    current_speculation->cancelled = TRUE;
+    int request_id = current_speculation->request_id;
+    printf("🔮 Speculative %s cancelled\n", current_speculation->operation);
+    speculation_unref(current_speculation);
+    current_speculation = NULL;
+    return request_id;
+}
+
+static void cancel_request(int request_id) {
+    if (request_id > 0) {
+        cancel_processing_request(request_id);
+    }
+}
+
+// A chunk of the result arrived (D-Bus dispatcher thread)
+static void on_speculation_progress(int request_id, const char* partial, void* data) {
+    Speculation* speculation = (Speculation*)data;
+
+    g_mutex_lock(&speculation_lock);
+    gboolean live = !speculation->cancelled;
+    gboolean first = live && !speculation->streamed;
+    speculation->streamed = TRUE;
+    SpeculationPreviewCallback callback = preview_callback;
+    g_mutex_unlock(&speculation_lock);
+
+    if (first) {
+        printf("🔮 Speculative %s first chunk %ldms after menu opened\n", speculation->operation,
+               (long)((g_get_monotonic_time() - speculation->started_at) / 1000));
+    }
+
+    // text/operation never change, and the request holds a reference
+    if (live && callback) {
+        callback(speculation->text, speculation->operation, partial);
+    }
+}
+
+// Completion of the asynchronous request (D-Bus dispatcher thread)
+static void on_speculation_done(int request_id, int status, const char* result, void* data) {
+    Speculation* speculation = (Speculation*)data;
+
+    g_mutex_lock(&speculation_lock);
+    speculation->status = status;
+    if (!speculation->cancelled && result) {
+        speculation->result = strdup(result);
+    }
+    speculation->done = TRUE;
+    g_cond_broadcast(&speculation_cond);
+    g_mutex_unlock(&speculation_lock);
+
+    speculation_unref(speculation);
+}
+
+// Initialize speculative processing
+int init_speculative_processing() {
+    g_mutex_init(&speculation_lock);
+    g_cond_init(&speculation_cond);
+    return STATUS_SUCCESS;
+}
+
+// Cleanup speculative processing
+void cleanup_speculative_processing() {
+    g_mutex_lock(&speculation_lock);
+    int request_id = detach_current_locked();
+    g_mutex_unlock(&speculation_lock);
+    cancel_request(request_id);
+}
+
+void speculation_set_enabled(int enabled) {
+    g_mutex_lock(&speculation_lock);
+    speculation_enabled = enabled ? TRUE : FALSE;
+    int request_id = speculation_enabled ? 0 : detach_current_locked();
+    g_mutex_unlock(&speculation_lock);
+    cancel_request(request_id);
+}
+
+int speculation_is_enabled() {
+    g_mutex_lock(&speculation_lock);
+    int enabled = speculation_enabled;
+    g_mutex_unlock(&speculation_lock);
+    return enabled;
+}
+
+void speculation_set_preview_callback(SpeculationPreviewCallback callback) {
+    g_mutex_lock(&speculation_lock);
+    preview_callback = callback;
+    g_mutex_unlock(&speculation_lock);
+}
+
+// Start processing the most likely action in the background
+void speculation_start(const char* text, const char* operation) {
+    if (!text || !operation || strlen(text) == 0) {
+        return;
+    }
+
+    // The answer is already cached; there is nothing to get ahead on
+    if (result_cache_contains(text, operation)) {
+        return;
+    }
+
+    // Long selections are processed in chunks, which one call can't stand in for
+    if (chunked_processing_wanted(text)) {
+        return;
+    }
+
+    g_mutex_lock(&speculation_lock);
+    if (!speculation_enabled) {
+        g_mutex_unlock(&speculation_lock);
+        return;
+    }
+
+    // Already working on exactly this (and not preempted since)
+    if (current_speculation && !strcmp(current_speculation->text, text) &&
+        !strcmp(current_speculation->operation, operation) &&
+        !(current_speculation->done && current_speculation->status == STATUS_CANCELLED)) {
+        g_mutex_unlock(&speculation_lock);
+        return;
+    }
+    int replaced_id = detach_current_locked();
+
+    Speculation* speculation = (Speculation*)calloc(1, sizeof(Speculation));
+    speculation->refcount = 3;  // current_speculation + completion + this call
+    speculation->text = strdup(text);
+    speculation->operation = strdup(operation);
+    speculation->started_at = g_get_monotonic_time();
+    current_speculation = speculation;
+    g_mutex_unlock(&speculation_lock);
+
+    cancel_request(replaced_id);
+    printf("🔮 Speculatively processing with %s\n", operation);
+
+    // Stream it so the popup can preview the result as it is generated. It
+    // yields its backend slot to anything the user is waiting on.
+    int request_id = dbus_start_streaming_request(text, operation, PRIORITY_SPECULATIVE, 0,
+                                                  on_speculation_progress, on_speculation_done, speculation);
+
+    g_mutex_lock(&speculation_lock);
+    if (request_id < 0) {
+        // Never sent; there will be no completion
+        speculation->status = request_id;
+        speculation->done = TRUE;
+        g_cond_broadcast(&speculation_cond);
+        speculation_unref(speculation);
+    } else {
+        speculation->request_id = request_id;
+    }
+    // Cancelled before the id was known: cancel it now
+    int late_cancel = (speculation->cancelled && request_id > 0) ? request_id : 0;
+    g_mutex_unlock(&speculation_lock);
+
+    cancel_request(late_cancel);
+    speculation_unref(speculation);
+}
+
+// Drop the current speculation
+void speculation_cancel() {
+    g_mutex_lock(&speculation_lock);
+    int request_id = detach_current_locked();
+    g_mutex_unlock(&speculation_lock);
+    cancel_request(request_id);
+}
+
+// Keep only a speculation the chosen action can still use
+void speculation_cancel_unless(const char* text, const char* operation) {
+    g_mutex_lock(&speculation_lock);
+    int request_id = 0;
+    if (current_speculation &&
+        (!text || !operation || strcmp(current_speculation->text, text) != 0 ||
+         strcmp(current_speculation->operation, operation) != 0)) {
+        request_id = detach_current_locked();
+    }
+    g_mutex_unlock(&speculation_lock);
+    cancel_request(request_id);
+}
+
+// Promote a matching speculation, or cancel a mismatched one
+int speculation_take(const char* text, const char* operation, int* status, char** result) {
+    g_mutex_lock(&speculation_lock);
+
+    Speculation* speculation = current_speculation;
+    if (!speculation) {
+        g_mutex_unlock(&speculation_lock);
+        return 0;
+    }
+
+    if (strcmp(speculation->text, text) != 0 || strcmp(speculation->operation, operation) != 0) {
+        // The user chose something else
+        int request_id = detach_current_locked();
+        g_mutex_unlock(&speculation_lock);
+        cancel_request(request_id);
+        return 0;
+    }
+
+    // Consume it: the reference moves from current_speculation to us
+    current_speculation = NULL;
+    gboolean was_done = speculation->done;
+    if (!was_done && speculation->request_id > 0) {
+        // Someone is waiting on it now. Completions never hold the locks
+        // this takes while taking speculation_lock.
+        dbus_promote_request(speculation->request_id, scheduler_thread_priority());
+    }
+    while (!speculation->done) {
+        g_cond_wait(&speculation_cond, &speculation_lock);
+    }
+
+    *status = speculation->status;
+    *result = speculation->result;
+    speculation->result = NULL;
+    g_mutex_unlock(&speculation_lock);
+
+    printf("🔮 Speculative %s promoted (%s, %ldms after menu opened)\n", operation,
+           was_done ? "already finished" : "joined in flight",
+           (long)((g_get_monotonic_time() - speculation->started_at) / 1000));
+    speculation_unref(speculation);
+    return 1;
+}
@@ -0,0 +1,45 @@
+#ifndef SPECULATIVE_PROCESSING_H
+#define SPECULATIVE_PROCESSING_H
+
+#include "../include/instant_translator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Initialize speculative processing
+int init_speculative_processing();
+
+// Cancel any speculation
+void cleanup_speculative_processing();
+
+// Enable or disable speculation (enabled by default)
+void speculation_set_enabled(int enabled);
+int speculation_is_enabled();
+
+// Receives the streamed partial result of the current speculation for
+// (`text`, `operation`) as it grows (D-Bus dispatcher thread)
+typedef void (*SpeculationPreviewCallback)(const char* text, const char* operation, const char* partial);
+
+void speculation_set_preview_callback(SpeculationPreviewCallback callback);
+
+// Start processing `text` with `operation` in the background, replacing
+// any earlier speculation
+void speculation_start(const char* text, const char* operation);
+
+// Drop the current speculation and cancel its D-Bus call
+void speculation_cancel();
+
+// Cancel the current speculation unless it is for (`text`, `operation`)
+void speculation_cancel_unless(const char* text, const char* operation);
+
+// If the current speculation is for (`text`, `operation`), wait for it and
+// hand over its status and result, returning 1. Otherwise cancel it and
+// return 0.
+int speculation_take(const char* text, const char* operation, int* status, char** result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPECULATIVE_PROCESSING_H
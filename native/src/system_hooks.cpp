@@ -3,6 +3,19 @@
 #include "context_menu_injector.h"
 #include "dbus_service.h"
 #include "text_replacement.h"
+#include "selection_reader.h"
+#include "clipboard_owner.h"
+#include "x11_reactor.h"
+#include "hotkey_registry.h"
+#include "speculative_processing.h"
+#include "action_channel.h"
+#include "dart_port_bridge.h"
+#include "result_cache.h"
+#include "result_store.h"
+#include "translation_memory.h"
+#include "chunked_processing.h"
+#include "admission_control.h"
+#include "processing_scheduler.h"
 
 #include <gtk/gtk.h>
 #include <glib.h>
@@ -16,6 +29,27 @@ static GMainLoop* main_loop = NULL;
 static GThread* gtk_thread = NULL;
 static char* last_error = NULL;
 
+// Subsystems init_system_hooks() has started, so a failed start can stop
+// exactly those
+enum {
+    SUBSYSTEM_X11_REACTOR = 1 << 0,
+    SUBSYSTEM_SELECTION_READER = 1 << 1,
+    SUBSYSTEM_SELECTION_MONITOR = 1 << 2,
+    SUBSYSTEM_ACTION_CHANNEL = 1 << 3,
+    SUBSYSTEM_CONTEXT_MENU = 1 << 4,
+    SUBSYSTEM_HOTKEYS = 1 << 5,
+    SUBSYSTEM_RESULT_STORE = 1 << 6,
+    SUBSYSTEM_RESULT_CACHE = 1 << 7,
+    SUBSYSTEM_TRANSLATION_MEMORY = 1 << 8,
+    SUBSYSTEM_ADMISSION = 1 << 9,
+    SUBSYSTEM_DBUS = 1 << 10,
+    SUBSYSTEM_SPECULATION = 1 << 11,
+    SUBSYSTEM_SCHEDULER = 1 << 12,
+    SUBSYSTEM_CLIPBOARD_OWNER = 1 << 13,
+    SUBSYSTEM_TEXT_REPLACEMENT = 1 << 14
+};
+static guint started_subsystems = 0;
+
 // Callbacks
 static SelectionCallback selection_callback = NULL;
 static MenuActionCallback menu_action_callback = NULL;
@@ -43,6 +77,64 @@ static gpointer gtk_thread_func(gpointer data) {
     return GINT_TO_POINTER(STATUS_SUCCESS);
 }
 
+// Stop the subsystems that were started, in dependency order, then the
+// GTK thread. Leaves last_error for the caller to report.
+static void stop_subsystems() {
+    guint started = started_subsystems;
+    
+    // Let scheduled jobs and speculative requests finish before D-Bus goes away
+    if (started & SUBSYSTEM_SCHEDULER) cleanup_processing_scheduler();
+    if (started & SUBSYSTEM_SPECULATION) cleanup_speculative_processing();
+    
+    // Cleanup D-Bus
+    if (started & SUBSYSTEM_DBUS) cleanup_dbus_service();
+    if (started & SUBSYSTEM_ADMISSION) cleanup_admission_control();
+    
+    // Drop cached results; the on-disk ones stay for the next start
+    if (started & SUBSYSTEM_RESULT_CACHE) cleanup_result_cache();
+    if (started & SUBSYSTEM_RESULT_STORE) cleanup_result_store();
+    if (started & SUBSYSTEM_TRANSLATION_MEMORY) cleanup_translation_memory();
+    
+    // Release global hotkeys before the menu they open
+    if (started & SUBSYSTEM_HOTKEYS) cleanup_hotkey_registry();
+    
+    // Cleanup context menu system
+    if (started & SUBSYSTEM_CONTEXT_MENU) cleanup_context_menu_system();
+    
+    // Close the action channel after the menu that feeds it
+    if (started & SUBSYSTEM_ACTION_CHANNEL) cleanup_action_channel();
+    
+    // Cleanup text selection monitor
+    if (started & SUBSYSTEM_SELECTION_MONITOR) cleanup_text_selection_monitor();
+    
+    // Cleanup text replacement system
+    if (started & SUBSYSTEM_TEXT_REPLACEMENT) cleanup_text_replacement();
+    
+    // Cleanup clipboard owner
+    if (started & SUBSYSTEM_CLIPBOARD_OWNER) cleanup_clipboard_owner();
+    
+    // Cleanup selection reader
+    if (started & SUBSYSTEM_SELECTION_READER) cleanup_selection_reader();
+    
+    // Stop the X11 reactor once nothing uses it
+    if (started & SUBSYSTEM_X11_REACTOR) cleanup_x11_reactor();
+    
+    started_subsystems = 0;
+    
+    // Stop GTK main loop
+    if (main_loop) {
+        g_main_loop_quit(main_loop);
+        g_main_loop_unref(main_loop);
+        main_loop = NULL;
+    }
+    
+    // Join GTK thread
+    if (gtk_thread) {
+        g_thread_join(gtk_thread);
+        gtk_thread = NULL;
+    }
+}
+
 // Initialize the system hooks
 int init_system_hooks() {
     if (system_initialized) {
@@ -68,33 +160,129 @@ int init_system_hooks() {
     // Give GTK thread time to initialize
     g_usleep(100000); // 100ms
     
+    // Start the shared X11 connection and event thread
+    if (init_x11_reactor() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize X11 reactor");
+        stop_subsystems();
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+    started_subsystems |= SUBSYSTEM_X11_REACTOR;
+    
+    // Initialize in-process selection reader
+    if (init_selection_reader() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize selection reader");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_SELECTION_READER;
+    
     // Initialize text selection monitoring
     if (init_text_selection_monitor() != STATUS_SUCCESS) {
         set_last_error("Failed to initialize text selection monitor");
-        cleanup_system_hooks();
+        stop_subsystems();
         return STATUS_ERROR_INIT;
     }
+    started_subsystems |= SUBSYSTEM_SELECTION_MONITOR;
+    
+    // Open the action channel the menu streams actions through
+    if (init_action_channel() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize action channel");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_ACTION_CHANNEL;
     
     // Initialize context menu system
     if (init_context_menu_system() != STATUS_SUCCESS) {
         set_last_error("Failed to initialize context menu system");
-        cleanup_system_hooks();
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_CONTEXT_MENU;
+    
+    // Initialize global hotkeys with the default menu binding, which
+    // another application may already hold
+    if (init_hotkey_registry() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize global hotkeys");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_HOTKEYS;
+    if (hotkey_registry_add(DEFAULT_MENU_HOTKEY, HOTKEY_ACTION_SHOW_MENU, NULL) <= 0) {
+        printf("⚠️  Default menu hotkey %s unavailable\n", DEFAULT_MENU_HOTKEY);
+    }
+    
+    // Open the on-disk results behind it; without one the cache is memory-only
+    if (init_result_store() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize result store");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_RESULT_STORE;
+    
+    // Initialize the result cache consulted before any D-Bus round trip
+    if (init_result_cache(RESULT_CACHE_DEFAULT_BUDGET) != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize result cache");
+        stop_subsystems();
         return STATUS_ERROR_INIT;
     }
+    started_subsystems |= SUBSYSTEM_RESULT_CACHE;
+    
+    // Initialize the fuzzy index of earlier results
+    if (init_translation_memory(TM_DEFAULT_BUDGET) != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize translation memory");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_TRANSLATION_MEMORY;
+    
+    // Initialize the gate every backend call passes
+    if (init_admission_control() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize admission control");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_ADMISSION;
     
     // Initialize D-Bus service
     if (init_dbus_service() != STATUS_SUCCESS) {
         set_last_error("Failed to initialize D-Bus service");
-        cleanup_system_hooks();
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_DBUS;
+    
+    // Initialize speculative processing on top of D-Bus
+    if (init_speculative_processing() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize speculative processing");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_SPECULATION;
+    
+    // Initialize the workers that run processing jobs by priority
+    if (init_processing_scheduler() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize processing scheduler");
+        stop_subsystems();
         return STATUS_ERROR_INIT;
     }
+    started_subsystems |= SUBSYSTEM_SCHEDULER;
+    
+    // Initialize clipboard owner used for paste-based replacement
+    if (init_clipboard_owner() != STATUS_SUCCESS) {
+        set_last_error("Failed to initialize clipboard owner");
+        stop_subsystems();
+        return STATUS_ERROR_INIT;
+    }
+    started_subsystems |= SUBSYSTEM_CLIPBOARD_OWNER;
     
     // Initialize text replacement system
     if (init_text_replacement() != STATUS_SUCCESS) {
         set_last_error("Failed to initialize text replacement system");
-        cleanup_system_hooks();
+        stop_subsystems();
         return STATUS_ERROR_INIT;
     }
+    started_subsystems |= SUBSYSTEM_TEXT_REPLACEMENT;
     
     system_initialized = TRUE;
     return STATUS_SUCCESS;
@@ -106,30 +294,7 @@ void cleanup_system_hooks() {
         return;
     }
     
-    // Cleanup D-Bus
-    cleanup_dbus_service();
-    
-    // Cleanup context menu system
-    cleanup_context_menu_system();
-    
-    // Cleanup text selection monitor
-    cleanup_text_selection_monitor();
-    
-    // Cleanup text replacement system
-    cleanup_text_replacement();
-    
-    // Stop GTK main loop
-    if (main_loop) {
-        g_main_loop_quit(main_loop);
-        g_main_loop_unref(main_loop);
-        main_loop = NULL;
-    }
-    
-    // Join GTK thread
-    if (gtk_thread) {
-        g_thread_join(gtk_thread);
-        gtk_thread = NULL;
-    }
+    stop_subsystems();
     
     // Cleanup error string
     if (last_error) {
@@ -225,6 +390,233 @@ int set_menu_action_callback(MenuActionCallback callback) {
     return set_context_menu_callback(callback);
 }
 
+// Bind a global hotkey
+int register_hotkey(const char* accelerator, int action, const char* menu_item_id) {
+    if (!system_initialized) {
+        set_last_error("System not initialized");
+        return STATUS_ERROR_INIT;
+    }
+    
+    int result = hotkey_registry_add(accelerator, action, menu_item_id);
+    if (result <= 0) {
+        set_last_error("Failed to register hotkey (invalid, or taken by another application)");
+    }
+    return result;
+}
+
+// Remove a global hotkey
+int unregister_hotkey(int hotkey_id) {
+    if (!system_initialized) {
+        set_last_error("System not initialized");
+        return STATUS_ERROR_INIT;
+    }
+    
+    return hotkey_registry_remove(hotkey_id);
+}
+
+// Remove every global hotkey, including the default one
+int clear_hotkeys() {
+    if (!system_initialized) {
+        set_last_error("System not initialized");
+        return STATUS_ERROR_INIT;
+    }
+    
+    return hotkey_registry_clear();
+}
+
+// Hotkey dispatch latency since the last reset
+int get_hotkey_latency_stats(HotkeyLatencyStats* stats) {
+    return get_context_menu_latency_stats(stats);
+}
+
+// Enable or disable speculative processing
+int set_speculative_processing(int enabled) {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    speculation_set_enabled(enabled);
+    return STATUS_SUCCESS;
+}
+
+// Enable or disable sentence-level processing
+int set_segmented_processing(int enabled) {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    dbus_set_segmentation_enabled(enabled);
+    return STATUS_SUCCESS;
+}
+
+// Ceiling on concurrent backend calls and the queue behind them
+int set_backend_concurrency(int max_concurrency, int max_queue) {
+    if (!system_initialized || max_concurrency < 1 || max_queue < 0) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    admission_set_limits(max_concurrency, max_queue);
+    return STATUS_SUCCESS;
+}
+
+// Rate limit one operation's backend calls, or all by default
+int set_operation_rate_limit(const char* operation, double per_second, int burst) {
+    if (!system_initialized || per_second < 0 || burst < 1) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    admission_set_rate(operation, per_second, burst);
+    return STATUS_SUCCESS;
+}
+
+// Chunk size and parallelism for long selections
+int set_chunked_processing(int chunk_bytes, int max_parallel) {
+    if (!system_initialized || chunk_bytes < 0 || max_parallel < 1) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    chunked_processing_configure(chunk_bytes, max_parallel);
+    return STATUS_SUCCESS;
+}
+
+// Run send_processing_request off the calling thread at a priority
+int schedule_processing(const char* text, const char* operation, int priority,
+                        ProcessingCallback callback, void* user_data) {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    return scheduler_submit(text, operation, priority, callback, user_data);
+}
+
+// Cancel one scheduled job
+int cancel_scheduled_processing(int job_id) {
+    return scheduler_cancel(job_id);
+}
+
+// Cancel all work of one priority class
+int cancel_processing_class(int priority) {
+    if (!system_initialized || priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    scheduler_cancel_class(priority);
+    if (priority == PRIORITY_SPECULATIVE) {
+        speculation_cancel();
+    }
+    return STATUS_SUCCESS;
+}
+
+// Set chunked processing progress callback
+int set_chunk_progress_callback(ChunkProgressCallback callback) {
+    chunked_processing_set_progress_callback(callback);
+    return STATUS_SUCCESS;
+}
+
+// Similarity thresholds for translation memory hints and direct reuse
+int set_translation_memory(double hint_similarity, double serve_similarity) {
+    if (!system_initialized || hint_similarity < 0 || hint_similarity > 1 ||
+        serve_similarity < 0 || serve_similarity > 1) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    translation_memory_set_thresholds(hint_similarity, serve_similarity);
+    return STATUS_SUCCESS;
+}
+
+// Hotkey -> first menu frame, for rebuilt and reused popup windows
+int get_menu_frame_latency_stats(HotkeyLatencyStats* rebuilt, HotkeyLatencyStats* reused) {
+    return get_context_menu_frame_stats(rebuilt, reused);
+}
+
+// Result cache counters
+int get_result_cache_stats(ResultCacheStats* stats) {
+    if (!stats) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    result_cache_get_stats(stats);
+    return STATUS_SUCCESS;
+}
+
+// Backend admission counters
+int get_admission_stats(AdmissionStats* stats) {
+    if (!stats) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    admission_get_stats(stats);
+    return STATUS_SUCCESS;
+}
+
+// Per-class scheduler counters
+int get_scheduler_stats(int priority, SchedulerClassStats* stats) {
+    if (!stats || priority < 0 || priority >= PROCESSING_PRIORITY_COUNT) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    scheduler_get_stats(priority, stats);
+    return STATUS_SUCCESS;
+}
+
+// Change the result cache byte budget
+int set_result_cache_budget(long bytes) {
+    if (!system_initialized || bytes < 0) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    result_cache_set_budget((size_t)bytes);
+    return STATUS_SUCCESS;
+}
+
+// Describe the backend's model so cached results never cross models
+int set_processing_model_config(const char* config) {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    result_cache_set_model_config(config);
+    return STATUS_SUCCESS;
+}
+
+// Forget every cached result
+int clear_result_cache() {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    result_cache_clear();
+    return STATUS_SUCCESS;
+}
+
+// Clear the hotkey dispatch latency statistics
+void reset_hotkey_latency_stats() {
+    reset_context_menu_latency_stats();
+}
+
+// Bind Dart_PostCObject for the calling Dart VM
+int init_dart_api_dl(void* api_dl_data) {
+    return dart_port_bridge_init(api_dl_data);
+}
+
+// Post selection and menu-action events to a Dart port
+int set_dart_event_port(int64_t port) {
+    if (!system_initialized) {
+        return STATUS_ERROR_INIT;
+    }
+    
+    return dart_port_bridge_set_port(port);
+}
+
+// Socket the Flutter side connects to for menu actions
+char* get_action_channel_path() {
+    if (!system_initialized || !action_channel_path()) {
+        return NULL;
+    }
+    
+    return strdup(action_channel_path());
+}
+
 // Check system compatibility
 int is_system_compatible() {
     // Check for X11
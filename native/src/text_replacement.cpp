@@ -1,5 +1,10 @@
 #include "text_replacement.h"
+#include "clipboard_owner.h"
+#include "clipboard_snapshot.h"
+#include "text_selection_monitor.h"
+#include "x11_reactor.h"
 #include <X11/Xlib.h>
+#include <X11/Xatom.h>
 #include <X11/extensions/XTest.h>
 #include <X11/keysym.h>
 #include <gtk/gtk.h>
@@ -8,33 +13,100 @@
 #include <stdio.h>
 #include <unistd.h>
 
-// X11 display for keyboard simulation
+// Reactor connection used for keyboard simulation (reactor thread only)
 static Display* display = NULL;
+static Atom clipboard_atom;
+static Atom targets_atom;
 
-// Initialize text replacement system
-int init_text_replacement() {
-    display = XOpenDisplay(NULL);
-    if (!display) {
-        return STATUS_ERROR_NO_DISPLAY;
-    }
+// Clipboard snapshot started by prepare_text_replacement(), with the
+// CLIPBOARD owner it was taken from and the owner changes seen by then
+static GMutex prepared_lock;
+static ClipboardSnapshot* prepared_clipboard = NULL;
+static Window prepared_owner = None;
+static int prepared_generation = 0;
+
+// One synthetic key chord, sent from the reactor thread
+typedef struct {
+    unsigned int modifiers;
+    KeySym key;
+} KeyComboRequest;
+
+// Pointer click, sent from the reactor thread
+typedef struct {
+    int x;
+    int y;
+} ClickRequest;
+
+static void setup_replacement_task(Display* task_display, void* user_data) {
+    int* status = (int*)user_data;
     
     // Check if XTest extension is available
     int event_base, error_base, major_version, minor_version;
-    if (!XTestQueryExtension(display, &event_base, &error_base, &major_version, &minor_version)) {
-        XCloseDisplay(display);
-        display = NULL;
-        return STATUS_ERROR_INIT;
+    if (!XTestQueryExtension(task_display, &event_base, &error_base, &major_version, &minor_version)) {
+        *status = STATUS_ERROR_INIT;
+        return;
     }
     
-    return STATUS_SUCCESS;
+    display = task_display;
+    clipboard_atom = XInternAtom(display, "CLIPBOARD", False);
+    targets_atom = XInternAtom(display, "TARGETS", False);
+    *status = STATUS_SUCCESS;
+}
+
+// Initialize text replacement system
+int init_text_replacement() {
+    int status = STATUS_ERROR_NO_DISPLAY;
+    int call_status = x11_reactor_call(setup_replacement_task, &status);
+    return call_status == STATUS_SUCCESS ? status : call_status;
 }
 
 // Cleanup text replacement system
 void cleanup_text_replacement() {
-    if (display) {
-        XCloseDisplay(display);
-        display = NULL;
+    g_mutex_lock(&prepared_lock);
+    clipboard_snapshot_unref(prepared_clipboard);
+    prepared_clipboard = NULL;
+    g_mutex_unlock(&prepared_lock);
+
+    display = NULL;
+}
+
+static void clipboard_owner_task(Display* task_display, void* user_data) {
+    *(Window*)user_data = XGetSelectionOwner(task_display, clipboard_atom);
+}
+
+static Window get_clipboard_owner() {
+    Window owner = None;
+    x11_reactor_call(clipboard_owner_task, &owner);
+    return owner;
+}
+
+// Snapshot of what the clipboard holds for the user. While we own it,
+// reuse what an earlier replacement saved instead of capturing ourselves.
+static ClipboardSnapshot* snapshot_original_clipboard() {
+    int serving;
+    ClipboardSnapshot* snapshot = clipboard_owner_ref_original(&serving);
+    if (!serving) {
+        snapshot = clipboard_snapshot_capture_async(clipboard_atom, targets_atom);
+    }
+    return snapshot;
+}
+
+// Start capturing the clipboard while the replacement text is computed
+void prepare_text_replacement() {
+    if (!display) {
+        return;
     }
+
+    int generation = get_clipboard_generation();
+    Window owner = get_clipboard_owner();
+    ClipboardSnapshot* snapshot = owner != None ? snapshot_original_clipboard() : NULL;
+
+    g_mutex_lock(&prepared_lock);
+    clipboard_snapshot_unref(prepared_clipboard);
+    prepared_clipboard = snapshot;
+    prepared_owner = owner;
+    prepared_generation = generation;
+    g_mutex_unlock(&prepared_lock);
 }
 
 // Send key combination
@@ -70,6 +142,17 @@ static void send_key_combo(unsigned int modifiers, KeySym key) {
     XFlush(display);
 }
 
+static void key_combo_task(Display* task_display, void* user_data) {
+    KeyComboRequest* request = (KeyComboRequest*)user_data;
+    send_key_combo(request->modifiers, request->key);
+}
+
+// Send a key chord through the reactor
+static void post_key_combo(unsigned int modifiers, KeySym key) {
+    KeyComboRequest request = { modifiers, key };
+    x11_reactor_call(key_combo_task, &request);
+}
+
 // Type text using keyboard simulation
 static void type_text(const char* text) {
     if (!text || !display) return;
@@ -128,28 +211,12 @@ static void type_text(const char* text) {
         }
         
         if (keysym != 0) {
-            KeyCode keycode = XKeysymToKeycode(display, keysym);
-            
-            // Press modifier keys
-            if (modifiers & ShiftMask) {
-                XTestFakeKeyEvent(display, XKeysymToKeycode(display, XK_Shift_L), True, 0);
-            }
-            
-            // Press and release main key
-            XTestFakeKeyEvent(display, keycode, True, 0);
-            XTestFakeKeyEvent(display, keycode, False, 0);
-            
-            // Release modifier keys
-            if (modifiers & ShiftMask) {
-                XTestFakeKeyEvent(display, XKeysymToKeycode(display, XK_Shift_L), False, 0);
-            }
+            post_key_combo(modifiers, keysym);
             
-            // Small delay between keystrokes
+            // Small delay between keystrokes, taken off the reactor thread
             usleep(10000); // 10ms
         }
     }
-    
-    XFlush(display);
 }
 
 // Replace selected text with new text
@@ -170,49 +237,56 @@ int replace_text_via_clipboard(const char* new_text) {
         return STATUS_ERROR_INIT;
     }
     
-    // Store current clipboard content
-    char* original_clipboard = NULL;
-    FILE* pipe = popen("xclip -selection clipboard -o 2>/dev/null", "r");
-    if (pipe) {
-        char buffer[4096];
-        size_t read_size = fread(buffer, 1, sizeof(buffer) - 1, pipe);
-        if (read_size > 0) {
-            buffer[read_size] = '\0';
-            original_clipboard = strdup(buffer);
-        }
-        pclose(pipe);
+    // Use the prepared snapshot unless the clipboard changed since. An
+    // application copying again keeps its owner window, but XFixes still
+    // counts the new ownership.
+    g_mutex_lock(&prepared_lock);
+    ClipboardSnapshot* original_clipboard = prepared_clipboard;
+    Window original_owner = prepared_owner;
+    int original_generation = prepared_generation;
+    prepared_clipboard = NULL;
+    g_mutex_unlock(&prepared_lock);
+
+    if (original_clipboard && (get_clipboard_owner() != original_owner ||
+                               get_clipboard_generation() != original_generation)) {
+        clipboard_snapshot_unref(original_clipboard);
+        original_clipboard = NULL;
+    }
+    if (!original_clipboard) {
+        original_clipboard = snapshot_original_clipboard();
     }
     
-    // Set new text to clipboard
-    FILE* clip_pipe = popen("xclip -selection clipboard", "w");
-    if (!clip_pipe) {
-        if (original_clipboard) free(original_clipboard);
-        return STATUS_ERROR_INIT;
+    // The original owner stops answering once we take over, so the
+    // capture has to finish first
+    if (original_clipboard && clipboard_snapshot_wait(original_clipboard) == 0) {
+        clipboard_snapshot_unref(original_clipboard);
+        original_clipboard = NULL;
     }
     
-    fwrite(new_text, 1, strlen(new_text), clip_pipe);
-    pclose(clip_pipe);
+    // Serve the new text ourselves; the original comes back once the
+    // target application has fetched the new text for the paste
+    int status = clipboard_owner_set_text(new_text, original_clipboard);
+    clipboard_snapshot_unref(original_clipboard);
+    if (status != STATUS_SUCCESS) {
+        return status;
+    }
     
     // Just paste over the current selection (don't select all!)
     // The selected text will be automatically replaced by the paste
-    send_key_combo(ControlMask, XK_v);  // Paste
-    
-    // Give some time for the paste to complete
-    usleep(100000); // 100ms
-    
-    // Restore original clipboard content
-    if (original_clipboard) {
-        FILE* restore_pipe = popen("xclip -selection clipboard", "w");
-        if (restore_pipe) {
-            fwrite(original_clipboard, 1, strlen(original_clipboard), restore_pipe);
-            pclose(restore_pipe);
-        }
-        free(original_clipboard);
-    }
+    post_key_combo(ControlMask, XK_v);  // Paste
+    clipboard_owner_arm_restore();
     
     return STATUS_SUCCESS;
 }
 
+static void click_task(Display* task_display, void* user_data) {
+    ClickRequest* request = (ClickRequest*)user_data;
+    XTestFakeMotionEvent(display, -1, request->x, request->y, 0);
+    XTestFakeButtonEvent(display, 1, True, 0);   // Left mouse down
+    XTestFakeButtonEvent(display, 1, False, 0);  // Left mouse up
+    XFlush(display);
+}
+
 // Click at coordinates and replace text
 int replace_text_at_coordinates(const char* new_text, int x, int y) {
     if (!new_text || !display) {
@@ -220,10 +294,8 @@ int replace_text_at_coordinates(const char* new_text, int x, int y) {
     }
     
     // Move mouse to coordinates and click
-    XTestFakeMotionEvent(display, -1, x, y, 0);
-    XTestFakeButtonEvent(display, 1, True, 0);   // Left mouse down
-    XTestFakeButtonEvent(display, 1, False, 0);  // Left mouse up
-    XFlush(display);
+    ClickRequest request = { x, y };
+    x11_reactor_call(click_task, &request);
     
     // Give time for the click to register
     usleep(100000); // 100ms
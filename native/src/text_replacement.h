@@ -16,6 +16,10 @@ void cleanup_text_replacement();
 // Replace selected text with new text (advanced keyboard simulation)
 int replace_selected_text_advanced(const char* new_text);
 
+// Start snapshotting the clipboard in the background so a later
+// replace_text_via_clipboard() does not wait for all of it
+void prepare_text_replacement();
+
 // Replace text using clipboard method
 int replace_text_via_clipboard(const char* new_text);
 
@@ -0,0 +1,183 @@
+#include "text_segmenter.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+
+// Periods after these (case-insensitive) rarely end a sentence
+static const char* const abbreviations[] = {
+    "mr", "mrs", "ms", "dr", "prof", "sr", "jr", "st", "vs",
+    "e.g", "i.e", "cf", "no", "fig", "approx", NULL
+};
+
+static gboolean is_space(gunichar c) {
+    return g_unichar_isspace(c);
+}
+
+static gboolean is_terminal(gunichar c) {
+    switch (c) {
+        case '.': case '!': case '?':
+        case 0x2026:                        // …
+        case 0x3002: case 0xFF61:           // 。｡
+        case 0xFF01: case 0xFF1F: case 0xFF0E:  // ！？．
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+// Ends a sentence without needing a space after it
+static gboolean is_full_width_terminal(gunichar c) {
+    return c == 0x3002 || c == 0xFF61 || c == 0xFF01 || c == 0xFF1F || c == 0xFF0E;
+}
+
+// Closing quotes and brackets that belong to the sentence before them
+static gboolean is_closer(gunichar c) {
+    switch (c) {
+        case '"': case '\'': case ')': case ']':
+        case 0x2019: case 0x201D: case 0x00BB:  // ’ ” »
+        case 0x300D: case 0x300F: case 0xFF09:  // 」 』 ）
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+static const char* skip_spaces(const char* p) {
+    while (*p && is_space(g_utf8_get_char(p))) {
+        p = g_utf8_next_char(p);
+    }
+    return p;
+}
+
+// `p` is just past a '\n': does an empty line follow?
+static gboolean blank_line_follows(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+    return *p == '\n';
+}
+
+// The period at `dot` belongs to an initial or an abbreviation
+static gboolean is_abbreviation(const char* start, const char* dot) {
+    const char* word = dot;
+    while (word > start && !g_ascii_isspace(word[-1]) && word[-1] != '(' && word[-1] != '"') {
+        word--;
+    }
+
+    size_t length = dot - word;
+    if (length == 1 && g_ascii_isupper(word[0])) {
+        return TRUE;  // "J. Smith"
+    }
+    for (int i = 0; abbreviations[i]; i++) {
+        if (strlen(abbreviations[i]) == length && g_ascii_strncasecmp(word, abbreviations[i], length) == 0) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Terminal `c` at `p`, with trailing terminals and closers up to `after`:
+// is this a sentence end?
+static gboolean ends_sentence(const char* start, const char* p, gunichar c, const char* after) {
+    if (is_full_width_terminal(c) || !*after) {
+        return TRUE;
+    }
+    if (!is_space(g_utf8_get_char(after))) {
+        return FALSE;  // "3.14", "example.com"
+    }
+
+    const char* next_word = skip_spaces(after);
+    if (!*next_word) {
+        return TRUE;
+    }
+    if (g_unichar_islower(g_utf8_get_char(next_word))) {
+        return FALSE;
+    }
+    return c != '.' || after != g_utf8_next_char(p) || !is_abbreviation(start, p);
+}
+
+static void push_span(GArray* spans, const char* text, const char* start, const char* end,
+                      const char* resume) {
+    TextSpan span;
+    span.start = start - text;
+    span.length = end - start;
+    span.gap = resume - end;
+    g_array_append_val(spans, span);
+}
+
+int segment_text(const char* text, TextSpan** spans, int* count) {
+    if (!text || !spans || !count) {
+        return STATUS_ERROR_INIT;
+    }
+
+    GArray* found = g_array_new(FALSE, FALSE, sizeof(TextSpan));
+    const char* start = skip_spaces(text);
+
+    if (!g_utf8_validate(text, -1, NULL)) {
+        // Not ours to cut up; trim it and pass it through whole
+        const char* end = start + strlen(start);
+        while (end > start && g_ascii_isspace(end[-1])) end--;
+        if (end > start) {
+            push_span(found, text, start, end, start + strlen(start));
+        }
+        start = "";
+    }
+
+    const char* p = start;
+    const char* content_end = start;  // Just past the last non-space
+    while (*p) {
+        gunichar c = g_utf8_get_char(p);
+        const char* next = g_utf8_next_char(p);
+        gboolean cut = FALSE;
+
+        if (c == 0x2029 || (c == '\n' && blank_line_follows(next))) {
+            cut = TRUE;
+        } else if (is_terminal(c)) {
+            const char* after = next;
+            while (*after && (is_terminal(g_utf8_get_char(after)) || is_closer(g_utf8_get_char(after)))) {
+                after = g_utf8_next_char(after);
+            }
+            content_end = after;
+            cut = ends_sentence(start, p, c, after);
+            next = after;
+        } else if (!is_space(c)) {
+            content_end = next;
+        }
+
+        if (cut) {
+            const char* resume = skip_spaces(content_end);
+            push_span(found, text, start, content_end, resume);
+            start = p = content_end = resume;
+        } else {
+            p = next;
+        }
+    }
+    if (content_end > start) {
+        push_span(found, text, start, content_end, p);
+    }
+
+    *count = (int)found->len;
+    *spans = (TextSpan*)malloc(sizeof(TextSpan) * (found->len + 1));
+    if (found->len > 0) {
+        memcpy(*spans, found->data, sizeof(TextSpan) * found->len);
+    }
+    g_array_free(found, TRUE);
+    return STATUS_SUCCESS;
+}
+
+// Append `part` without the whitespace at its ends
+static void append_trimmed(GString* out, const char* part) {
+    const char* end = part + strlen(part);
+    while (*part && g_ascii_isspace(*part)) part++;
+    while (end > part && g_ascii_isspace(end[-1])) end--;
+    g_string_append_len(out, part, end - part);
+}
+
+char* join_segments(const char* text, const TextSpan* spans, int count, char* const* parts) {
+    GString* joined = g_string_new_len(text, count > 0 ? spans[0].start : strlen(text));
+    for (int i = 0; i < count; i++) {
+        append_trimmed(joined, parts[i]);
+        g_string_append_len(joined, text + spans[i].start + spans[i].length, spans[i].gap);
+    }
+    char* result = strdup(joined->str);
+    g_string_free(joined, TRUE);
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef TEXT_SEGMENTER_H
+#define TEXT_SEGMENTER_H
+
+#include "../include/instant_translator.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One sentence of a selection, as byte offsets into the original text.
+// The whitespace around segments is not part of any of them, so
+// text[0 .. spans[0].start) + each (segment, gap) pair rebuilds the input.
+typedef struct {
+    size_t start;
+    size_t length;      // Trimmed: starts and ends on non-whitespace
+    size_t gap;         // Whitespace following it, kept verbatim
+} TextSpan;
+
+// Split UTF-8 text at sentence ends (. ! ? … and their full-width forms,
+// plus trailing closing quotes/brackets) and paragraph breaks (a blank
+// line or U+2029). A period before a lowercase word, after an initial or
+// after a common abbreviation doesn't end a sentence. Invalid UTF-8 comes
+// back as one segment. Free `*spans` with free().
+int segment_text(const char* text, TextSpan** spans, int* count);
+
+// Rebuild `text` with parts[i] in place of spans[i]. Whitespace at the ends
+// of each part is dropped in favour of the original gaps. Free with free().
+char* join_segments(const char* text, const TextSpan* spans, int count, char* const* parts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_SEGMENTER_H
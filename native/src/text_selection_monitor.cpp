@@ -1,4 +1,7 @@
 #include "text_selection_monitor.h"
+#include "selection_reader.h"
+#include "text_replacement.h"
+#include "x11_reactor.h"
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 #include <gtk/gtk.h>
@@ -8,8 +11,11 @@
 #include <cstdlib>
 #include <stdio.h>
 #include <unistd.h>
+#ifdef HAVE_XFIXES
+#include <X11/extensions/Xfixes.h>
+#endif
 
-// X11 display and atoms
+// Reactor connection (reactor thread only) and atoms
 static Display* display = NULL;
 static Window root_window;
 static Atom clipboard_atom;
@@ -20,13 +26,40 @@ static Atom targets_atom;
 // Selection monitoring
 static SelectionCallback selection_callback = NULL;
 static char* last_selection = NULL;
-static GThread* monitor_thread = NULL;
 static gboolean monitoring = FALSE;
 
+// How selection changes are detected
+typedef enum {
+    SELECTION_MONITOR_XFIXES,   // Woken by XFixes selection owner notifications
+    SELECTION_MONITOR_POLL      // Fallback: read PRIMARY every 100ms
+} SelectionMonitorMode;
+
+static SelectionMonitorMode monitor_mode = SELECTION_MONITOR_POLL;
+
+// Reactor state: XFixes event base and pending timers
+static int xfixes_event_base = 0;
+static unsigned int settle_timer = 0;
+static unsigned int poll_timer = 0;
+static volatile gint clipboard_generation = 0;
+
+// Polling interval of the fallback mode
+#define SELECTION_POLL_MS 100
+
+// Values the hotkey path serves without a round trip (reactor thread only)
+static char* cached_primary = NULL;
+static gboolean cached_primary_valid = FALSE;
+static char* active_app_name = NULL;
+static double fallback_scale = 1.0;
+static Atom active_window_atom;
+
+// Quiet period after the last owner change before the selection is read.
+// Toolkits re-assert ownership while a drag selection grows, so this reads
+// once when the user stops instead of on every intermediate notification.
+#define SELECTION_SETTLE_MS 30
+
 // Get active window information
 static Window get_active_window() {
     Window active_window = 0;
-    Atom active_window_atom = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
     
     Atom actual_type;
     int actual_format;
@@ -60,212 +93,245 @@ static char* get_window_class(Window window) {
     return strdup("unknown");
 }
 
-// Get selection text using xclip (more reliable than X11 selection API)
-static char* get_selection_via_xclip() {
-    FILE* pipe = popen("xclip -selection primary -o 2>/dev/null", "r");
-    if (!pipe) {
+// Read PRIMARY in-process through the selection reader
+static char* get_primary_selection() {
+    char* result = read_selection_text(primary_atom, utf8_string_atom, targets_atom);
+    if (!result) {
         return NULL;
     }
     
-    char buffer[4096];
-    char* result = NULL;
-    size_t total_size = 0;
-    size_t read_size;
-    
-    while ((read_size = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
-        result = (char*)realloc(result, total_size + read_size + 1);
-        if (!result) {
-            pclose(pipe);
-            return NULL;
-        }
-        memcpy(result + total_size, buffer, read_size);
-        total_size += read_size;
+    // Remove trailing newlines
+    size_t total_size = strlen(result);
+    while (total_size > 0 && (result[total_size - 1] == '\n' || result[total_size - 1] == '\r')) {
+        result[--total_size] = '\0';
     }
     
-    pclose(pipe);
-    
-    if (result) {
-        result[total_size] = '\0';
-        
-        // Remove trailing newlines
-        while (total_size > 0 && (result[total_size - 1] == '\n' || result[total_size - 1] == '\r')) {
-            result[--total_size] = '\0';
-        }
-        
-        // Return NULL if empty
-        if (total_size == 0) {
-            free(result);
-            return NULL;
-        }
+    // Return NULL if empty
+    if (total_size == 0) {
+        free(result);
+        return NULL;
     }
     
     return result;
 }
 
-// Get current mouse position with proper scaling support
-static void get_mouse_position(int* x, int* y) {
-    printf("🔍 get_mouse_position() called - detecting scaling...\n");
-    
-    // Get raw X11 coordinates first
-    Window root_return, child_return;
-    int root_x, root_y, win_x, win_y;
-    unsigned int mask_return;
+// Scale implied by GDK_SCALE, QT_SCALE_FACTOR or Xft.dpi. These only change
+// with a new session, so they are read once instead of on every selection.
+static double detect_fallback_scale() {
+    // Check if GDK_SCALE environment variable is set
+    const char* gdk_scale = getenv("GDK_SCALE");
+    if (gdk_scale && atof(gdk_scale) > 1.0) {
+        printf("🔧 Using GDK_SCALE %.2f\n", atof(gdk_scale));
+        return atof(gdk_scale);
+    }
     
-    if (!XQueryPointer(display, root_window, &root_return, &child_return,
-                      &root_x, &root_y, &win_x, &win_y, &mask_return)) {
-        *x = 0;
-        *y = 0;
-        printf("❌ Failed to get mouse position\n");
-        return;
+    // Check QT_SCALE_FACTOR for Qt applications
+    const char* qt_scale = getenv("QT_SCALE_FACTOR");
+    if (qt_scale && atof(qt_scale) > 1.0) {
+        printf("🔧 Using QT_SCALE_FACTOR %.2f\n", atof(qt_scale));
+        return atof(qt_scale);
     }
     
-    printf("📍 Raw X11 coordinates: (%d, %d)\n", root_x, root_y);
+    // Xft.dpi from the resource database the server already sent us,
+    // rather than running xrdb
+    const char* resources = XResourceManagerString(display);
+    const char* dpi_entry = resources ? strstr(resources, "Xft.dpi:") : NULL;
+    if (dpi_entry) {
+        int dpi = atoi(dpi_entry + strlen("Xft.dpi:"));
+        printf("📊 Detected DPI: %d\n", dpi);
+        if (dpi > 96) {
+            return (double)dpi / 96.0;
+        }
+    }
     
+    return 1.0;
+}
+
+// Convert raw X11 root coordinates to GTK logical coordinates
+static void scale_root_position(int root_x, int root_y, int* x, int* y) {
     // Check for display scaling and adjust coordinates accordingly
     GdkDisplay* gdk_display = gdk_display_get_default();
     if (gdk_display) {
-        printf("✅ GDK display found, checking scaling...\n");
-        
         // Get the monitor at the cursor position
         GdkMonitor* monitor = gdk_display_get_monitor_at_point(gdk_display, root_x, root_y);
         if (monitor) {
             int scale_factor = gdk_monitor_get_scale_factor(monitor);
-            printf("🔍 Monitor scale factor: %d at position (%d, %d)\n", scale_factor, root_x, root_y);
-            
             if (scale_factor > 1) {
                 // For integer scaling (2x, 3x, etc.), divide by scale factor
                 *x = root_x / scale_factor;
                 *y = root_y / scale_factor;
-                printf("🔧 Integer scaling: (%d, %d) -> (%d, %d) (÷%d)\n", 
-                       root_x, root_y, *x, *y, scale_factor);
-                return;
-            }
-        } else {
-            printf("⚠️  Could not get monitor at cursor position\n");
-        }
-        
-        // Try to detect fractional scaling (125%, 150%, etc.)
-        // Check if GDK_SCALE environment variable is set
-        const char* gdk_scale = getenv("GDK_SCALE");
-        if (gdk_scale) {
-            double scale = atof(gdk_scale);
-            if (scale > 1.0) {
-                *x = (int)(root_x / scale);
-                *y = (int)(root_y / scale);
-                printf("🔧 GDK_SCALE: (%d, %d) -> (%d, %d) (÷%.2f)\n", 
-                       root_x, root_y, *x, *y, scale);
-                return;
-            }
-        }
-        
-        // Check QT_SCALE_FACTOR for Qt applications
-        const char* qt_scale = getenv("QT_SCALE_FACTOR");
-        if (qt_scale) {
-            double scale = atof(qt_scale);
-            if (scale > 1.0) {
-                *x = (int)(root_x / scale);
-                *y = (int)(root_y / scale);
-                printf("🔧 QT_SCALE: (%d, %d) -> (%d, %d) (÷%.2f)\n", 
-                       root_x, root_y, *x, *y, scale);
                 return;
             }
         }
-        
-        printf("🔍 Checking DPI settings...\n");
-        // Try to detect scaling from Xft.dpi
-        char* xrdb_output = NULL;
-        FILE* pipe = popen("xrdb -query | grep dpi", "r");
-        if (pipe) {
-            char buffer[256];
-            if (fgets(buffer, sizeof(buffer), pipe)) {
-                xrdb_output = strdup(buffer);
-                printf("📊 DPI query result: %s", xrdb_output);
-            }
-            pclose(pipe);
-        }
-        
-        if (xrdb_output) {
-            // Parse "Xft.dpi: 120" format
-            char* dpi_str = strstr(xrdb_output, ":");
-            if (dpi_str) {
-                int dpi = atoi(dpi_str + 1);
-                printf("📊 Detected DPI: %d\n", dpi);
-                if (dpi > 96) {
-                    double scale = (double)dpi / 96.0;
-                    *x = (int)(root_x / scale);
-                    *y = (int)(root_y / scale);
-                    printf("🔧 DPI scaling: (%d, %d) -> (%d, %d) (DPI: %d, ÷%.2f)\n", 
-                           root_x, root_y, *x, *y, dpi, scale);
-                    free(xrdb_output);
-                    return;
-                }
-            }
-            free(xrdb_output);
-        }
-    } else {
-        printf("❌ No GDK display found\n");
+    }
+    
+    // Fractional scaling (125%, 150%, etc.)
+    if (fallback_scale > 1.0) {
+        *x = (int)(root_x / fallback_scale);
+        *y = (int)(root_y / fallback_scale);
+        return;
     }
     
     // No scaling detected, use raw coordinates
     *x = root_x;
     *y = root_y;
-    printf("⚠️  No scaling detected, using raw X11: (%d, %d)\n", *x, *y);
 }
 
-// Selection monitoring thread
-static gpointer selection_monitor_thread(gpointer data) {
-    while (monitoring) {
-        char* current_selection = get_selection_via_xclip();
+// Get current mouse position with proper scaling support
+static void get_mouse_position(int* x, int* y) {
+    Window root_return, child_return;
+    int root_x, root_y, win_x, win_y;
+    unsigned int mask_return;
+    
+    if (!XQueryPointer(display, root_window, &root_return, &child_return,
+                      &root_x, &root_y, &win_x, &win_y, &mask_return)) {
+        *x = 0;
+        *y = 0;
+        printf("❌ Failed to get mouse position\n");
+        return;
+    }
+    
+    scale_root_position(root_x, root_y, x, y);
+}
+
+// Refresh the cached application name after the active window changed
+static void refresh_active_app() {
+    char* app_name = get_window_class(get_active_window());
+    if (active_app_name) {
+        free(active_app_name);
+    }
+    active_app_name = app_name;
+}
+
+// Pointer position and application name for a selection (reactor thread)
+static void fill_selection_context_task(Display* task_display, void* user_data) {
+    SelectionData* data = (SelectionData*)user_data;
+    
+    // Get mouse position
+    get_mouse_position(&data->x, &data->y);
+    
+    // Application name, kept current by the active window handler
+    data->app_name = strdup(active_app_name ? active_app_name : "unknown");
+}
+
+// Report a changed selection to the registered callback
+static void handle_selection_text(char* current_selection) {
+    // Check if selection changed
+    if (current_selection && 
+        (!last_selection || strcmp(current_selection, last_selection) != 0)) {
+        
+        // Update last selection
+        if (last_selection) {
+            free(last_selection);
+        }
+        last_selection = strdup(current_selection);
         
-        // Check if selection changed
-        if (current_selection && 
-            (!last_selection || strcmp(current_selection, last_selection) != 0)) {
+        // Create selection data
+        if (selection_callback && strlen(current_selection) > 0) {
+            SelectionData* data = (SelectionData*)malloc(sizeof(SelectionData));
+            data->text = strdup(current_selection);
+            data->length = strlen(current_selection);
             
-            // Update last selection
-            if (last_selection) {
-                free(last_selection);
-            }
-            last_selection = strdup(current_selection);
+            fill_selection_context_task(display, data);
             
-            // Create selection data
-            if (selection_callback && strlen(current_selection) > 0) {
-                SelectionData* data = (SelectionData*)malloc(sizeof(SelectionData));
-                data->text = strdup(current_selection);
-                data->length = strlen(current_selection);
-                
-                // Get mouse position
-                get_mouse_position(&data->x, &data->y);
-                
-                // Get active window application name
-                Window active_window = get_active_window();
-                data->app_name = get_window_class(active_window);
-                
-                // Call callback
-                selection_callback(data);
-                
-                // Note: Don't free data here - it's caller's responsibility
-            }
+            // Call callback
+            selection_callback(data);
+            
+            // Note: Don't free data here - it's caller's responsibility
         }
+    }
+}
+
+// Read PRIMARY and report it if it changed (reactor thread)
+static void check_primary_selection() {
+    char* current_selection = get_primary_selection();
+    
+    if (cached_primary) {
+        free(cached_primary);
+    }
+    cached_primary = current_selection ? strdup(current_selection) : NULL;
+    cached_primary_valid = TRUE;
+    handle_selection_text(current_selection);
+    if (current_selection) {
+        free(current_selection);
+    }
+}
+
+// Polling fallback used when XFixes is unavailable
+static void poll_timer_task(Display* task_display, void* user_data) {
+    poll_timer = 0;
+    if (!monitoring) return;
+    
+    check_primary_selection();
+    
+    // Check every 100ms
+    poll_timer = x11_reactor_add_timeout(SELECTION_POLL_MS, poll_timer_task, NULL);
+}
+
+static void settle_timer_task(Display* task_display, void* user_data) {
+    settle_timer = 0;
+    if (monitoring) {
+        check_primary_selection();
+    }
+}
+
+#ifdef HAVE_XFIXES
+// Reactor handler: react when the PRIMARY or CLIPBOARD owner changes
+static int xfixes_event_handler(XEvent* event, void* user_data) {
+    if (event->type != xfixes_event_base + XFixesSelectionNotify) {
+        return 0;
+    }
+    
+    XFixesSelectionNotifyEvent* notify = (XFixesSelectionNotifyEvent*)event;
+    if (notify->selection == primary_atom) {
+        cached_primary_valid = FALSE;
         
-        if (current_selection) {
-            free(current_selection);
+        // Restart the quiet period on every notification
+        if (settle_timer) {
+            x11_reactor_remove_timeout(settle_timer);
         }
-        
-        // Check every 100ms
-        g_usleep(100000);
+        settle_timer = x11_reactor_add_timeout(SELECTION_SETTLE_MS, settle_timer_task, NULL);
+    } else if (notify->selection == clipboard_atom) {
+        g_atomic_int_inc(&clipboard_generation);
     }
-    
-    return NULL;
+    return 1;
 }
+#endif
 
-// Initialize text selection monitoring
-int init_text_selection_monitor() {
-    // Open X11 display
-    display = XOpenDisplay(NULL);
-    if (!display) {
-        return STATUS_ERROR_NO_DISPLAY;
+// Reactor handler: keep the active application name current
+static int active_window_handler(XEvent* event, void* user_data) {
+    if (event->type != PropertyNotify || event->xproperty.window != root_window ||
+        event->xproperty.atom != active_window_atom) {
+        return 0;
     }
+    refresh_active_app();
+    return 1;
+}
+
+#ifdef HAVE_XFIXES
+// Subscribe to owner changes; returns FALSE if the server lacks XFixes
+static gboolean setup_xfixes_monitoring() {
+    int error_base;
+    int major = 2, minor = 0;
+    if (!XFixesQueryExtension(display, &xfixes_event_base, &error_base) ||
+        !XFixesQueryVersion(display, &major, &minor) || major < 1) {
+        return FALSE;
+    }
+    
+    unsigned long mask = XFixesSetSelectionOwnerNotifyMask |
+                         XFixesSelectionWindowDestroyNotifyMask |
+                         XFixesSelectionClientCloseNotifyMask;
+    XFixesSelectSelectionInput(display, root_window, primary_atom, mask);
+    XFixesSelectSelectionInput(display, root_window, clipboard_atom, mask);
+    x11_reactor_add_handler(xfixes_event_handler, NULL);
     
+    printf("✅ Selection monitor using XFixes %d.%d owner notifications\n", major, minor);
+    return TRUE;
+}
+#endif
+
+static void start_monitor_task(Display* task_display, void* user_data) {
+    display = task_display;
     root_window = DefaultRootWindow(display);
     
     // Initialize atoms
@@ -273,28 +339,69 @@ int init_text_selection_monitor() {
     primary_atom = XA_PRIMARY;
     utf8_string_atom = XInternAtom(display, "UTF8_STRING", False);
     targets_atom = XInternAtom(display, "TARGETS", False);
+    active_window_atom = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
+    
+    // Track the active window so the hotkey path never queries it
+    fallback_scale = detect_fallback_scale();
+    XWindowAttributes root_attrs;
+    XGetWindowAttributes(display, root_window, &root_attrs);
+    XSelectInput(display, root_window, root_attrs.your_event_mask | PropertyChangeMask);
+    x11_reactor_add_handler(active_window_handler, NULL);
+    refresh_active_app();
+    
+    // Prefer owner-change notifications, keep polling as the fallback
+    monitor_mode = SELECTION_MONITOR_POLL;
+#ifdef HAVE_XFIXES
+    if (setup_xfixes_monitoring()) {
+        monitor_mode = SELECTION_MONITOR_XFIXES;
+    }
+#endif
+    if (monitor_mode == SELECTION_MONITOR_POLL) {
+        printf("⚠️  XFixes unavailable - falling back to 100ms selection polling\n");
+    }
     
-    // Start monitoring thread
     monitoring = TRUE;
-    monitor_thread = g_thread_new("selection-monitor", selection_monitor_thread, NULL);
     
-    if (!monitor_thread) {
-        cleanup_text_selection_monitor();
-        return STATUS_ERROR_INIT;
+    // Pick up whatever is selected right now
+    if (monitor_mode == SELECTION_MONITOR_XFIXES) {
+        settle_timer = x11_reactor_add_timeout(0, settle_timer_task, NULL);
+    } else {
+        poll_timer = x11_reactor_add_timeout(0, poll_timer_task, NULL);
     }
+}
+
+static void stop_monitor_task(Display* task_display, void* user_data) {
+    monitoring = FALSE;
+    x11_reactor_remove_handler(active_window_handler, NULL);
     
-    return STATUS_SUCCESS;
+#ifdef HAVE_XFIXES
+    if (monitor_mode == SELECTION_MONITOR_XFIXES) {
+        x11_reactor_remove_handler(xfixes_event_handler, NULL);
+        XFixesSelectSelectionInput(display, root_window, primary_atom, 0);
+        XFixesSelectSelectionInput(display, root_window, clipboard_atom, 0);
+    }
+#endif
+    if (settle_timer) {
+        x11_reactor_remove_timeout(settle_timer);
+        settle_timer = 0;
+    }
+    if (poll_timer) {
+        x11_reactor_remove_timeout(poll_timer);
+        poll_timer = 0;
+    }
+}
+
+// Initialize text selection monitoring
+int init_text_selection_monitor() {
+    return x11_reactor_call(start_monitor_task, NULL);
 }
 
 // Cleanup text selection monitoring
 void cleanup_text_selection_monitor() {
-    // Stop monitoring
-    monitoring = FALSE;
-    
-    // Join monitor thread
-    if (monitor_thread) {
-        g_thread_join(monitor_thread);
-        monitor_thread = NULL;
+    // Stop timers and notifications on the reactor thread
+    if (display) {
+        x11_reactor_call(stop_monitor_task, NULL);
+        display = NULL;
     }
     
     // Cleanup last selection
@@ -302,17 +409,20 @@ void cleanup_text_selection_monitor() {
         free(last_selection);
         last_selection = NULL;
     }
-    
-    // Close X11 display
-    if (display) {
-        XCloseDisplay(display);
-        display = NULL;
+    if (cached_primary) {
+        free(cached_primary);
+        cached_primary = NULL;
+    }
+    cached_primary_valid = FALSE;
+    if (active_app_name) {
+        free(active_app_name);
+        active_app_name = NULL;
     }
 }
 
 // Get currently selected text
 SelectionData* get_selected_text() {
-    char* text = get_selection_via_xclip();
+    char* text = get_primary_selection();
     if (!text || strlen(text) == 0) {
         if (text) free(text);
         return NULL;
@@ -321,65 +431,48 @@ SelectionData* get_selected_text() {
     SelectionData* data = (SelectionData*)malloc(sizeof(SelectionData));
     data->text = text;
     data->length = strlen(text);
+    data->x = 0;
+    data->y = 0;
+    data->app_name = NULL;
     
-    // Get mouse position
-    get_mouse_position(&data->x, &data->y);
-    
-    // Get active window application name
-    Window active_window = get_active_window();
-    data->app_name = get_window_class(active_window);
+    if (x11_reactor_call(fill_selection_context_task, data) != STATUS_SUCCESS) {
+        data->app_name = strdup("unknown");
+    }
     
     return data;
 }
 
-// Replace selected text using clipboard and keyboard simulation
-int replace_selected_text(const char* new_text) {
-    if (!new_text) {
-        return STATUS_ERROR_INIT;
+// Selection for a hotkey pressed at root coordinates (reactor thread only)
+SelectionData* get_selected_text_at(int root_x, int root_y) {
+    // XFixes keeps the cache current unless a change is still settling;
+    // the polling fallback can be up to one interval behind
+    char* text;
+    if (monitor_mode == SELECTION_MONITOR_XFIXES && cached_primary_valid) {
+        text = cached_primary ? strdup(cached_primary) : NULL;
+    } else {
+        text = get_primary_selection();
     }
     
-    // Store current clipboard content
-    char* original_clipboard = NULL;
-    FILE* pipe = popen("xclip -selection clipboard -o 2>/dev/null", "r");
-    if (pipe) {
-        char buffer[4096];
-        size_t read_size = fread(buffer, 1, sizeof(buffer) - 1, pipe);
-        if (read_size > 0) {
-            buffer[read_size] = '\0';
-            original_clipboard = strdup(buffer);
-        }
-        pclose(pipe);
+    if (!text || strlen(text) == 0) {
+        if (text) free(text);
+        return NULL;
     }
     
-    // Set new text to clipboard
-    FILE* clip_pipe = popen("xclip -selection clipboard", "w");
-    if (!clip_pipe) {
-        if (original_clipboard) free(original_clipboard);
+    SelectionData* data = (SelectionData*)malloc(sizeof(SelectionData));
+    data->text = text;
+    data->length = strlen(text);
+    scale_root_position(root_x, root_y, &data->x, &data->y);
+    data->app_name = strdup(active_app_name ? active_app_name : "unknown");
+    return data;
+}
+
+// Replace selected text using clipboard and keyboard simulation
+int replace_selected_text(const char* new_text) {
+    if (!new_text) {
         return STATUS_ERROR_INIT;
     }
     
-    fwrite(new_text, 1, strlen(new_text), clip_pipe);
-    pclose(clip_pipe);
-    
-    // Simulate Ctrl+V to paste
-    char cmd[256];
-    snprintf(cmd, sizeof(cmd), "xdotool key ctrl+v");
-    int result = system(cmd);
-    
-    // Give some time for the paste to complete
-    usleep(100000); // 100ms
-    
-    // Restore original clipboard content
-    if (original_clipboard) {
-        FILE* restore_pipe = popen("xclip -selection clipboard", "w");
-        if (restore_pipe) {
-            fwrite(original_clipboard, 1, strlen(original_clipboard), restore_pipe);
-            pclose(restore_pipe);
-        }
-        free(original_clipboard);
-    }
-    
-    return result == 0 ? STATUS_SUCCESS : STATUS_ERROR_INIT;
+    return replace_text_via_clipboard(new_text);
 }
 
 // Replace text at specific coordinates
@@ -406,3 +499,8 @@ int set_text_selection_callback(SelectionCallback callback) {
     selection_callback = callback;
     return STATUS_SUCCESS;
 }
+
+// Number of CLIPBOARD owner changes seen so far
+int get_clipboard_generation() {
+    return g_atomic_int_get(&clipboard_generation);
+}
@@ -16,6 +16,11 @@ void cleanup_text_selection_monitor();
 // Get currently selected text
 SelectionData* get_selected_text();
 
+// Selection for a hotkey pressed at raw root coordinates. Serves the
+// PRIMARY text cached from XFixes notifications and the cached active
+// application, so it does not wait on other clients. Reactor thread only.
+SelectionData* get_selected_text_at(int root_x, int root_y);
+
 // Replace selected text
 int replace_selected_text(const char* new_text);
 
@@ -25,6 +30,9 @@ int replace_text_at_coords(const char* new_text, int x, int y);
 // Set callback for selection changes
 int set_text_selection_callback(SelectionCallback callback);
 
+// Number of CLIPBOARD owner changes seen so far (XFixes mode only, 0 otherwise)
+int get_clipboard_generation();
+
 #ifdef __cplusplus
 }
 #endif
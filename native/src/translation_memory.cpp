@@ -0,0 +1,441 @@
+#include "translation_memory.h"
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define TM_ROWS (TM_SIGNATURE_SIZE / TM_BANDS)
+#define TM_SHINGLE 5
+#define TM_BUCKET_CAP (TM_BUCKET_SCAN * 4)
+#define TM_VERIFY 4             // Candidates checked exactly per lookup
+
+typedef struct {
+    guint64 seq;
+    char* operation;
+    char* text;
+    char* result;
+    guint32 signature[TM_SIGNATURE_SIZE];
+    size_t bytes;
+} TmEntry;
+
+// Entries sharing one band of signature values, oldest first
+typedef struct {
+    guint64 key;
+    GArray* seqs;   // guint64
+} TmBucket;
+
+typedef struct {
+    TmEntry* entry;
+    int agreement;  // Signature values in common
+} TmCandidate;
+
+// Everything below is guarded by tm_lock
+static GRWLock tm_lock;
+static gboolean tm_ready = FALSE;
+static TmEntry** ring = NULL;           // Entry with sequence s at s % TM_MAX_ENTRIES
+static guint64 oldest_seq = 0;
+static guint64 next_seq = 0;
+static GHashTable* buckets = NULL;      // &bucket->key -> TmBucket*
+static size_t bytes_used = 0;
+static size_t byte_budget = 0;
+static double hint_threshold = TM_DEFAULT_HINT_SIMILARITY;
+static double serve_threshold = TM_DEFAULT_SERVE_SIMILARITY;
+
+// Multiply-shift hash family for the signature, fixed at init
+static guint64 hash_a[TM_SIGNATURE_SIZE];
+static guint64 hash_b[TM_SIGNATURE_SIZE];
+
+static inline guint64 fmix64(guint64 k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static guint64 splitmix64(guint64* state) {
+    *state += 0x9e3779b97f4a7c15ULL;
+    return fmix64(*state);
+}
+
+// Lowercase ASCII and collapse whitespace runs into one space, trimmed
+static GString* normalize(const char* text) {
+    GString* out = g_string_sized_new(strlen(text));
+    gboolean in_blank = TRUE;  // Drops leading whitespace
+    for (const char* p = text; *p; p++) {
+        if (g_ascii_isspace(*p)) {
+            in_blank = TRUE;
+            continue;
+        }
+        if (in_blank && out->len > 0) {
+            g_string_append_c(out, ' ');
+        }
+        in_blank = FALSE;
+        g_string_append_c(out, g_ascii_tolower(*p));
+    }
+    return out;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    guint64 x = *(const guint64*)a;
+    guint64 y = *(const guint64*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Sorted, distinct hashes of every TM_SHINGLE-byte window
+static GArray* shingle_set(const GString* normalized) {
+    GArray* set = g_array_new(FALSE, FALSE, sizeof(guint64));
+    size_t windows = normalized->len >= TM_SHINGLE ? normalized->len - TM_SHINGLE + 1 : 1;
+    for (size_t i = 0; i < windows; i++) {
+        guint64 window = 0;
+        memcpy(&window, normalized->str + i, MIN((size_t)TM_SHINGLE, normalized->len));
+        guint64 h = fmix64(window * 0x9e3779b97f4a7c15ULL + TM_SHINGLE);
+        g_array_append_val(set, h);
+    }
+
+    qsort(set->data, set->len, sizeof(guint64), compare_u64);
+    guint kept = 0;
+    guint64* values = (guint64*)set->data;
+    for (guint i = 0; i < set->len; i++) {
+        if (kept == 0 || values[kept - 1] != values[i]) {
+            values[kept++] = values[i];
+        }
+    }
+    g_array_set_size(set, kept);
+    return set;
+}
+
+static void compute_signature(const GArray* shingles, guint32* signature) {
+    const guint64* values = (const guint64*)shingles->data;
+    for (int k = 0; k < TM_SIGNATURE_SIZE; k++) {
+        guint32 lowest = G_MAXUINT32;
+        for (guint i = 0; i < shingles->len; i++) {
+            guint32 h = (guint32)((hash_a[k] * values[i] + hash_b[k]) >> 32);
+            if (h < lowest) lowest = h;
+        }
+        signature[k] = lowest;
+    }
+}
+
+static double jaccard(const GArray* a, const GArray* b) {
+    const guint64* x = (const guint64*)a->data;
+    const guint64* y = (const guint64*)b->data;
+    guint i = 0, j = 0, shared = 0;
+    while (i < a->len && j < b->len) {
+        if (x[i] == y[j]) { shared++; i++; j++; }
+        else if (x[i] < y[j]) i++;
+        else j++;
+    }
+    guint total = a->len + b->len - shared;
+    return total > 0 ? (double)shared / total : 1.0;
+}
+
+// Bucket key of one band; the operation is mixed in so operations never
+// share buckets
+static guint64 band_key(const char* operation, const guint32* signature, int band) {
+    guint64 key = fmix64(g_str_hash(operation) + (guint64)band * 0x9e3779b97f4a7c15ULL);
+    for (int r = 0; r < TM_ROWS; r++) {
+        key = fmix64(key ^ signature[band * TM_ROWS + r]);
+    }
+    return key;
+}
+
+static void free_bucket(gpointer data) {
+    TmBucket* bucket = (TmBucket*)data;
+    g_array_free(bucket->seqs, TRUE);
+    free(bucket);
+}
+
+static void free_entry(TmEntry* entry) {
+    free(entry->operation);
+    free(entry->text);
+    free(entry->result);
+    free(entry);
+}
+
+// Take an entry out of its buckets and the ring. Caller holds the writer lock.
+static void unlink_entry_locked(TmEntry* entry) {
+    for (int band = 0; band < TM_BANDS; band++) {
+        guint64 key = band_key(entry->operation, entry->signature, band);
+        TmBucket* bucket = (TmBucket*)g_hash_table_lookup(buckets, &key);
+        if (!bucket) {
+            continue;
+        }
+        guint64* seqs = (guint64*)bucket->seqs->data;
+        for (guint i = 0; i < bucket->seqs->len; i++) {
+            if (seqs[i] == entry->seq) {
+                g_array_remove_index(bucket->seqs, i);
+                break;
+            }
+        }
+        if (bucket->seqs->len == 0) {
+            g_hash_table_remove(buckets, &key);
+        }
+    }
+
+    ring[entry->seq % TM_MAX_ENTRIES] = NULL;
+    bytes_used -= entry->bytes;
+    free_entry(entry);
+}
+
+// Caller holds the writer lock
+static void evict_oldest_locked() {
+    TmEntry* entry = ring[oldest_seq % TM_MAX_ENTRIES];
+    if (entry && entry->seq == oldest_seq) {
+        unlink_entry_locked(entry);
+    }
+    oldest_seq++;
+}
+
+static TmEntry* entry_for(guint64 seq) {
+    if (seq < oldest_seq || seq >= next_seq) {
+        return NULL;
+    }
+    TmEntry* entry = ring[seq % TM_MAX_ENTRIES];
+    return entry && entry->seq == seq ? entry : NULL;
+}
+
+// Initialize the index
+int init_translation_memory(size_t budget_bytes) {
+    g_rw_lock_init(&tm_lock);
+
+    guint64 state = 0x5eed;
+    for (int k = 0; k < TM_SIGNATURE_SIZE; k++) {
+        hash_a[k] = splitmix64(&state) | 1;
+        hash_b[k] = splitmix64(&state);
+    }
+
+    ring = (TmEntry**)calloc(TM_MAX_ENTRIES, sizeof(TmEntry*));
+    if (!ring) {
+        return STATUS_ERROR_INIT;
+    }
+    buckets = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, free_bucket);
+    oldest_seq = next_seq = 0;
+    bytes_used = 0;
+    byte_budget = budget_bytes;
+    hint_threshold = TM_DEFAULT_HINT_SIMILARITY;
+    serve_threshold = TM_DEFAULT_SERVE_SIMILARITY;
+    tm_ready = TRUE;
+
+    printf("✅ Translation memory ready (%zu KiB budget)\n", budget_bytes / 1024);
+    return STATUS_SUCCESS;
+}
+
+void cleanup_translation_memory() {
+    if (!tm_ready) {
+        return;
+    }
+
+    translation_memory_clear();
+
+    g_rw_lock_writer_lock(&tm_lock);
+    tm_ready = FALSE;
+    g_hash_table_destroy(buckets);
+    buckets = NULL;
+    free(ring);
+    ring = NULL;
+    g_rw_lock_writer_unlock(&tm_lock);
+}
+
+void translation_memory_add(const char* text, const char* operation, const char* result) {
+    if (!tm_ready || !text || !operation || !result) {
+        return;
+    }
+
+    size_t length = strlen(text);
+    if (length == 0 || length > TM_MAX_TEXT) {
+        return;
+    }
+
+    // Signature work happens before taking the lock
+    TmEntry* entry = (TmEntry*)malloc(sizeof(TmEntry));
+    GString* normalized = normalize(text);
+    GArray* shingles = shingle_set(normalized);
+    compute_signature(shingles, entry->signature);
+    g_array_free(shingles, TRUE);
+    g_string_free(normalized, TRUE);
+
+    entry->operation = strdup(operation);
+    entry->text = strdup(text);
+    entry->result = strdup(result);
+    entry->bytes = sizeof(TmEntry) + length + strlen(operation) + strlen(result) + 3 +
+                   TM_BANDS * (sizeof(guint64) + sizeof(TmBucket));
+
+    g_rw_lock_writer_lock(&tm_lock);
+    if (!tm_ready || entry->bytes > byte_budget) {
+        g_rw_lock_writer_unlock(&tm_lock);
+        free_entry(entry);
+        return;
+    }
+
+    while (oldest_seq < next_seq &&
+           (next_seq - oldest_seq >= TM_MAX_ENTRIES || bytes_used + entry->bytes > byte_budget)) {
+        evict_oldest_locked();
+    }
+
+    entry->seq = next_seq++;
+    ring[entry->seq % TM_MAX_ENTRIES] = entry;
+    bytes_used += entry->bytes;
+
+    for (int band = 0; band < TM_BANDS; band++) {
+        guint64 key = band_key(operation, entry->signature, band);
+        TmBucket* bucket = (TmBucket*)g_hash_table_lookup(buckets, &key);
+        if (!bucket) {
+            bucket = (TmBucket*)malloc(sizeof(TmBucket));
+            bucket->key = key;
+            bucket->seqs = g_array_new(FALSE, FALSE, sizeof(guint64));
+            g_hash_table_insert(buckets, &bucket->key, bucket);
+        }
+        if (bucket->seqs->len >= TM_BUCKET_CAP) {
+            g_array_remove_index(bucket->seqs, 0);  // Boilerplate: keep the newest
+        }
+        g_array_append_val(bucket->seqs, entry->seq);
+    }
+    g_rw_lock_writer_unlock(&tm_lock);
+}
+
+// Keep the TM_VERIFY candidates with the most signature agreement
+static void offer_candidate(TmCandidate* best, TmEntry* entry, int agreement) {
+    for (int i = 0; i < TM_VERIFY; i++) {
+        if (best[i].entry == entry) {
+            return;  // Already seen through another band
+        }
+    }
+    int slot = -1;
+    for (int i = 0; i < TM_VERIFY; i++) {
+        if (!best[i].entry) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 || best[i].agreement < best[slot].agreement) {
+            slot = i;
+        }
+    }
+    if (!best[slot].entry || best[slot].agreement < agreement) {
+        best[slot].entry = entry;
+        best[slot].agreement = agreement;
+    }
+}
+
+int translation_memory_lookup(const char* text, const char* operation, double min_similarity,
+                              char** source, char** result, double* similarity) {
+    if (!tm_ready || !text || !operation || !source || !result || min_similarity <= 0) {
+        return 0;
+    }
+    if (strlen(text) > TM_MAX_TEXT) {
+        return 0;
+    }
+
+    guint32 signature[TM_SIGNATURE_SIZE];
+    GString* normalized = normalize(text);
+    GArray* shingles = shingle_set(normalized);
+    compute_signature(shingles, signature);
+    g_string_free(normalized, TRUE);
+
+    // The signature estimate is rough; leave room for the exact check
+    int min_agreement = (int)((min_similarity - 0.2) * TM_SIGNATURE_SIZE);
+
+    TmCandidate best[TM_VERIFY];
+    memset(best, 0, sizeof(best));
+    TmEntry* match = NULL;
+    double match_similarity = 0;
+
+    g_rw_lock_reader_lock(&tm_lock);
+    for (int band = 0; tm_ready && band < TM_BANDS; band++) {
+        guint64 key = band_key(operation, signature, band);
+        TmBucket* bucket = (TmBucket*)g_hash_table_lookup(buckets, &key);
+        if (!bucket) {
+            continue;
+        }
+
+        const guint64* seqs = (const guint64*)bucket->seqs->data;
+        guint scanned = 0;
+        for (guint i = bucket->seqs->len; i > 0 && scanned < TM_BUCKET_SCAN; i--, scanned++) {
+            TmEntry* entry = entry_for(seqs[i - 1]);
+            if (!entry || strcmp(entry->operation, operation) != 0) {
+                continue;
+            }
+            int agreement = 0;
+            for (int k = 0; k < TM_SIGNATURE_SIZE; k++) {
+                agreement += entry->signature[k] == signature[k];
+            }
+            if (agreement >= min_agreement) {
+                offer_candidate(best, entry, agreement);
+            }
+        }
+    }
+
+    for (int i = 0; i < TM_VERIFY; i++) {
+        if (!best[i].entry) {
+            continue;
+        }
+        GString* candidate_text = normalize(best[i].entry->text);
+        GArray* candidate_shingles = shingle_set(candidate_text);
+        double exact = jaccard(shingles, candidate_shingles);
+        g_array_free(candidate_shingles, TRUE);
+        g_string_free(candidate_text, TRUE);
+
+        if (exact >= min_similarity && exact > match_similarity) {
+            match = best[i].entry;
+            match_similarity = exact;
+        }
+    }
+
+    if (match) {
+        *source = strdup(match->text);
+        *result = strdup(match->result);
+        if (similarity) *similarity = match_similarity;
+    }
+    g_rw_lock_reader_unlock(&tm_lock);
+
+    g_array_free(shingles, TRUE);
+    return match != NULL;
+}
+
+void translation_memory_forget_operation(const char* operation) {
+    if (!tm_ready || !operation) {
+        return;
+    }
+
+    int dropped = 0;
+    g_rw_lock_writer_lock(&tm_lock);
+    for (guint64 seq = oldest_seq; tm_ready && seq < next_seq; seq++) {
+        TmEntry* entry = entry_for(seq);
+        if (entry && strcmp(entry->operation, operation) == 0) {
+            unlink_entry_locked(entry);
+            dropped++;
+        }
+    }
+    g_rw_lock_writer_unlock(&tm_lock);
+
+    if (dropped > 0) {
+        printf("🗑️  Translation memory dropped %d entries for %s\n", dropped, operation);
+    }
+}
+
+void translation_memory_clear() {
+    if (!tm_ready) {
+        return;
+    }
+
+    g_rw_lock_writer_lock(&tm_lock);
+    while (oldest_seq < next_seq) {
+        evict_oldest_locked();
+    }
+    g_rw_lock_writer_unlock(&tm_lock);
+}
+
+void translation_memory_set_thresholds(double hint_similarity, double serve_similarity) {
+    g_rw_lock_writer_lock(&tm_lock);
+    hint_threshold = hint_similarity;
+    serve_threshold = serve_similarity;
+    g_rw_lock_writer_unlock(&tm_lock);
+}
+
+void translation_memory_get_thresholds(double* hint_similarity, double* serve_similarity) {
+    g_rw_lock_reader_lock(&tm_lock);
+    *hint_similarity = hint_threshold;
+    *serve_similarity = serve_threshold;
+    g_rw_lock_reader_unlock(&tm_lock);
+}
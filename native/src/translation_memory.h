@@ -0,0 +1,57 @@
+#ifndef TRANSLATION_MEMORY_H
+#define TRANSLATION_MEMORY_H
+
+#include "../include/instant_translator.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fuzzy index over previously processed (text, operation, result) triples.
+// Texts are compared as sets of 5-byte shingles of their normalized form
+// (lowercased, whitespace collapsed). Each entry keeps a MinHash signature
+// of TM_SIGNATURE_SIZE values, and LSH banding (TM_BANDS bands of
+// TM_SIGNATURE_SIZE / TM_BANDS rows) puts likely neighbours in shared
+// buckets. A lookup reads at most TM_BUCKET_SCAN entries per band, so
+// cost doesn't grow with the index. The best few candidates then get an
+// exact Jaccard check.
+#define TM_SIGNATURE_SIZE 32
+#define TM_BANDS 8
+#define TM_BUCKET_SCAN 64
+#define TM_MAX_ENTRIES 262144
+#define TM_MAX_TEXT 4096                        // Longer texts aren't indexed
+#define TM_DEFAULT_BUDGET (32 * 1024 * 1024)
+
+// Similarities below which a prior result isn't worth sending as a hint
+// and above which it may be served as is (off by default)
+#define TM_DEFAULT_HINT_SIMILARITY 0.5
+#define TM_DEFAULT_SERVE_SIMILARITY 0.0
+
+// Initialize the index with a byte budget; the oldest entries go first
+int init_translation_memory(size_t budget_bytes);
+
+void cleanup_translation_memory();
+
+// Remember a result
+void translation_memory_add(const char* text, const char* operation, const char* result);
+
+// Closest prior text for the same operation with Jaccard similarity of at
+// least `min_similarity`: 1 with copies of its text and result (free with
+// free()) and the similarity, or 0
+int translation_memory_lookup(const char* text, const char* operation, double min_similarity,
+                              char** source, char** result, double* similarity);
+
+// Forget one operation's entries, or everything
+void translation_memory_forget_operation(const char* operation);
+void translation_memory_clear();
+
+// Thresholds used by send_processing_request; 0 turns either off
+void translation_memory_set_thresholds(double hint_similarity, double serve_similarity);
+void translation_memory_get_thresholds(double* hint_similarity, double* serve_similarity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRANSLATION_MEMORY_H
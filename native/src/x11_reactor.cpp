@@ -0,0 +1,448 @@
+#include "x11_reactor.h"
+#include <X11/Xlib.h>
+#include <glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// Registered event handler
+typedef struct {
+    X11EventHandler handler;
+    void* user_data;
+} HandlerEntry;
+
+// Queued cross-thread call
+typedef struct {
+    X11ReactorTask task;
+    void* user_data;
+    gboolean done;
+} TaskEntry;
+
+// Pending one-shot timer
+typedef struct {
+    unsigned int id;
+    gint64 deadline;
+    X11ReactorTask task;
+    void* user_data;
+} TimerEntry;
+
+// Reactor connection and thread
+static Display* display = NULL;
+static GThread* reactor_thread = NULL;
+static gboolean reactor_running = FALSE;  // Read via g_atomic_int_get off the lock
+static int epoll_fd = -1;
+static int command_fd = -1;
+
+// Handlers and timers (reactor thread only once running)
+static GPtrArray* handlers = NULL;
+static GList* timers = NULL;
+static unsigned int next_timer_id = 1;
+static GQueue deferred_events = G_QUEUE_INIT;
+
+// Cross-thread task queue
+static GMutex task_lock;
+static GCond task_cond;
+static GQueue task_queue = G_QUEUE_INIT;
+
+// Previous Xlib error handler, chained for other connections
+static XErrorHandler previous_error_handler = NULL;
+
+// Error trap (reactor thread only)
+static int trap_depth = 0;
+static int trapped_error = Success;    // First error caught while trapped
+
+// Peers (selection requestors, grab targets) may vanish at any time;
+// errors on our connection are expected and must not abort the process.
+// Inside a trap the first one is kept for x11_reactor_untrap_errors.
+static int reactor_error_handler(Display* error_display, XErrorEvent* error) {
+    if (error_display == display) {
+        if (trap_depth > 0 && trapped_error == Success) {
+            trapped_error = error->error_code;
+        }
+        return 0;
+    }
+    return previous_error_handler ? previous_error_handler(error_display, error) : 0;
+}
+
+static void wake_reactor() {
+    uint64_t one = 1;
+    ssize_t ignored = write(command_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+// Hand an event to each handler until one consumes it
+static void dispatch_event(XEvent* event) {
+    for (guint i = 0; i < handlers->len; i++) {
+        HandlerEntry* entry = (HandlerEntry*)g_ptr_array_index(handlers, i);
+        if (entry->handler(event, entry->user_data)) {
+            return;
+        }
+    }
+}
+
+// Events that complete in-flight selection transfers
+static gboolean is_selection_protocol_event(int type) {
+    return type == SelectionNotify || type == SelectionRequest ||
+           type == SelectionClear || type == PropertyNotify;
+}
+
+static void run_queued_tasks() {
+    while (TRUE) {
+        g_mutex_lock(&task_lock);
+        TaskEntry* entry = (TaskEntry*)g_queue_pop_head(&task_queue);
+        g_mutex_unlock(&task_lock);
+        if (!entry) {
+            return;
+        }
+
+        entry->task(display, entry->user_data);
+
+        g_mutex_lock(&task_lock);
+        entry->done = TRUE;
+        g_cond_broadcast(&task_cond);
+        g_mutex_unlock(&task_lock);
+    }
+}
+
+// Fire due timers; returns milliseconds until the next one, or -1
+static int run_due_timers() {
+    gint64 now = g_get_monotonic_time();
+
+    while (timers) {
+        TimerEntry* timer = (TimerEntry*)timers->data;
+        if (timer->deadline > now) {
+            gint64 remaining = timer->deadline - now;
+            return (int)((remaining + 999) / 1000);
+        }
+        timers = g_list_delete_link(timers, timers);
+        timer->task(display, timer->user_data);
+        free(timer);
+        now = g_get_monotonic_time();
+    }
+    return -1;
+}
+
+static gint compare_timers(gconstpointer a, gconstpointer b) {
+    gint64 da = ((const TimerEntry*)a)->deadline;
+    gint64 db = ((const TimerEntry*)b)->deadline;
+    return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+// Reactor thread: sleep in epoll until X traffic, a command or a timer
+static gpointer reactor_thread_func(gpointer data) {
+    struct epoll_event ready[2];
+
+    while (g_atomic_int_get(&reactor_running)) {
+        // Events a nested pump deferred were read before anything still
+        // queued, so they go first, even in the middle of a batch
+        for (;;) {
+            XEvent* deferred = (XEvent*)g_queue_pop_head(&deferred_events);
+            if (deferred) {
+                dispatch_event(deferred);
+                free(deferred);
+                continue;
+            }
+            if (XPending(display) <= 0) {
+                break;
+            }
+            XEvent event;
+            XNextEvent(display, &event);
+            dispatch_event(&event);
+        }
+
+        int timeout_ms = run_due_timers();
+
+        // Handlers and timers may have queued requests or read replies
+        XFlush(display);
+        if (XPending(display) > 0 || !g_queue_is_empty(&deferred_events)) {
+            continue;
+        }
+
+        int count = epoll_wait(epoll_fd, ready, 2, timeout_ms);
+        if (count < 0 && errno != EINTR) {
+            printf("❌ X11 reactor epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (ready[i].data.fd == command_fd) {
+                uint64_t value;
+                ssize_t ignored = read(command_fd, &value, sizeof(value));
+                (void)ignored;
+                run_queued_tasks();
+            }
+        }
+    }
+
+    // Release anyone still waiting on a call
+    run_queued_tasks();
+    return NULL;
+}
+
+// Start the reactor
+int init_x11_reactor() {
+    display = XOpenDisplay(NULL);
+    if (!display) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    command_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (command_fd < 0 || epoll_fd < 0) {
+        cleanup_x11_reactor();
+        return STATUS_ERROR_INIT;
+    }
+
+    struct epoll_event x_event;
+    memset(&x_event, 0, sizeof(x_event));
+    x_event.events = EPOLLIN;
+    x_event.data.fd = ConnectionNumber(display);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, x_event.data.fd, &x_event);
+
+    struct epoll_event command_event;
+    memset(&command_event, 0, sizeof(command_event));
+    command_event.events = EPOLLIN;
+    command_event.data.fd = command_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, command_fd, &command_event);
+
+    g_mutex_init(&task_lock);
+    g_cond_init(&task_cond);
+    handlers = g_ptr_array_new_with_free_func(free);
+    previous_error_handler = XSetErrorHandler(reactor_error_handler);
+
+    g_atomic_int_set(&reactor_running, TRUE);
+    reactor_thread = g_thread_new("x11-reactor", reactor_thread_func, NULL);
+    if (!reactor_thread) {
+        cleanup_x11_reactor();
+        return STATUS_ERROR_INIT;
+    }
+
+    return STATUS_SUCCESS;
+}
+
+// Stop the reactor
+void cleanup_x11_reactor() {
+    if (reactor_thread) {
+        // Callers check the flag under the lock, so nothing is queued
+        // after the thread's final drain
+        g_mutex_lock(&task_lock);
+        g_atomic_int_set(&reactor_running, FALSE);
+        g_mutex_unlock(&task_lock);
+
+        wake_reactor();
+        g_thread_join(reactor_thread);
+        reactor_thread = NULL;
+    }
+
+    while (timers) {
+        free(timers->data);
+        timers = g_list_delete_link(timers, timers);
+    }
+    XEvent* deferred;
+    while ((deferred = (XEvent*)g_queue_pop_head(&deferred_events)) != NULL) {
+        free(deferred);
+    }
+
+    if (handlers) {
+        g_ptr_array_free(handlers, TRUE);
+        handlers = NULL;
+        g_cond_clear(&task_cond);
+        g_mutex_clear(&task_lock);
+    }
+
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (command_fd >= 0) {
+        close(command_fd);
+        command_fd = -1;
+    }
+
+    if (display) {
+        XSetErrorHandler(previous_error_handler);
+        XCloseDisplay(display);
+        display = NULL;
+    }
+}
+
+Display* x11_reactor_display() {
+    return display;
+}
+
+int x11_reactor_in_thread() {
+    return reactor_thread != NULL && g_thread_self() == reactor_thread;
+}
+
+int x11_reactor_add_handler(X11EventHandler handler, void* user_data) {
+    if (!handlers || !handler) {
+        return STATUS_ERROR_INIT;
+    }
+
+    HandlerEntry* entry = (HandlerEntry*)malloc(sizeof(HandlerEntry));
+    entry->handler = handler;
+    entry->user_data = user_data;
+    g_ptr_array_add(handlers, entry);
+    return STATUS_SUCCESS;
+}
+
+void x11_reactor_remove_handler(X11EventHandler handler, void* user_data) {
+    if (!handlers) return;
+
+    for (guint i = 0; i < handlers->len; i++) {
+        HandlerEntry* entry = (HandlerEntry*)g_ptr_array_index(handlers, i);
+        if (entry->handler == handler && entry->user_data == user_data) {
+            g_ptr_array_remove_index(handlers, i);
+            return;
+        }
+    }
+}
+
+// Run `task` on the reactor thread and wait for it
+int x11_reactor_call(X11ReactorTask task, void* user_data) {
+    if (!display || !reactor_thread) {
+        return STATUS_ERROR_NO_DISPLAY;
+    }
+
+    if (x11_reactor_in_thread()) {
+        task(display, user_data);
+        return STATUS_SUCCESS;
+    }
+
+    TaskEntry entry;
+    entry.task = task;
+    entry.user_data = user_data;
+    entry.done = FALSE;
+
+    g_mutex_lock(&task_lock);
+    if (!reactor_running) {
+        g_mutex_unlock(&task_lock);
+        return STATUS_ERROR_INIT;
+    }
+    g_queue_push_tail(&task_queue, &entry);
+    g_mutex_unlock(&task_lock);
+
+    wake_reactor();
+
+    g_mutex_lock(&task_lock);
+    while (!entry.done) {
+        g_cond_wait(&task_cond, &task_lock);
+    }
+    g_mutex_unlock(&task_lock);
+
+    return STATUS_SUCCESS;
+}
+
+typedef struct {
+    const char* name;
+    Atom atom;
+} InternRequest;
+
+static void intern_task(Display* task_display, void* user_data) {
+    InternRequest* request = (InternRequest*)user_data;
+    request->atom = XInternAtom(task_display, request->name, False);
+}
+
+Atom x11_reactor_intern(const char* name) {
+    InternRequest request = { name, None };
+    x11_reactor_call(intern_task, &request);
+    return request.atom;
+}
+
+void x11_reactor_trap_errors() {
+    if (trap_depth++ == 0) {
+        trapped_error = Success;
+    }
+}
+
+int x11_reactor_untrap_errors() {
+    XSync(display, False);
+    int error_code = trapped_error;
+    if (trap_depth > 0 && --trap_depth == 0) {
+        trapped_error = Success;
+    }
+    return error_code;
+}
+
+unsigned int x11_reactor_add_timeout(int delay_ms, X11ReactorTask task, void* user_data) {
+    TimerEntry* timer = (TimerEntry*)malloc(sizeof(TimerEntry));
+    timer->id = next_timer_id++;
+    timer->deadline = g_get_monotonic_time() + (gint64)delay_ms * 1000;
+    timer->task = task;
+    timer->user_data = user_data;
+
+    GList* node = timers;
+    GList* previous = NULL;
+    while (node && compare_timers(node->data, timer) <= 0) {
+        previous = node;
+        node = node->next;
+    }
+    if (!previous) {
+        timers = g_list_prepend(timers, timer);
+    } else {
+        // Insert after `previous` without walking the list again
+        GList* link = g_list_alloc();
+        link->data = timer;
+        link->prev = previous;
+        link->next = previous->next;
+        if (previous->next) previous->next->prev = link;
+        previous->next = link;
+    }
+    return timer->id;
+}
+
+void x11_reactor_remove_timeout(unsigned int timeout_id) {
+    for (GList* node = timers; node; node = node->next) {
+        TimerEntry* timer = (TimerEntry*)node->data;
+        if (timer->id == timeout_id) {
+            free(timer);
+            timers = g_list_delete_link(timers, node);
+            return;
+        }
+    }
+}
+
+// Dispatch selection traffic until `predicate` holds
+int x11_reactor_pump_until(X11ReactorPredicate predicate, void* user_data, int timeout_ms) {
+    gint64 deadline = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+    int result = predicate(user_data);
+
+    while (!result) {
+        XFlush(display);
+        while (XPending(display) > 0 && !result) {
+            XEvent event;
+            XNextEvent(display, &event);
+
+            if (is_selection_protocol_event(event.type)) {
+                dispatch_event(&event);
+            } else {
+                XEvent* copy = (XEvent*)malloc(sizeof(XEvent));
+                *copy = event;
+                g_queue_push_tail(&deferred_events, copy);
+            }
+            result = predicate(user_data);
+        }
+        if (result) {
+            break;
+        }
+
+        gint64 remaining = deadline - g_get_monotonic_time();
+        if (remaining <= 0) {
+            break;
+        }
+
+        struct pollfd fd;
+        fd.fd = ConnectionNumber(display);
+        fd.events = POLLIN;
+        if (poll(&fd, 1, (int)((remaining + 999) / 1000)) < 0 && errno != EINTR) {
+            break;
+        }
+    }
+
+    return result;
+}
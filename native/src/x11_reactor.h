@@ -0,0 +1,66 @@
+#ifndef X11_REACTOR_H
+#define X11_REACTOR_H
+
+#include "../include/instant_translator.h"
+#include <X11/Xlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Event handler; return 1 if the event was consumed
+typedef int (*X11EventHandler)(XEvent* event, void* user_data);
+
+// Work item executed on the reactor thread
+typedef void (*X11ReactorTask)(Display* display, void* user_data);
+
+// Completion predicate for x11_reactor_pump_until()
+typedef int (*X11ReactorPredicate)(void* user_data);
+
+// Start the reactor: one X connection, one thread, blocking in epoll on
+// the X socket and an eventfd used for commands and shutdown
+int init_x11_reactor();
+
+// Stop the reactor thread and close the connection
+void cleanup_x11_reactor();
+
+// The shared connection. Only use it on the reactor thread.
+Display* x11_reactor_display();
+
+// Whether the caller is running on the reactor thread
+int x11_reactor_in_thread();
+
+// Register/unregister an event handler (reactor thread only)
+int x11_reactor_add_handler(X11EventHandler handler, void* user_data);
+void x11_reactor_remove_handler(X11EventHandler handler, void* user_data);
+
+// Run `task` on the reactor thread and wait for it to finish.
+// Runs inline when already on the reactor thread.
+int x11_reactor_call(X11ReactorTask task, void* user_data);
+
+// Reactor thread only: errors on the shared connection are dropped, except
+// between these two calls. x11_reactor_untrap_errors syncs with the server
+// and returns the first error code caught since the trap was set (Success
+// if none). Traps nest; an inner one also sees errors from before it.
+void x11_reactor_trap_errors();
+int x11_reactor_untrap_errors();
+
+// Intern an atom on the shared connection from any thread
+Atom x11_reactor_intern(const char* name);
+
+// One-shot timer (reactor thread only); returns an id > 0
+unsigned int x11_reactor_add_timeout(int delay_ms, X11ReactorTask task, void* user_data);
+void x11_reactor_remove_timeout(unsigned int timeout_id);
+
+// Reactor thread only: dispatch selection-protocol events until
+// `predicate` returns nonzero or `timeout_ms` elapses. Input and
+// notification events are deferred until the outer loop resumes, so
+// handlers are never re-entered; it then dispatches them ahead of later
+// events, keeping arrival order. Returns the final predicate value.
+int x11_reactor_pump_until(X11ReactorPredicate predicate, void* user_data, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // X11_REACTOR_H
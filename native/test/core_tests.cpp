@@ -0,0 +1,439 @@
+// Checks for the parts of the library that need no display, D-Bus or
+// backend: the on-disk result store, the sentence segmenter, the chunk
+// planner and sentence-level processing. Run through ctest; exits non-zero
+// when a check fails.
+
+#include "../src/result_store.h"
+#include "../src/text_segmenter.h"
+#include "../src/chunked_processing.h"
+#include "../src/segmented_processing.h"
+#include "../src/result_cache.h"
+#include "../src/translation_memory.h"
+#include "../src/dart_port_bridge.h"
+#include "../src/processing_scheduler.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            printf("❌ %s:%d: %s\n", __FILE__, __LINE__, #condition);        \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+// chunked_processing.cpp reaches into these; nothing here schedules or posts
+int scheduler_thread_priority() {
+    return PRIORITY_INTERACTIVE;
+}
+
+void scheduler_set_thread_priority(int priority) {
+    (void)priority;
+}
+
+void dart_port_bridge_post_chunk_progress(const char* operation, int completed, int total) {
+    (void)operation;
+    (void)completed;
+    (void)total;
+}
+
+// segmented_processing.cpp frees batch answers through the D-Bus service's
+// function; these come from fake_batch below
+void free_processing_results(ProcessingSegmentResult* results, int count) {
+    for (int i = 0; i < count; i++) {
+        free(results[i].result);
+    }
+    free(results);
+}
+
+static char* cache_root = NULL;
+
+static ResultKey make_key(guint64 n) {
+    ResultKey key = {n * 0x9E3779B97F4A7C15ull + 1, n ^ 0xA5A5A5A5A5A5A5A5ull};
+    return key;
+}
+
+// `size` bytes that differ per key and per round
+static char* make_value(guint64 n, int round, size_t size) {
+    char* value = (char*)malloc(size + 1);
+    for (size_t i = 0; i < size; i++) {
+        value[i] = (char)('a' + (n * 7 + round * 3 + i) % 26);
+    }
+    int prefix = snprintf(value, size + 1, "%llu/%d:", (unsigned long long)n, round);
+    value[prefix] = '-';
+    value[size] = '\0';
+    return value;
+}
+
+static gboolean lookup_equals(guint64 n, const char* expected) {
+    ResultKey key = make_key(n);
+    char* value = NULL;
+    if (!result_store_lookup(&key, &value)) {
+        return FALSE;
+    }
+    gboolean equal = strcmp(value, expected) == 0;
+    free(value);
+    return equal;
+}
+
+static char* log_file_path() {
+    return g_build_filename(cache_root, "instant_translator", "results.log", NULL);
+}
+
+static void test_store_basics() {
+    init_result_store();
+    result_store_clear();
+
+    ResultKey a = make_key(1);
+    ResultKey b = make_key(2);
+    ResultKey missing = make_key(3);
+    result_store_append(&a, "translate", "Hallo Welt");
+    result_store_append(&b, "summarize", "Short.");
+
+    CHECK(result_store_contains(&a));
+    CHECK(result_store_contains(&b));
+    CHECK(!result_store_contains(&missing));
+    CHECK(lookup_equals(1, "Hallo Welt"));
+    CHECK(lookup_equals(2, "Short."));
+
+    // The newest value for a key wins
+    result_store_append(&a, "translate", "Bonjour le monde");
+    CHECK(lookup_equals(1, "Bonjour le monde"));
+
+    long entries, bytes;
+    result_store_get_usage(&entries, &bytes);
+    CHECK(entries == 2);
+
+    // Survives a restart
+    cleanup_result_store();
+    init_result_store();
+    CHECK(lookup_equals(1, "Bonjour le monde"));
+    CHECK(lookup_equals(2, "Short."));
+
+    result_store_invalidate_operation("translate");
+    CHECK(!result_store_contains(&a));
+    CHECK(lookup_equals(2, "Short."));
+
+    result_store_clear();
+    CHECK(!result_store_contains(&b));
+    result_store_get_usage(&entries, &bytes);
+    CHECK(entries == 0);
+
+    cleanup_result_store();
+}
+
+// Overwrite most of a >1 MiB log so compaction runs, then check every key
+// still finds its latest value, before and after a restart
+static void test_store_compaction() {
+    const int keys = 40;
+    const int rounds = 5;
+    const size_t value_size = 8 * 1024;
+
+    init_result_store();
+    result_store_clear();
+
+    long appended = 0;
+    for (int round = 0; round < rounds; round++) {
+        for (int n = 0; n < keys; n++) {
+            ResultKey key = make_key(100 + n);
+            char* value = make_value(100 + n, round, value_size);
+            result_store_append(&key, round % 2 ? "translate" : "rephrase", value);
+            free(value);
+            appended += (long)value_size;
+        }
+    }
+
+    // Compaction runs in the background; wait for it to swap the log in
+    long entries = 0, bytes = 0;
+    for (int i = 0; i < 500; i++) {
+        result_store_get_usage(&entries, &bytes);
+        if (bytes < appended) break;
+        g_usleep(10 * 1000);
+    }
+    CHECK(bytes < appended);
+    CHECK(entries == keys);
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int n = 0; n < keys; n++) {
+            char* expected = make_value(100 + n, rounds - 1, value_size);
+            CHECK(lookup_equals(100 + n, expected));
+            free(expected);
+        }
+        cleanup_result_store();
+        init_result_store();
+    }
+
+    result_store_clear();
+    cleanup_result_store();
+}
+
+// A record whose bytes don't match its CRC, or that runs past the end of
+// the log, is a miss rather than a wrong answer
+static void test_store_torn_records() {
+    init_result_store();
+    result_store_clear();
+    ResultKey key = make_key(7);
+    result_store_append(&key, "translate", "a value that will be damaged");
+    cleanup_result_store();
+
+    char* path = log_file_path();
+    int fd = open(path, O_RDWR);
+    CHECK(fd >= 0);
+    struct stat st;
+    CHECK(fd >= 0 && fstat(fd, &st) == 0);
+    char byte = 0;
+    CHECK(pread(fd, &byte, 1, st.st_size - 3) == 1);
+    byte ^= 0x20;
+    CHECK(pwrite(fd, &byte, 1, st.st_size - 3) == 1);
+    close(fd);
+
+    init_result_store();
+    char* value = NULL;
+    CHECK(!result_store_lookup(&key, &value));
+    CHECK(!result_store_contains(&key));  // Dropped by the failed lookup
+
+    ResultKey other = make_key(8);
+    result_store_append(&other, "translate", "cut short by a crash");
+    cleanup_result_store();
+
+    // Keep its 32-byte header and the start of its value
+    CHECK(truncate(path, st.st_size + 32 + 5) == 0);
+
+    init_result_store();
+    CHECK(!result_store_lookup(&other, &value));
+    result_store_clear();
+    cleanup_result_store();
+    g_free(path);
+}
+
+static char* copy_span(const char* text, const TextSpan* span) {
+    return strndup(text + span->start, span->length);
+}
+
+// Joining a text's own segments gives the text back
+static void check_round_trip(const char* text, int expected_count) {
+    TextSpan* spans = NULL;
+    int count = 0;
+    CHECK(segment_text(text, &spans, &count) == STATUS_SUCCESS);
+    if (expected_count >= 0) {
+        CHECK(count == expected_count);
+    }
+
+    char** parts = (char**)calloc(count + 1, sizeof(char*));
+    size_t rebuilt = count > 0 ? spans[0].start : strlen(text);
+    for (int i = 0; i < count; i++) {
+        parts[i] = copy_span(text, &spans[i]);
+        CHECK(spans[i].length > 0);
+        rebuilt += spans[i].length + spans[i].gap;
+    }
+    CHECK(rebuilt == strlen(text));
+
+    char* joined = join_segments(text, spans, count, parts);
+    CHECK(joined && strcmp(joined, text) == 0);
+    free(joined);
+
+    for (int i = 0; i < count; i++) {
+        free(parts[i]);
+    }
+    free(parts);
+    free(spans);
+}
+
+static void test_segmenter() {
+    check_round_trip("", 0);
+    check_round_trip("   \n ", 0);
+    check_round_trip("One sentence without an end", 1);
+    check_round_trip("First one. Second one! Third?", 3);
+    check_round_trip("  Leading and trailing.  \n", 1);
+    check_round_trip("Dr. Smith met Mr. J. Doe at 3.5 p.m. yesterday. He left.", -1);
+    check_round_trip("Paragraph one\n\nParagraph two\n\n\nThree", 3);
+    check_round_trip("\"Quoted.\" Then (bracketed!) more…  Done。次の文。", -1);
+    check_round_trip("Line\xE2\x80\xA9Next", 2);
+
+    // Abbreviations and initials don't split
+    TextSpan* spans = NULL;
+    int count = 0;
+    segment_text("Dr. Smith arrived. It rained.", &spans, &count);
+    CHECK(count == 2);
+    free(spans);
+
+    // Replacement parts keep the original spacing, minus their own
+    const char* text = "Hello there.  How are you?\n\nFine.";
+    segment_text(text, &spans, &count);
+    CHECK(count == 3);
+    char* parts[] = {(char*)" Hallo. ", (char*)"Wie geht's?\n", (char*)"Gut."};
+    char* joined = count == 3 ? join_segments(text, spans, count, parts) : NULL;
+    CHECK(joined && strcmp(joined, "Hallo.  Wie geht's?\n\nGut.") == 0);
+    free(joined);
+    free(spans);
+}
+
+static gboolean is_continuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+// Every chunk fits, none splits a character, and together they are the text
+static void check_plan(const char* text, size_t budget) {
+    TextSpan* chunks = NULL;
+    int count = 0;
+    CHECK(plan_chunks(text, budget, &chunks, &count) == STATUS_SUCCESS);
+
+    size_t length = strlen(text);
+    size_t at = count > 0 ? chunks[0].start : length;
+    for (int i = 0; i < count; i++) {
+        CHECK(chunks[i].start == at);
+        CHECK(chunks[i].length > 0 && chunks[i].length <= budget);
+        CHECK(!is_continuation(text[chunks[i].start]));
+        CHECK(!is_continuation(text[chunks[i].start + chunks[i].length]));
+        at += chunks[i].length + chunks[i].gap;
+    }
+    CHECK(at == length);
+    free(chunks);
+}
+
+static void test_chunk_planner() {
+    char* sentences = (char*)malloc(64 * 1024);
+    sentences[0] = '\0';
+    for (int p = 0; p < 20; p++) {
+        for (int s = 0; s < 12; s++) {
+            char sentence[96];
+            snprintf(sentence, sizeof(sentence), "Sentence %d of paragraph %d goes here. ", s, p);
+            strcat(sentences, sentence);
+        }
+        strcat(sentences, "\n\n");
+    }
+    check_plan(sentences, 4096);
+    check_plan(sentences, 200);
+
+    // Paragraph breaks win once the chunk is at least half full
+    TextSpan* chunks = NULL;
+    int count = 0;
+    plan_chunks(sentences, 4096, &chunks, &count);
+    for (int i = 0; i + 1 < count; i++) {
+        const char* gap = sentences + chunks[i].start + chunks[i].length;
+        CHECK(memmem(gap, chunks[i].gap, "\n\n", 2) != NULL);
+    }
+    free(chunks);
+    free(sentences);
+
+    // Longer than the budget with nowhere to break: cut mid-word, but not
+    // inside a character (é is two bytes, the budget is odd)
+    GString* word = g_string_new("Start ");
+    for (int i = 0; i < 3000; i++) {
+        g_string_append(word, "\xC3\xA9");
+    }
+    g_string_append(word, " end.");
+    check_plan(word->str, 1001);
+    check_plan(word->str, 7);
+    g_string_free(word, TRUE);
+
+    char* spaced = (char*)malloc(20001);
+    for (int i = 0; i < 20000; i++) {
+        spaced[i] = i % 9 == 8 ? ' ' : 'x';
+    }
+    spaced[20000] = '\0';
+    check_plan(spaced, 1000);
+    free(spaced);
+
+    check_plan("Short.", 4096);
+}
+
+// Stands in for send_processing_batch: answers each segment with its text
+// in brackets and counts what was sent
+static int batches_sent = 0;
+static int segments_sent = 0;
+
+static int fake_batch(const ProcessingSegment* segments, int count, ProcessingSegmentResult** results) {
+    batches_sent++;
+    segments_sent += count;
+    *results = (ProcessingSegmentResult*)calloc(count, sizeof(ProcessingSegmentResult));
+    for (int i = 0; i < count; i++) {
+        (*results)[i].id = segments[i].id;
+        (*results)[i].status = STATUS_SUCCESS;
+        (*results)[i].result = g_strconcat("[", segments[i].text, "]", NULL);
+    }
+    return STATUS_SUCCESS;
+}
+
+static int run_segmented(const char* text, char** result) {
+    int status = STATUS_ERROR_DBUS;
+    *result = NULL;
+    batches_sent = segments_sent = 0;
+    CHECK(process_by_segments(text, "translate", fake_batch, &status, result));
+    CHECK(status == STATUS_SUCCESS);
+    return status;
+}
+
+// The first run caches every sentence, so a one-sentence edit sends one
+static void test_segmented_processing() {
+    init_result_cache(RESULT_CACHE_DEFAULT_BUDGET);
+    init_translation_memory(TM_DEFAULT_BUDGET);
+
+    char* result = NULL;
+    int status = 0;
+    CHECK(!process_by_segments("Just one sentence.", "translate", fake_batch, &status, &result));
+
+    run_segmented("The cat sat. The dog ran.\n\nBirds sang loudly!", &result);
+    CHECK(batches_sent == 1 && segments_sent == 3);
+    CHECK(result && strcmp(result, "[The cat sat.] [The dog ran.]\n\n[Birds sang loudly!]") == 0);
+    free(result);
+
+    run_segmented("The cat sat. The dog slept.\n\nBirds sang loudly!", &result);
+    CHECK(batches_sent == 1 && segments_sent == 1);
+    CHECK(result && strcmp(result, "[The cat sat.] [The dog slept.]\n\n[Birds sang loudly!]") == 0);
+    free(result);
+
+    // Nothing new: no round trip at all
+    run_segmented("Birds sang loudly! The cat sat.", &result);
+    CHECK(batches_sent == 0 && segments_sent == 0);
+    CHECK(result && strcmp(result, "[Birds sang loudly!] [The cat sat.]") == 0);
+    free(result);
+
+    cleanup_translation_memory();
+    cleanup_result_cache();
+}
+
+int main() {
+    // Keep the store away from the real cache
+    cache_root = g_strdup("/tmp/instant_translator_tests_XXXXXX");
+    if (!g_mkdtemp(cache_root)) {
+        printf("❌ Can't create a temporary cache directory\n");
+        return 1;
+    }
+    g_setenv("XDG_CACHE_HOME", cache_root, TRUE);
+    g_unsetenv("INSTANT_TRANSLATOR_PERSISTENT_CACHE");
+
+    test_store_basics();
+    test_store_compaction();
+    test_store_torn_records();
+    test_segmenter();
+    test_chunk_planner();
+    test_segmented_processing();
+
+    char* dir = g_build_filename(cache_root, "instant_translator", NULL);
+    const char* files[] = {"results.idx", "results.log", "results.lock", NULL};
+    for (int i = 0; files[i]; i++) {
+        char* path = g_build_filename(dir, files[i], NULL);
+        g_unlink(path);
+        g_free(path);
+    }
+    g_rmdir(dir);
+    g_rmdir(cache_root);
+    g_free(dir);
+    g_free(cache_root);
+
+    if (failures > 0) {
+        printf("❌ %d checks failed\n", failures);
+        return 1;
+    }
+    printf("✅ All core checks passed\n");
+    return 0;
+}